@@ -7,12 +7,17 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "clock.h"
 #include "ucglib/ucg.h"
 #include "ucglib_xmega.h"
 #include "serialF0/serialF0.h"
+#include "serialF0/shellF0.h"
+
+void serialF0_bench(void);	// serialF0/serialF0_bench.c, compiled with -DBENCH_NO_MAIN
+void console(void);
 
 // ----------------------------SET DISPLAY-------------------------------
 pin_t connectArraySPI[] = {
@@ -101,6 +106,7 @@ void standbyState(){
 // state for the central unit with display
 void centralState(){
 	while(true){
+		console();
 		// measure temp
 		// read screen input
 		// refresh screen
@@ -112,6 +118,7 @@ void centralState(){
 // state for the unit at the window
 void windowState(){
 	while(true){
+		console();
 		// measure outside
 		// measure inside
 		// if connected to the central unit: exchange data
@@ -145,6 +152,96 @@ void power(){
 }
 
 
+// -----CONSOLE-----
+// commands of the shell on the serial console, for debugging in the field
+
+const char *stateNames[] = {"off", "standby", "central", "window", "temprature"};
+
+// runs the benchmark of the serial interface
+int8_t cmdBench(uint8_t argc, char *argv[]){
+	serialF0_bench();
+	return 0;
+}
+
+// prints the number of connected devices
+int8_t cmdDevices(uint8_t argc, char *argv[]){
+	printf("%d devices\n", devices);
+	return 0;
+}
+
+// prints the size of the display, "display clear" clears it
+int8_t cmdDisplay(uint8_t argc, char *argv[]){
+	if(argc > 1 && strcmp(argv[1], "clear") == 0){
+		ucg_ClearScreen(&ucg);
+	}
+	printf("%d x %d\n", ucg_GetWidth(&ucg), ucg_GetHeight(&ucg));
+	return 0;
+}
+
+// prints the measured value
+int8_t cmdSensor(uint8_t argc, char *argv[]){
+	printf("%d\n", measure());
+	return 0;
+}
+
+// "set state <name>" or "set devices <number>"
+int8_t cmdSet(uint8_t argc, char *argv[]){
+	int i;
+
+	if(argc != 3){
+		return 1;
+	}
+	if(strcmp(argv[1], "state") == 0){
+		for(i = off; i <= temprature; i++){
+			if(strcmp(argv[2], stateNames[i]) == 0){
+				state = i;
+				return 0;
+			}
+		}
+		return 2;	// unknown state
+	}
+	if(strcmp(argv[1], "devices") == 0){
+		devices = atoi(argv[2]);
+		return 0;
+	}
+	return 1;
+}
+
+// prints the state
+int8_t cmdState(uint8_t argc, char *argv[]){
+	printf("%s\n", stateNames[state]);
+	return 0;
+}
+
+// prints the error counters of the serial console, "stats clear" clears them
+int8_t cmdStats(uint8_t argc, char *argv[]){
+	serial_errors_t errors;
+
+	uartF0_errors(&errors, argc > 1 && strcmp(argv[1], "clear") == 0);
+	printf("dropped %u, overrun %u, framing %u, parity %u, tx free %u\n",
+	       errors.dropped, errors.overrun, errors.framing, errors.parity, uartF0_tx_free());
+	return 0;
+}
+
+// the commands, sorted by name
+const shell_cmd_t commands[] PROGMEM = {
+	{ "bench",   cmdBench,   "benchmark of the serial interface" },
+	{ "devices", cmdDevices, "number of connected devices" },
+	{ "display", cmdDisplay, "size of the display [clear]" },
+	{ "sensor",  cmdSensor,  "measure a value" },
+	{ "set",     cmdSet,     "set state <name> | set devices <n>" },
+	{ "state",   cmdState,   "the current state" },
+	{ "stats",   cmdStats,   "errors of the serial console [clear]" },
+};
+
+shell_t  shell;
+
+// handles the console, call it often: it doesn't wait
+void console(void){
+	shellF0_poll(&shell, TCD1.CNT);
+}
+
+
 // ---------------------------MAIN--------------------------------
 int main(void){
 	//-----INIT-----
@@ -152,7 +249,14 @@ int main(void){
 	init_adc();
 	init_clock();
 	
+	TCC1.PER   = 499;				// overflow every ms: 32 MHz / 64 / 500
+	TCC1.CTRLA = TC_CLKSEL_DIV64_gc;
+	EVSYS.CH0MUX = EVSYS_CHMUX_TCC1_OVF_gc;
+	TCD1.PER   = 0xFFFF;			// tick of the console: counts the ms of TCC1
+	TCD1.CTRLA = TC_CLKSEL_EVCH0_gc;
+	
 	sei();
+	shellF0_init(&shell, commands, SHELL_COUNT(commands));
 	
 	// connect ucg to xmega
 	ucg_connectXmega(&SPID, connectArraySPI, 0);
@@ -160,6 +264,7 @@ int main(void){
 	
 	//-----MAIN PROGRAM-----
 	while(1){
+		console();
 		switch(state){
 			case standby:		standbyState();		break;
 			case central:		centralState();		break;
@@ -0,0 +1,155 @@
+/*!
+ *  \file    frame.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Framed binary messages with COBS and CRC-16
+ *
+ *  \details The encoder and the decoder of frames, see frame.h for the format.
+ *           The decoder gets the received bytes one by one and decodes COBS and
+ *           checks the CRC on the fly, the frame is not stored twice.
+ *           This file doesn't depend on the Xmega, it is also compiled on the PC.
+ */
+
+#include "frame.h"
+
+static void frame_store(frame_decoder_t *d, uint8_t c);
+
+/*! \brief  Updates a CRC-16/CCITT with a byte
+ *
+ *  \param  crc     the CRC of the previous bytes (0xFFFF for the first byte)
+ *  \param  data    the byte
+ *
+ *  \return the new CRC
+ */
+uint16_t frame_crc16(uint16_t crc, uint8_t data)
+{
+  uint8_t x;
+
+  // bytewise without a table: x is the upper byte xor the data
+  x = (crc >> 8) ^ data;
+  x ^= x >> 4;
+  return (crc << 8) ^ ((uint16_t) x << 12) ^ ((uint16_t) x << 5) ^ x;
+}
+
+/*! \brief  Encodes a message into a frame
+ *
+ *  \param  out     buffer for the frame, FRAME_MAX_SIZE bytes
+ *  \param  type    the type of the message
+ *  \param  data    the data of the message
+ *  \param  len     the length of the data (at most FRAME_MAX_DATA)
+ *
+ *  \return the size of the frame with the closing zero, 0 if len is too large
+ */
+uint16_t frame_encode(uint8_t *out, uint8_t type, const uint8_t *data, uint8_t len)
+{
+  uint16_t  crc = 0xFFFF;
+  uint16_t  code = 0;                  // position of the code byte of the block
+  uint16_t  n = 1;
+  uint16_t  i, total;
+  uint8_t   c;
+
+  if ( len > FRAME_MAX_DATA ) return 0;
+
+  total = FRAME_HEADER + len + FRAME_CRC;
+  for (i = 0; i < total; i++) {
+    if ( i == 0 )                       c = type;
+    else if ( i == 1 )                  c = len;
+    else if ( i < FRAME_HEADER + len )  c = data[i - FRAME_HEADER];
+    else if ( i == total - 2 )          c = crc >> 8;
+    else                                c = crc & 0xFF;
+    if ( i < FRAME_HEADER + len ) crc = frame_crc16(crc, c);
+
+    if ( c == 0 ) {
+      out[code] = n - code;
+      code = n++;
+    } else {
+      out[n++] = c;
+      if ( n - code == 0xFF ) {         // a full block without a zero
+        out[code] = 0xFF;
+        code = n++;
+      }
+    }
+  }
+  out[code] = n - code;
+  out[n++] = 0;
+
+  return n;
+}
+
+/*! \brief  Initializes the receiver of frames
+ *
+ *  \param  d       pointer to the state of the receiver
+ *
+ *  \return void
+ */
+void frame_decoder_init(frame_decoder_t *d)
+{
+  d->len      = 0;
+  d->code     = 0;
+  d->zero     = 0;
+  d->overflow = 0;
+  d->crc      = 0xFFFF;
+  d->errors   = 0;
+}
+
+/*  brief   Stores a decoded byte and updates the CRC
+ *
+ *  param   d       pointer to the state of the receiver
+ *  param   c       the decoded byte
+ *
+ *  return  void
+ */
+static void frame_store(frame_decoder_t *d, uint8_t c)
+{
+  if ( d->len < FRAME_MAX_RAW ) {
+    d->raw[d->len++] = c;
+    d->crc = frame_crc16(d->crc, c);
+  } else {
+    d->overflow = 1;
+  }
+}
+
+/*! \brief  Decodes a received byte
+ *
+ *  \param  d       pointer to the state of the receiver
+ *  \param  c       the received byte
+ *
+ *  \return FRAME_OK if a message is received, see frame_type(), frame_length()
+ *          and frame_data(), the message is valid until the next call,
+ *          FRAME_ERROR if a frame is wrong, else FRAME_NONE
+ */
+uint8_t frame_decode(frame_decoder_t *d, uint8_t c)
+{
+  uint8_t res;
+
+  if ( c != 0 ) {
+    if ( d->code == 0 ) {               // code byte of a block
+      if ( d->zero ) frame_store(d, 0); // the zero after the previous block
+      d->code = c - 1;
+      d->zero = ( c != 0xFF );
+    } else {
+      frame_store(d, c);
+      d->code--;
+    }
+    return FRAME_NONE;
+  }
+
+  // a zero ends the frame, the CRC over the frame with its CRC is 0
+  if ( d->len == 0 && d->code == 0 && !d->zero ) {
+    res = FRAME_NONE;                   // no frame (e.g. zeros to synchronize)
+  } else if ( !d->overflow && d->code == 0 && d->len >= FRAME_HEADER + FRAME_CRC &&
+              d->raw[1] == d->len - FRAME_HEADER - FRAME_CRC && d->crc == 0 ) {
+    res = FRAME_OK;
+  } else {
+    res = FRAME_ERROR;
+    d->errors++;
+  }
+
+  d->len      = 0;
+  d->code     = 0;
+  d->zero     = 0;
+  d->overflow = 0;
+  d->crc      = 0xFFFF;
+  return res;
+}
@@ -0,0 +1,68 @@
+/*!
+ *  \file    frame.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Framed binary messages with COBS and CRC-16
+ *
+ *  \details A message has a type, a length and up to FRAME_MAX_DATA bytes of
+ *           data. It is sent as a frame:
+ *  \verbatim
+    type (1) | length (1) | data (length) | CRC-16 (2, high byte first) \endverbatim
+ *           The CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) covers
+ *           the type, the length and the data. The frame is encoded with COBS
+ *           (Consistent Overhead Byte Stuffing), so it contains no zero bytes,
+ *           and ends with a zero byte. A receiver finds the start of the next
+ *           frame after a zero byte, whatever was lost before.
+ *
+ *           This file and frame.c are used on the board (frameF0.c) and on the
+ *           PC (tools/frame_host.c).
+ */
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include <stdint.h>
+
+#ifndef FRAME_MAX_DATA
+#define FRAME_MAX_DATA    250      //!<  maximum length of the data of a message (at most 250)
+#endif
+
+#define FRAME_HEADER      2        //!<  type and length
+#define FRAME_CRC         2        //!<  CRC-16
+#define FRAME_MAX_RAW     (FRAME_HEADER + FRAME_MAX_DATA + FRAME_CRC)   //!<  maximum size of a frame before COBS
+#define FRAME_MAX_SIZE    (FRAME_MAX_RAW + FRAME_MAX_RAW / 254 + 2)     //!<  maximum size of an encoded frame with the zero
+
+#if FRAME_MAX_DATA > 250
+#error "FRAME_MAX_DATA must be at most 250"
+#endif
+
+#define FRAME_NONE        0        //!<  frame_decode: the frame is not complete
+#define FRAME_OK          1        //!<  frame_decode: a message is received
+#define FRAME_ERROR       2        //!<  frame_decode: a frame with a wrong CRC, length or COBS code
+
+#define FRAME_LOG            0xFD  //!<  message type: a log record, see logF0.h
+#define FRAME_SERIAL_ERRORS  0xFE  //!<  message type: error counters of a serial port, see frameF0_send_errors()
+#define FRAME_SERIAL_ERRORS_LEN  9   //!<  port (0xC0, 0xE0, 0xF0, ...) and four 16 bit counters, high byte first
+
+//! State of the receiver of frames
+typedef struct {
+  uint8_t   raw[FRAME_MAX_RAW];    //!<  the decoded frame: type, length, data and CRC
+  uint8_t   len;                   //!<  number of decoded bytes
+  uint8_t   code;                  //!<  bytes left in the current COBS block
+  uint8_t   zero;                  //!<  1 if a zero follows the current COBS block
+  uint8_t   overflow;              //!<  1 if the frame is too long
+  uint16_t  crc;                   //!<  CRC-16 of the decoded bytes
+  uint16_t  errors;                //!<  number of frames with errors
+} frame_decoder_t;
+
+#define frame_type(d)     ((d)->raw[0])              //!<  type of the received message
+#define frame_length(d)   ((d)->raw[1])              //!<  length of the data of the received message
+#define frame_data(d)     ((d)->raw + FRAME_HEADER)  //!<  pointer to the data of the received message
+
+uint16_t  frame_crc16(uint16_t crc, uint8_t data);
+uint16_t  frame_encode(uint8_t *out, uint8_t type, const uint8_t *data, uint8_t len);
+void      frame_decoder_init(frame_decoder_t *d);
+uint8_t   frame_decode(frame_decoder_t *d, uint8_t c);
+
+#endif // FRAME_H_
@@ -0,0 +1,111 @@
+/*!
+ *  \file    frameF0.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Framed binary messages over UARTF0
+ *
+ *  \details The received bytes are decoded directly from the RX buffer of
+ *           serialF0 (uartF0_peek()), only the decoded message is stored in the
+ *           decoder. A frame is encoded into a buffer and written to the TX
+ *           buffer, or sent with DMA from the buffer if TXDMA_CH_F0 is defined.
+ *
+ *           A message with n bytes of data is sent as n + 6 bytes, e.g. a
+ *           measurement of four 16 bit values is 14 bytes. As text with printf
+ *           ("T=21.53 H=45.2 P=1013 L=512\r\n") it is 30 bytes and has to be
+ *           formatted and parsed.
+ */
+
+#include "serialF0.h"
+#include "frameF0.h"
+
+/*! \brief  Receives messages from UARTF0 without waiting
+ *
+ *  \param  d       pointer to the state of the receiver
+ *
+ *  \details The received bytes are decoded until a message is complete or no
+ *           more bytes are received. Frames with errors are counted in
+ *           d->errors and dropped.
+ *
+ *  \return FRAME_OK if a message is received, the message is valid until
+ *          the next call, else FRAME_NONE
+ */
+uint8_t frameF0_poll(frame_decoder_t *d)
+{
+  const uint8_t *p;
+  uint8_t  n, i;
+
+  while ( (n = uartF0_peek(&p)) > 0 ) {
+    for (i = 0; i < n; i++) {
+      if ( frame_decode(d, p[i]) == FRAME_OK ) {
+        uartF0_skip(i + 1);
+        return FRAME_OK;
+      }
+    }
+    uartF0_skip(n);
+  }
+
+  return FRAME_NONE;
+}
+
+/*! \brief  Sends a message to UARTF0
+ *
+ *  \param  type    the type of the message
+ *  \param  data    the data of the message
+ *  \param  len     the length of the data (at most FRAME_MAX_DATA)
+ *
+ *  \details The function waits until the frame is in the TX buffer.
+ *           With TXDMA_CH_F0 it waits until the previous frame is sent and
+ *           sends the frame with DMA.
+ *
+ *  \return void
+ */
+void frameF0_send(uint8_t type, const uint8_t *data, uint8_t len)
+{
+#ifdef TXDMA_CH_F0
+  static uint8_t  out[FRAME_MAX_SIZE];
+
+  while ( uartF0_tx_busy() ) ;         // the previous frame is sent from out
+  uartF0_send_dma(out, frame_encode(out, type, data, len));
+#else
+  uint8_t  out[FRAME_MAX_SIZE];
+  uint16_t n, i;
+
+  n = frame_encode(out, type, data, len);
+  for (i = 0; i < n; i += uartF0_write(out + i, (n - i > 255) ? 255 : n - i))
+    ;
+#endif
+}
+
+/*! \brief  Sends the error counters of a serial port
+ *
+ *  \param  port    the port, e.g. 0xC0 for USARTC0
+ *  \param  errors  the counters, see uartxn_errors()
+ *
+ *  \details The message has type FRAME_SERIAL_ERRORS and the data is the port
+ *           and the counters dropped, overrun, framing and parity, high byte
+ *           first, e.g.
+ *  \code
+    serial_errors_t e;
+
+    uartC0_errors(&e, 0);
+    frameF0_send_errors(0xC0, &e); \endcode
+ *
+ *  \return void
+ */
+void frameF0_send_errors(uint8_t port, const serial_errors_t *errors)
+{
+  uint8_t data[FRAME_SERIAL_ERRORS_LEN];
+
+  data[0] = port;
+  data[1] = errors->dropped >> 8;
+  data[2] = errors->dropped;
+  data[3] = errors->overrun >> 8;
+  data[4] = errors->overrun;
+  data[5] = errors->framing >> 8;
+  data[6] = errors->framing;
+  data[7] = errors->parity >> 8;
+  data[8] = errors->parity;
+
+  frameF0_send(FRAME_SERIAL_ERRORS, data, FRAME_SERIAL_ERRORS_LEN);
+}
@@ -0,0 +1,34 @@
+/*!
+ *  \file    frameF0.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Framed binary messages over UARTF0
+ *
+ *  \details The messages are sent and received as frames (frame.h) with the
+ *           buffers of serialF0. A receiver:
+ *  \code
+    static frame_decoder_t rx;
+
+    frame_decoder_init(&rx);
+    while (1) {
+      if ( frameF0_poll(&rx) == FRAME_OK ) {
+        switch ( frame_type(&rx) ) {
+          ...  frame_data(&rx), frame_length(&rx)
+        }
+      }
+      ...
+    } \endcode
+ */
+
+#ifndef FRAMEF0_H_
+#define FRAMEF0_H_
+
+#include "frame.h"
+#include "serial.h"
+
+uint8_t   frameF0_poll(frame_decoder_t *d);
+void      frameF0_send(uint8_t type, const uint8_t *data, uint8_t len);
+void      frameF0_send_errors(uint8_t port, const serial_errors_t *errors);
+
+#endif // FRAMEF0_H_
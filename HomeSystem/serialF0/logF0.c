@@ -0,0 +1,122 @@
+/*!
+ *  \file    logF0.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Deferred binary logging over UARTF0
+ *
+ *  \details See logF0.h. The log buffer has several writers (the main program
+ *           and ISRs), so a record is written with the interrupts disabled,
+ *           that is the length, the id and the arguments, at most 19 bytes.
+ *           There is one reader, logF0_drain() in the main program.
+ *
+ *           A record in the buffer:
+ *  \verbatim
+    length of the arguments (1) | id (2, low byte first) | arguments \endverbatim
+ *           The data of a FRAME_LOG message is the id and the arguments.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "serialF0.h"
+#include "frameF0.h"
+#include "logF0.h"
+
+static volatile uint8_t log_wridx, log_rdidx, log_buf[LOG_DEPTH];
+static volatile uint16_t log_lost;       // records dropped since the last report
+
+/*  \brief  Tests if a frame of a record can be sent without waiting
+ *
+ *  \param  len     the length of the data of the frame
+ *
+ *  \return non-zero if there is space
+ */
+static uint8_t CanSend(uint8_t len)
+{
+#ifdef TXDMA_CH_F0
+  (void) len;
+  return ! uartF0_tx_busy();                   // frameF0_send() sends from its own buffer
+#else
+  return uartF0_tx_free() >= FRAME_HEADER + len + FRAME_CRC + 2;   // COBS code and the zero
+#endif
+}
+
+/*! \brief  Writes a record to the log buffer, use LOG()
+ *
+ *  \param  id      the address of the format string in flash
+ *  \param  args    pointer to the arguments
+ *  \param  len     the size of the arguments (at most LOG_MAX_ARGS)
+ *
+ *  \details The record is dropped and counted if the buffer is full.
+ *           It can be called from ISRs.
+ *
+ *  \return void
+ */
+void log_write(uint16_t id, const void *args, uint8_t len)
+{
+  const uint8_t *p = args;
+  uint8_t tmpSREG = SREG;
+  uint8_t wridx, i;
+
+  cli();
+  wridx = log_wridx;
+  if ( len > LOG_MAX_ARGS || (uint8_t) (LOG_DEPTH - (uint8_t) (wridx - log_rdidx)) < len + 3 ) {
+    if ( log_lost != 0xFFFF ) log_lost++;
+  } else {
+    log_buf[wridx++ & (LOG_DEPTH - 1)] = len;
+    log_buf[wridx++ & (LOG_DEPTH - 1)] = id;
+    log_buf[wridx++ & (LOG_DEPTH - 1)] = id >> 8;
+    for (i = 0; i < len; i++) {
+      log_buf[wridx++ & (LOG_DEPTH - 1)] = p[i];
+    }
+    log_wridx = wridx;
+  }
+  SREG = tmpSREG;
+}
+
+/*! \brief  Sends the records in the log buffer to UARTF0
+ *
+ *  \details Every record is sent as a frame of type FRAME_LOG. It stops when
+ *           the log buffer is empty or the TX buffer has no space for the next
+ *           frame, so it doesn't wait. If records were dropped, a record with
+ *           id LOG_ID_DROPPED and the number is sent first.
+ *           Call it from the main loop.
+ *
+ *  \return the number of sent records
+ */
+uint8_t logF0_drain(void)
+{
+  uint8_t  data[2 + LOG_MAX_ARGS];
+  uint8_t  cnt = 0, rdidx, len, i;
+  uint8_t  tmpSREG;
+  uint16_t lost;
+
+  while ( log_lost && CanSend(4) ) {
+    tmpSREG = SREG;
+    cli();
+    lost = log_lost;
+    log_lost = 0;
+    SREG = tmpSREG;
+
+    data[0] = LOG_ID_DROPPED;
+    data[1] = LOG_ID_DROPPED >> 8;
+    data[2] = lost;
+    data[3] = lost >> 8;
+    frameF0_send(FRAME_LOG, data, 4);
+  }
+
+  while ( (rdidx = log_rdidx) != log_wridx ) {
+    len = log_buf[rdidx++ & (LOG_DEPTH - 1)] + 2;
+    if ( ! CanSend(len) ) break;
+
+    for (i = 0; i < len; i++) {
+      data[i] = log_buf[rdidx++ & (LOG_DEPTH - 1)];
+    }
+    log_rdidx = rdidx;                         // the record is copied before it is freed
+    frameF0_send(FRAME_LOG, data, len);
+    cnt++;
+  }
+
+  return cnt;
+}
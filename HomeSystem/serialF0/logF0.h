@@ -0,0 +1,89 @@
+/*!
+ *  \file    logF0.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Deferred binary logging over UARTF0
+ *
+ *  \details LOG() doesn't format the text on the board. The format string is
+ *           stored in flash and only its address and the values of the
+ *           arguments are copied to the log buffer, so LOG() can be used in
+ *           ISRs and control loops:
+ *  \code
+    LOG("T=%d.%02d C, fan %u", t / 100, t % 100, fan);
+    ...
+    while (1) {
+      logF0_drain();                   // in the main loop
+      ...
+    } \endcode
+ *           logF0_drain() sends the records as frames (frame.h) of type
+ *           FRAME_LOG when there is space in the TX buffer. The PC prints the
+ *           text with the format strings from the ELF file of the program:
+ *  \verbatim
+    tools/log_decode.py HomeSystem.elf /dev/ttyACM0 \endverbatim
+ *           A record has the address of the format string (16 bit) and the
+ *           values of the arguments as they are in the memory (low byte
+ *           first). An argument is promoted like an argument of printf, so
+ *           char and int are 2 bytes, long and float 4 bytes:
+ *  \verbatim
+    %d %i %u %x %X %o %c %p   2 bytes
+    %ld %lu %lx ...           4 bytes
+    %f %e %g                  4 bytes (float)
+    %s                        not possible, the pointer is sent \endverbatim
+ *           A LOG() has at most 4 arguments. If the log buffer is full the
+ *           record is dropped and counted, the PC prints the number of
+ *           dropped records. The format strings must be in the first 64 kB
+ *           of the flash, where the linker puts PROGMEM data.
+ */
+
+#ifndef LOGF0_H_
+#define LOGF0_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#ifndef LOG_DEPTH
+#define LOG_DEPTH         128      //!<  size of the log buffer (power of two, 32 ... 128)
+#endif
+
+#if (LOG_DEPTH & (LOG_DEPTH - 1)) || (LOG_DEPTH < 32) || (LOG_DEPTH > 128)
+#error "LOG_DEPTH must be a power of two from 32 to 128"
+#endif
+
+#define LOG_MAX_ARGS      16       //!<  maximum size of the arguments of a record (4 arguments of 4 bytes)
+#define LOG_ID_DROPPED    0        //!<  format id of the record with the number of dropped records
+
+//@cond
+#define LOG_CAT(a,b)                a##b
+#define LOG_XCAT(a,b)               LOG_CAT(a,b)
+#define LOG_NARGS(...)              LOG_NARGS_(__VA_ARGS__, 4, 3, 2, 1, 0, too_many_arguments)
+#define LOG_NARGS_(f, a, b, c, d, n, ...)  n
+
+#define LOG_T(x)                    __typeof__((x) + 0)      // the promoted type of an argument
+#define LOG_ID(fmt)                 ({ static const char _log_fmt[] PROGMEM = fmt; (uint16_t) _log_fmt; })
+#define LOG_ARGS(...)               struct __attribute__((packed)) { __VA_ARGS__ }
+
+#define LOG_0(fmt)                                                                    \
+  log_write(LOG_ID(fmt), 0, 0)
+#define LOG_1(fmt, a0)                                                                \
+  do { LOG_ARGS(LOG_T(a0) v0;) _log = { (a0) };                                        \
+       log_write(LOG_ID(fmt), &_log, sizeof(_log)); } while (0)
+#define LOG_2(fmt, a0, a1)                                                            \
+  do { LOG_ARGS(LOG_T(a0) v0; LOG_T(a1) v1;) _log = { (a0), (a1) };                    \
+       log_write(LOG_ID(fmt), &_log, sizeof(_log)); } while (0)
+#define LOG_3(fmt, a0, a1, a2)                                                        \
+  do { LOG_ARGS(LOG_T(a0) v0; LOG_T(a1) v1; LOG_T(a2) v2;) _log = { (a0), (a1), (a2) }; \
+       log_write(LOG_ID(fmt), &_log, sizeof(_log)); } while (0)
+#define LOG_4(fmt, a0, a1, a2, a3)                                                    \
+  do { LOG_ARGS(LOG_T(a0) v0; LOG_T(a1) v1; LOG_T(a2) v2; LOG_T(a3) v3;)               \
+       _log = { (a0), (a1), (a2), (a3) };                                             \
+       log_write(LOG_ID(fmt), &_log, sizeof(_log)); } while (0)
+//@endcond
+
+//! Logs a format string (a string literal) with at most 4 arguments
+#define LOG(...)          LOG_XCAT(LOG_, LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+void      log_write(uint16_t id, const void *args, uint8_t len);
+uint8_t   logF0_drain(void);
+
+#endif // LOGF0_H_
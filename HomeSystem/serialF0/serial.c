@@ -0,0 +1,39 @@
+/*!
+ *  \file    serial.c
+ *  \date    19-10-2026
+ *  \version 1.1
+ *
+ *  \brief   Common part of the serial interfaces for the HvA-Xmegaboard
+ *
+ *  \details The baud rate search, used by the drivers of all USARTs.
+ */
+
+#include "serial.h"
+
+/*! \brief   Searches the settings for a baud rate
+ *
+ *  \param   f_cpu    clock frequency (at most 32 MHz)
+ *  \param   baud     baud rate (at least 300), e.g. BAUD_921K6
+ *
+ *  \details All BSCALEs (-7 ... 7) are tried without and with clock doubling,
+ *           the settings with the smallest error are returned. With equal
+ *           errors no clock doubling is preferred, the receiver takes more
+ *           samples per bit. If the clock and the baud rate are constants use
+ *           serial_baud(), it calculates the settings at compile time.
+ *
+ *  \return  the settings with the smallest error
+ */
+serial_baud_t serial_baud_search(uint32_t f_cpu, uint32_t baud)
+{
+  serial_baud_t best = { 0, 0, INT16_MAX };
+  uint8_t  clk2x;
+  int8_t   scale;
+
+  for (clk2x = 0; clk2x < 2; clk2x++) {
+    for (scale = -7; scale < 8; scale++) {
+      best = serial_baud_try(best, f_cpu, baud, scale, clk2x);
+    }
+  }
+
+  return best;
+}
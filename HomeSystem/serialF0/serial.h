@@ -0,0 +1,184 @@
+/*!
+ *  \file    serial.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Common part of the serial interfaces for the HvA-Xmegaboard
+ *
+ *  \details Every USART has its own driver with its own buffers and ISRs
+ *           (serialF0.c, serialC0.c, serialE0.c, ...). The drivers are made
+ *           from one template (serial_template.c), so the ISRs use the buffers
+ *           and the USART directly, without a pointer to the port.
+ *           A driver for USARTxn has the functions uartxn_init(), uartxn_getc(),
+ *           uartxn_putc(), ... declared with SERIAL_DECLARE(xn).
+ *
+ *           A new port is made with a header that declares the functions and
+ *           a source file that sets the USART, the pins and the buffer sizes
+ *           and includes serial_template.c, see serialC0.h and serialC0.c.
+ *
+ *           The baud rate settings are searched over all BSCALE and CLK2X
+ *           combinations for the smallest error. serial_baud() does the search
+ *           at compile time if the clock and the baud rate are constants, so
+ *           SERIAL_INIT(C0, F_CPU, BAUD_921K6) doesn't need the search code.
+ */
+
+#ifndef SERIAL_H_
+#define SERIAL_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+
+#define UART_NO_DATA      0x0100   //!< Macro UART_NO_DATA is returned by uart_getc when no data is present
+
+#define BAUD_1M           1000000UL //!< Baud rate 1000000
+#define BAUD_921K6        921600UL //!< Baud rate 921600
+#define BAUD_460K8        460800UL //!< Baud rate 460800
+#define BAUD_230K4        230400UL //!< Baud rate 230400
+#define BAUD_115K2        115200UL //!< Baud rate 115200
+#define BAUD_57K6         57600UL  //!< Baud rate 57600
+#define BAUD_38K4         38400UL  //!< Baud rate 38400
+#define BAUD_9K6          9600UL   //!< Baud rate 9600
+
+//! Settings of a USART for a baud rate, see serial_baud()
+typedef struct {
+  uint16_t  baudctrl;              //!<  BAUDCTRLB (BSCALE, BSEL high) and BAUDCTRLA (BSEL low)
+  uint8_t   clk2x;                 //!<  1 for double speed (USART_CLK2X_bm)
+  int16_t   error;                 //!<  error of the baud rate in 0.01 %
+} serial_baud_t;
+
+//! Error counters of a serial port, see uartxn_errors()
+typedef struct {
+  uint16_t  dropped;               //!<  received bytes dropped because the RX buffer was full
+  uint16_t  overrun;               //!<  bytes lost in the USART, the ISR was too late (BUFOVF)
+  uint16_t  framing;               //!<  received bytes with a wrong stop bit (FERR), dropped
+  uint16_t  parity;                //!<  received bytes with a wrong parity (PERR), dropped
+} serial_errors_t;
+
+//! Declares the functions of the driver of USART id (e.g. C0)
+#define SERIAL_DECLARE(id)                                          \
+  int16_t   uart##id##_init(uint32_t f_cpu, uint32_t baud);         \
+  int16_t   uart##id##_setup(serial_baud_t baud);                   \
+  uint16_t  uart##id##_getc(void);                                  \
+  void      uart##id##_putc(uint8_t data);                          \
+  void      uart##id##_puts(char *s);                               \
+  uint8_t   uart##id##_read(uint8_t *buf, uint8_t n);               \
+  uint8_t   uart##id##_write(const uint8_t *buf, uint8_t n);        \
+  uint8_t   uart##id##_peek(const uint8_t **data);                  \
+  void      uart##id##_skip(uint8_t n);                             \
+  uint8_t   uart##id##_tx_busy(void);                               \
+  uint8_t   uart##id##_tx_free(void);                               \
+  void      uart##id##_errors(serial_errors_t *errors, uint8_t clear);
+
+//! Declares the DMA function of the driver of USART id, if it sends with DMA
+#define SERIAL_DECLARE_DMA(id)                                      \
+  void      uart##id##_send_dma(const uint8_t *buf, uint16_t n);
+
+//! Initializes USART id with the baud rate, searched at compile time if possible
+#define SERIAL_INIT(id, f_cpu, baud)   uart##id##_setup(serial_baud(f_cpu, baud))
+
+//! The settings for a baud rate, searched at compile time if f_cpu and baud are constants
+#define serial_baud(f_cpu, baud)                                          \
+  ( (__builtin_constant_p(f_cpu) && __builtin_constant_p(baud)) ?         \
+    serial_baud_const(f_cpu, baud) : serial_baud_search(f_cpu, baud) )
+
+serial_baud_t serial_baud_search(uint32_t f_cpu, uint32_t baud);
+
+/*! \brief  Tries a BSCALE and CLK2X for a baud rate
+ *
+ *  \param  best     the best settings so far
+ *  \param  f_cpu    clock frequency (at most 32 MHz)
+ *  \param  baud     baud rate (at least 300)
+ *  \param  scale    BSCALE (-7 ... 7)
+ *  \param  clk2x    1 for double speed
+ *
+ *  \details BSEL is rounded to the nearest value. The formula for the baud
+ *           rate is
+ *  \f{eqnarray*}{
+ *      \mbox{BSCALE}>=0\quad &:& \quad
+ *      f_{\mbox{baud}} = \frac{f_{\mbox{cpu}}}{N\ 2^{\mbox{BSCALE}}\ (\mbox{BSEL} + 1)} \\[3pt]
+ *      \mbox{BSCALE}<0\quad  &:& \quad
+ *      f_{\mbox{baud}} = \frac{f_{\mbox{cpu}}}{N\ (2^{\mbox{BSCALE}}\ \mbox{BSEL} + 1)}
+ *  \f}
+ *  N is 16 with no clock doubling and 8 with clock doubling.
+ *  All calculations are done with 32 bit integers. A baud rate above
+ *  f_cpu / 8 gets the highest baud rate and a large error.
+ *
+ *  \return the settings with this BSCALE and CLK2X if their error is smaller,
+ *          else best
+ */
+static inline __attribute__((always_inline))
+serial_baud_t serial_baud_try(serial_baud_t best, uint32_t f_cpu, uint32_t baud, int8_t scale, uint8_t clk2x)
+{
+  uint32_t n = (16 >> clk2x);
+  uint32_t div = n * baud;
+  uint32_t bsel, actual;
+  int32_t  error;
+
+  if ( scale >= 0 ) {
+    div <<= scale;
+    bsel = (f_cpu + div / 2) / div;                          // BSEL + 1
+    if ( bsel > 4096 ) return best;
+    if ( bsel < 1 ) bsel = 1;                                // the highest baud rate
+    div = (n << scale) * bsel;
+    actual = (f_cpu + div / 2) / div;
+    bsel--;
+  } else {
+    if ( f_cpu < div ) return best;
+    bsel = (((f_cpu - div) << -scale) + div / 2) / div;
+    if ( bsel > 4095 ) return best;
+    div = n * (bsel + (1 << -scale));
+    actual = ((f_cpu << -scale) + div / 2) / div;
+  }
+
+  error = (int32_t) (actual - baud) * 100 / (int32_t) (baud / 100);
+  if ( error >  INT16_MAX ) error = INT16_MAX;
+  if ( error < -INT16_MAX ) error = -INT16_MAX;
+
+  if ( (error < 0 ? -error : error) < (best.error < 0 ? -best.error : best.error) ) {
+    best.baudctrl = (((uint16_t) scale << 12) & 0xF000) | bsel;
+    best.clk2x    = clk2x;
+    best.error    = error;
+  }
+
+  return best;
+}
+
+//! Tries all BSCALEs (-7 ... 7) with clock doubling clk2x
+#define SERIAL_BAUD_TRY_ALL(best, f_cpu, baud, clk2x)                                 \
+  best = serial_baud_try(best, f_cpu, baud, -7, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud, -6, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud, -5, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud, -4, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud, -3, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud, -2, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud, -1, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  0, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  1, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  2, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  3, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  4, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  5, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  6, clk2x);                               \
+  best = serial_baud_try(best, f_cpu, baud,  7, clk2x);
+
+/*! \brief  Searches the settings for a baud rate with constants
+ *
+ *  \param  f_cpu    clock frequency, a constant
+ *  \param  baud     baud rate, a constant
+ *
+ *  \details The same search as serial_baud_search(), but unrolled and inlined,
+ *           so the compiler calculates the result. Use serial_baud().
+ *
+ *  \return the settings with the smallest error
+ */
+static inline __attribute__((always_inline)) serial_baud_t serial_baud_const(uint32_t f_cpu, uint32_t baud)
+{
+  serial_baud_t best = { 0, 0, INT16_MAX };
+
+  SERIAL_BAUD_TRY_ALL(best, f_cpu, baud, 0)
+  SERIAL_BAUD_TRY_ALL(best, f_cpu, baud, 1)
+
+  return best;
+}
+
+#endif // SERIAL_H_
@@ -0,0 +1,30 @@
+/*!
+ *  \file    serialC0.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Serial interface on USARTC0 (Bluetooth module) of the HvA-Xmegaboard
+ *
+ *  \details See serialC0.h and serial_template.c.
+ */
+
+#include "serialC0.h"
+
+#define SERIAL_ID        C0              //!< USARTC0
+#define SERIAL_PORT      PORTC           //!< port of the pins
+#define SERIAL_RXPIN     2               //!< RX on PC2
+#define SERIAL_TXPIN     3               //!< TX on PC3
+#define SERIAL_TXDEPTH   TXBUF_DEPTH_C0  //!< size of transmit buffer
+#define SERIAL_RXDEPTH   RXBUF_DEPTH_C0  //!< size of receive buffer
+#ifdef TXDMA_CH_C0
+#define SERIAL_TXDMA_CH  TXDMA_CH_C0     //!< DMA channel for sending
+#endif
+#ifdef RTS_PIN_C0
+#define SERIAL_RTS_PIN   RTS_PIN_C0      //!< RTS output
+#endif
+#ifdef CTS_PIN_C0
+#define SERIAL_CTS_PIN   CTS_PIN_C0      //!< CTS input
+#define SERIAL_CTS_vect  PORTC_INT1_vect //!< interrupt of the CTS pin
+#endif
+
+#include "serial_template.c"
@@ -0,0 +1,39 @@
+/*!
+ *  \file    serialC0.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Serial interface on USARTC0 (Bluetooth module) of the HvA-Xmegaboard
+ *
+ *  \details The driver is made from serial_template.c (see serial.h), with
+ *           RX on PC2 and TX on PC3. The baud rate is set by uartC0_init() or SERIAL_INIT(),
+ *           the sizes of the buffers by TXBUF_DEPTH_C0 and RXBUF_DEPTH_C0.
+ *           If TXDMA_CH_C0 is defined, the bytes are sent with this DMA channel.
+ *  \code
+    uartC0_init(F_CPU, BAUD_9K6);
+    sei();
+    uartC0_write(buf, n); \endcode
+ */
+
+#ifndef SERIALC0_H_
+#define SERIALC0_H_
+
+#include "serial.h"
+
+#ifndef TXBUF_DEPTH_C0
+#define TXBUF_DEPTH_C0    64       //!<  size of transmit buffer (power of two, 2 ... 128)
+#endif
+#ifndef RXBUF_DEPTH_C0
+#define RXBUF_DEPTH_C0    64       //!<  size of receive buffer (power of two, 2 ... 128)
+#endif
+
+// #define TXDMA_CH_C0    1        //!<  DMA channel (0 ... 3) for sending, undefined: an ISR per byte
+// #define RTS_PIN_C0     0        //!<  RTS on PC0 (output, high: stop sending), undefined: no RTS
+// #define CTS_PIN_C0     1        //!<  CTS on PC1 (input, high: stop sending), undefined: no CTS, not with DMA
+
+SERIAL_DECLARE(C0)
+#ifdef TXDMA_CH_C0
+SERIAL_DECLARE_DMA(C0)
+#endif
+
+#endif // SERIALC0_H_
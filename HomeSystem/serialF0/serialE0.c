@@ -0,0 +1,30 @@
+/*!
+ *  \file    serialE0.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Serial interface on USARTE0 (sensor bus) of the HvA-Xmegaboard
+ *
+ *  \details See serialE0.h and serial_template.c.
+ */
+
+#include "serialE0.h"
+
+#define SERIAL_ID        E0              //!< USARTE0
+#define SERIAL_PORT      PORTE           //!< port of the pins
+#define SERIAL_RXPIN     2               //!< RX on PE2
+#define SERIAL_TXPIN     3               //!< TX on PE3
+#define SERIAL_TXDEPTH   TXBUF_DEPTH_E0  //!< size of transmit buffer
+#define SERIAL_RXDEPTH   RXBUF_DEPTH_E0  //!< size of receive buffer
+#ifdef TXDMA_CH_E0
+#define SERIAL_TXDMA_CH  TXDMA_CH_E0     //!< DMA channel for sending
+#endif
+#ifdef RTS_PIN_E0
+#define SERIAL_RTS_PIN   RTS_PIN_E0      //!< RTS output
+#endif
+#ifdef CTS_PIN_E0
+#define SERIAL_CTS_PIN   CTS_PIN_E0      //!< CTS input
+#define SERIAL_CTS_vect  PORTE_INT1_vect //!< interrupt of the CTS pin
+#endif
+
+#include "serial_template.c"
@@ -0,0 +1,39 @@
+/*!
+ *  \file    serialE0.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Serial interface on USARTE0 (sensor bus) of the HvA-Xmegaboard
+ *
+ *  \details The driver is made from serial_template.c (see serial.h), with
+ *           RX on PE2 and TX on PE3. The baud rate is set by uartE0_init() or SERIAL_INIT(),
+ *           the sizes of the buffers by TXBUF_DEPTH_E0 and RXBUF_DEPTH_E0.
+ *           If TXDMA_CH_E0 is defined, the bytes are sent with this DMA channel.
+ *  \code
+    uartE0_init(F_CPU, BAUD_9K6);
+    sei();
+    uartE0_write(buf, n); \endcode
+ */
+
+#ifndef SERIALE0_H_
+#define SERIALE0_H_
+
+#include "serial.h"
+
+#ifndef TXBUF_DEPTH_E0
+#define TXBUF_DEPTH_E0    64       //!<  size of transmit buffer (power of two, 2 ... 128)
+#endif
+#ifndef RXBUF_DEPTH_E0
+#define RXBUF_DEPTH_E0    64       //!<  size of receive buffer (power of two, 2 ... 128)
+#endif
+
+// #define TXDMA_CH_E0    1        //!<  DMA channel (0 ... 3) for sending, undefined: an ISR per byte
+// #define RTS_PIN_E0     0        //!<  RTS on PE0 (output, high: stop sending), undefined: no RTS
+// #define CTS_PIN_E0     1        //!<  CTS on PE1 (input, high: stop sending), undefined: no CTS, not with DMA
+
+SERIAL_DECLARE(E0)
+#ifdef TXDMA_CH_E0
+SERIAL_DECLARE_DMA(E0)
+#endif
+
+#endif // SERIALE0_H_
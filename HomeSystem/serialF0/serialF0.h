@@ -1,39 +1,82 @@
 /*!
  *  \file    serialF0.h
  *  \author  Wim Dolman (<a href="mailto:w.e.dolman@hva.nl">w.e.dolman@hva.nl</a>)
- *  \date    16-04-2018
- *  \version 1.8
+ *  \date    19-10-2026
+ *  \version 2.0
  *
  *  \brief   Serial interface voor HvA-Xmegaboard
  *
  *  \details This serial interface doesn't use the drivers of Atmel
- *           The interface uses two \e non circulair buffers for sending and 
- *           receiving the data.
+ *           The interface uses two circular buffers for sending and
+ *           receiving the data. The sizes of the buffers are powers of two,
+ *           so the indices wrap with a mask.
+ *           If TXDMA_CH_F0 is defined, the bytes are sent with a DMA channel
+ *           instead of an interrupt for every byte.
  *           It is based om md_serial.c from J.D.Bakker.
  *
+ *           USARTF0 is the console: the standard streams and the line
+ *           functions use it. The driver is made from serial_template.c like
+ *           the drivers of the other USARTs (serial.h).
+ *
  *           It is a serial interface for the HvA-Xmegaboard (Version 2) with a
  *           Xmega256a3u and Xmega32a4u for programming and the serial interface.
  *           You can use the standard printf, putchar, puts, scanf, getchar, ...
  *           functions.
  *
- *           The baud rate is 115200
+ *           The baud rate is 115200, or set with init_stream_baud(), e.g.
+ *  \code
+    int16_t error = init_stream_baud(F_CPU, BAUD_921K6);   // -8: -0.08 % \endcode
  */
  
 #ifndef SERIALF0_H_
 #define SERIALF0_H_
 
 #include <stdio.h>
+#include "serial.h"
+
+#ifndef TXBUF_DEPTH_F0
+#define TXBUF_DEPTH_F0    128      //!<  size of transmit buffer (power of two, 2 ... 128)
+#endif
+#ifndef RXBUF_DEPTH_F0
+#define RXBUF_DEPTH_F0    128      //!<  size of receive buffer (power of two, 2 ... 128)
+#endif
+
+
+// #define TXDMA_CH_F0    0        //!<  DMA channel (0 ... 3) for sending, undefined: an ISR per byte
+// #define RTS_PIN_F0     0        //!<  RTS on PF0 (output, high: stop sending), undefined: no RTS
+// #define CTS_PIN_F0     1        //!<  CTS on PF1 (input, high: stop sending), undefined: no CTS, not with DMA
 
-#define TXBUF_DEPTH_F0    100      //!<  size of transmit buffer
-#define RXBUF_DEPTH_F0    100      //!<  size of receive buffer
+#define LINE_PARTIAL      0        //!<  uartF0_readline: the line is not complete
+#define LINE_READY        1        //!<  uartF0_readline: a line is received
+#define LINE_OVERFLOW     2        //!<  uartF0_readline: a line is received, but it was too long
+#define LINE_FLAG_ECHO    0x08     //!<  set in line_t.flags: uartF0_readline echoes the characters
+#ifndef LINE_CRLF_TICKS
+#define LINE_CRLF_TICKS   10       //!<  an LF within this number of ticks (ms) after a CR is a CRLF
+#endif
+
+//! State of a line that is received with uartF0_readline()
+typedef struct {
+  char     *buf;                   //!<  buffer for the line
+  uint16_t  size;                  //!<  size of the buffer
+  uint16_t  len;                   //!<  number of characters in the buffer
+  uint16_t  cr_tick;               //!<  tick (ms) of the last CR
+  uint8_t   flags;                 //!<  state of the line (LINE_FLAG_...)
+} line_t;
 
-#define UART_NO_DATA      0x0100                      //!< Macro UART_NO_DATA is returned by uart_getc when no data is present
 #define clear_screen()    printf("\e[H\e[2J\e[3J");   //!< Macro to reset and clear the terminal
 
 char     *getline(char* buf,  uint16_t len);
+void      line_init(line_t *line, char *buf, uint16_t size);
+uint8_t   uartF0_readline(line_t *line, uint16_t tick);
 void      init_stream(uint32_t f_cpu);
-uint16_t  uartF0_getc(void);
-void      uartF0_putc(uint8_t data);
-void      uartF0_puts(char *s);
+int16_t   init_stream_setup(serial_baud_t baud);
+
+//! Initializes the serial stream with a baud rate, returns the error in 0.01 %
+#define init_stream_baud(f_cpu, baud)    init_stream_setup(serial_baud(f_cpu, baud))
+
+SERIAL_DECLARE(F0)
+#ifdef TXDMA_CH_F0
+SERIAL_DECLARE_DMA(F0)
+#endif
 
 #endif // SERIALF0_H_ 
@@ -0,0 +1,239 @@
+/*!
+ *  \file    serialF0_bench.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Cycle benchmark for serialF0 (serialF0.c and serialF0.h)
+ *
+ *  \details This program measures the number of clock cycles of the functions
+ *           and the ISRs of serialF0 with timer TCC0 running at the system clock.
+ *           It runs on the HvA-Xmegaboard or in simavr (atxmega256a3u), e.g.
+ *  \verbatim
+    avr-gcc -mmcu=atxmega256a3u -Os -o bench.elf serialF0_bench.c serialF0.c serial.c frame.c frameF0.c logF0.c -lm
+    simavr -m atxmega256a3u -f 2000000 bench.elf \endverbatim
+ *           Compile all files with -DTXDMA_CH_F0=0 to measure sending with DMA.
+ *           No results are kept in the repository: the numbers are the output of
+ *           this program on the target.
+ *
+ *           The ISRs are called directly with the interrupts disabled, so the
+ *           cycles include the prologue and the epilogue of the ISR but not the
+ *           interrupt response time (5 cycles). The results are printed after
+ *           the measurements:
+ *  \verbatim
+    putc            cycles per byte with space in the TX buffer
+    getc            cycles per byte with data in the RX buffer
+    write(16)       cycles per block of 16 bytes
+    read(16)        cycles per block of 16 bytes
+    ISR RXC         cycles per received byte
+    ISR DRE         cycles per sent byte (without DMA)
+    LOG(2)          cycles of LOG() with two int arguments (logF0.h)
+    printf(2)       cycles of the same printf() to the TX buffer
+    load            CPU load while a full TX buffer is sent at the baud rate of
+                    the console, and the cycles of sending (32 bits) \endverbatim
+ *           A program can run the benchmark with serialF0_bench(), e.g. from
+ *           the shell (shellF0.h). Compile this file with -DBENCH_NO_MAIN then.
+ *           Timer TCC0 is used during the benchmark and restored afterwards.
+ */
+#ifndef F_CPU
+#define F_CPU     2000000UL              //!<  Clock frequency
+#endif
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+#include "serialF0.h"
+#include "logF0.h"
+
+#define BENCH_N   16                     //!< number of bytes per measurement
+
+void USARTF0_RXC_vect(void);             //!< the ISRs of serialF0.c, called directly
+void USARTF0_DRE_vect(void);             //!< the ISRs of serialF0.c, called directly
+
+static uint16_t overhead;                //!< cycles of an empty measurement
+
+/*! \brief  Starts a measurement
+ *
+ *  \return void
+ */
+static inline void bench_start(void)
+{
+  TCC0.CNT = 0;
+}
+
+/*! \brief  Ends a measurement
+ *
+ *  \return the number of cycles since bench_start()
+ */
+static inline uint16_t bench_stop(void)
+{
+  return TCC0.CNT - overhead;
+}
+
+/*! \brief  Counts an overflow of TCC0 for a measurement longer than 65536 cycles
+ *
+ *  \param  ovf    pointer to the number of overflows
+ *
+ *  \return void
+ */
+static inline void bench_overflow(uint16_t *ovf)
+{
+  if ( TCC0.INTFLAGS & TC0_OVFIF_bm ) {
+    TCC0.INTFLAGS = TC0_OVFIF_bm;
+    (*ovf)++;
+  }
+}
+
+/*! \brief  Waits until the TX buffer is sent
+ *
+ *  \return void
+ */
+static void drain_tx(void)
+{
+  sei();
+  while ( uartF0_tx_busy() ) ;
+  cli();
+}
+
+/*! \brief  Runs the benchmark and prints the results
+ *
+ *  \details The console must be initialized. The received bytes that are
+ *           not read yet may be lost.
+ *
+ *  \return void
+ */
+void serialF0_bench(void)
+{
+  uint8_t  buf[BENCH_N];
+  uint16_t c_putc, c_getc, c_write, c_read, c_rxc, c_dre, c_log, c_printf;
+  int16_t  t = 2153;
+  uint16_t c_iter, load, ovf, cnt;
+  uint32_t iter, c_total, c_idle;
+  uint8_t  i;
+  uint8_t  tmpSREG = SREG;
+  uint8_t  tmpCTRLA = TCC0.CTRLA;
+  uint16_t tmpPER = TCC0.PER;
+
+  drain_tx();
+  TCC0.PER   = 0xFFFF;
+  TCC0.CTRLA = TC_CLKSEL_DIV1_gc;
+
+  cli();
+  overhead = 0;
+  bench_start();
+  overhead = bench_stop();
+
+  // putc with space in the buffer
+  bench_start();
+  for (i = 0; i < BENCH_N; i++) uartF0_putc(i);
+  c_putc = bench_stop() / BENCH_N;
+
+  // ISR DRE with bytes in the buffer
+  c_dre = 0;
+#ifndef TXDMA_CH_F0
+  for (i = 0; i < BENCH_N; i++) {
+    bench_start();
+    USARTF0_DRE_vect();
+    c_dre += bench_stop();
+    cli();
+  }
+  c_dre /= BENCH_N;
+#endif
+  drain_tx();
+
+  // write a block
+  bench_start();
+  uartF0_write(buf, BENCH_N);
+  c_write = bench_stop();
+  drain_tx();
+
+  // ISR RXC, the byte is taken from the data register
+  c_rxc = 0;
+  for (i = 0; i < BENCH_N; i++) {
+    bench_start();
+    USARTF0_RXC_vect();
+    c_rxc += bench_stop();
+    cli();
+  }
+  c_rxc /= BENCH_N;
+
+  // getc with data in the buffer
+  bench_start();
+  for (i = 0; i < BENCH_N; i++) uartF0_getc();
+  c_getc = bench_stop() / BENCH_N;
+
+  // read a block
+  for (i = 0; i < BENCH_N; i++) {
+    USARTF0_RXC_vect();
+    cli();
+  }
+  bench_start();
+  uartF0_read(buf, BENCH_N);
+  c_read = bench_stop();
+
+  // deferred logging versus printf
+  bench_start();
+  LOG("T=%d fan %u", t, i);
+  c_log = bench_stop();
+  bench_start();
+  printf("T=%d fan %u\n", t, i);
+  c_printf = bench_stop();
+  drain_tx();
+
+  // CPU load: the iterations of an idle loop while a full TX buffer is sent,
+  // the loop counts the overflows of TCC0, sending takes more than 65536 cycles
+  for (i = 0; i < TXBUF_DEPTH_F0 / BENCH_N; i++) uartF0_write(buf, BENCH_N);
+  iter = 0;
+  ovf  = 0;
+  TCC0.INTFLAGS = TC0_OVFIF_bm;
+  bench_start();
+  for (i = 0; i < BENCH_N; i++) {
+    if ( uartF0_tx_busy() ) iter++;
+    bench_overflow(&ovf);
+  }
+  c_iter = bench_stop() / BENCH_N;             // cycles of one iteration
+  iter = 0;
+  ovf  = 0;
+  TCC0.INTFLAGS = TC0_OVFIF_bm;
+  sei();
+  bench_start();
+  while ( uartF0_tx_busy() ) {
+    iter++;
+    bench_overflow(&ovf);
+  }
+  cnt = TCC0.CNT;
+  cli();
+  if ( (TCC0.INTFLAGS & TC0_OVFIF_bm) && cnt < 0x8000 ) ovf++;   // overflow after the last check
+  c_total = ((uint32_t) ovf << 16) + cnt - overhead;
+  c_idle  = iter * c_iter;
+  load    = ( c_idle >= c_total ) ? 0 : 1000 - (uint16_t) ((uint64_t) 1000 * c_idle / c_total);
+
+  sei();
+  printf("putc       %5u\n", c_putc);
+  printf("getc       %5u\n", c_getc);
+  printf("write(%u)  %5u\n", BENCH_N, c_write);
+  printf("read(%u)   %5u\n", BENCH_N, c_read);
+  printf("ISR RXC    %5u\n", c_rxc);
+  printf("ISR DRE    %5u\n", c_dre);
+  printf("LOG(2)     %5u\n", c_log);
+  printf("printf(2)  %5u\n", c_printf);
+  printf("load       %3u.%u %% of %lu cycles\n", load / 10, load % 10, (unsigned long) c_total);
+
+  TCC0.CTRLA = tmpCTRLA;
+  TCC0.PER   = tmpPER;
+  SREG = tmpSREG;
+}
+
+#ifndef BENCH_NO_MAIN
+/*! \brief main routine of the benchmark
+ *
+ *  \return int
+ */
+int main(void)
+{
+  init_stream(F_CPU);
+  serialF0_bench();
+
+  while (1) ;
+}
+#endif
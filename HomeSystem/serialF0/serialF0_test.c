@@ -43,7 +43,7 @@ int main(void)
   sei();
 
   while(1){
-     c = uartF0_getc()
+     c = uartF0_getc();
     if (c == UART_NO_DATA ) {
       continue;
     }
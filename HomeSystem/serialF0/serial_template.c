@@ -0,0 +1,636 @@
+/*!
+ *  \file    serial_template.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Template of a serial interface for a USART of the HvA-Xmegaboard
+ *
+ *  \details This file is not compiled on its own, it is included by the source
+ *           file of a port (e.g. serialC0.c) after these macros are defined:
+ *  \verbatim
+    SERIAL_ID          the USART, e.g. C0 for USARTC0 and uartC0_...()
+    SERIAL_PORT        the port of the pins, e.g. PORTC
+    SERIAL_RXPIN       the RX pin, 2 for USARTx0 and 6 for USARTx1
+    SERIAL_TXPIN       the TX pin, 3 for USARTx0 and 7 for USARTx1
+    SERIAL_TXDEPTH     size of the transmit buffer (power of two, 2 ... 128)
+    SERIAL_RXDEPTH     size of the receive buffer (power of two, 2 ... 128)
+    SERIAL_TXDMA_CH    optional, the DMA channel (0 ... 3) for sending
+    SERIAL_RTS_PIN     optional, the RTS output on SERIAL_PORT (low: ready to receive)
+    SERIAL_CTS_PIN     optional, the CTS input on SERIAL_PORT (low: the other side is ready)
+    SERIAL_CTS_vect    with SERIAL_CTS_PIN, interrupt INT1 of SERIAL_PORT, e.g. PORTC_INT1_vect
+    SERIAL_RTS_STOP    optional, bytes in the RX buffer to set RTS high (default 3/4 of the buffer)
+    SERIAL_RTS_GO      optional, bytes in the RX buffer to set RTS low again (default 1/4) \endverbatim
+ *           Every port gets its own buffers, functions and ISRs, the ISRs use
+ *           the buffers and the USART directly. Two ports must not use the
+ *           same DMA channel.
+ *
+ *           The interface uses two circular buffers for sending and
+ *           receiving the data. The sizes of the buffers are powers of two,
+ *           so the indices wrap with a mask.
+ *           It is based om md_serial.c from J.D.Bakker.
+ *
+ *           Every buffer has one writer and one reader: the main program and
+ *           an ISR. The indices are free running 8 bit counters, the number of
+ *           bytes in a buffer is the difference of the indices. An index is
+ *           written by only one of them and a byte is written atomically, so
+ *           no interrupts have to be disabled.
+ *
+ *           If SERIAL_TXDMA_CH is defined, the TX buffer is sent with this DMA
+ *           channel, triggered by the DRE flag of the USART: the bytes from the
+ *           read index to the write index or to the end of the buffer are sent
+ *           in one transfer and the transfer complete interrupt starts the next
+ *           part. uartxn_send_dma() sends a buffer of the caller without a copy.
+ *           Without SERIAL_TXDMA_CH every byte is sent by the DRE interrupt.
+ *
+ *           The RX ISR counts the bytes that are lost: dropped with a full
+ *           buffer, overrun in the USART and received with a framing or parity
+ *           error, see uartxn_errors(). With SERIAL_RTS_PIN the other side is
+ *           stopped when the RX buffer is almost full, so a burst is throttled
+ *           instead of lost. With SERIAL_CTS_PIN the DRE ISR stops sending
+ *           while CTS is high and the interrupt of the CTS pin starts it again.
+ *           CTS is only checked per byte, so it can't be used with DMA.
+ */
+
+#if !defined(SERIAL_ID) || !defined(SERIAL_PORT) || !defined(SERIAL_RXPIN) || !defined(SERIAL_TXPIN) || \
+    !defined(SERIAL_TXDEPTH) || !defined(SERIAL_RXDEPTH)
+#error "serial_template.c is included by the source file of a port, see serialC0.c"
+#endif
+
+#if (SERIAL_TXDEPTH & (SERIAL_TXDEPTH - 1)) || (SERIAL_TXDEPTH < 2) || (SERIAL_TXDEPTH > 128)
+#error "The TX buffer of a serial port must be a power of two from 2 to 128"
+#endif
+#if (SERIAL_RXDEPTH & (SERIAL_RXDEPTH - 1)) || (SERIAL_RXDEPTH < 2) || (SERIAL_RXDEPTH > 128)
+#error "The RX buffer of a serial port must be a power of two from 2 to 128"
+#endif
+#if defined(SERIAL_TXDMA_CH) && ((SERIAL_TXDMA_CH < 0) || (SERIAL_TXDMA_CH > 3))
+#error "The DMA channel of a serial port must be from 0 to 3"
+#endif
+#if defined(SERIAL_CTS_PIN) && (defined(SERIAL_TXDMA_CH) || !defined(SERIAL_CTS_vect))
+#error "CTS of a serial port needs SERIAL_CTS_vect and can't be used with DMA"
+#endif
+
+#ifndef SERIAL_RTS_STOP
+#define SERIAL_RTS_STOP        (SERIAL_RXDEPTH - SERIAL_RXDEPTH / 4)   //!< RTS high at this number of bytes
+#endif
+#ifndef SERIAL_RTS_GO
+#define SERIAL_RTS_GO          (SERIAL_RXDEPTH / 4)                    //!< RTS low again at this number of bytes
+#endif
+
+#include "serial.h"
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define SERIAL_CAT2(a,b)       a##b
+#define SERIAL_CAT3(a,b,c)     a##b##c
+#define SERIAL_XCAT2(a,b)      SERIAL_CAT2(a,b)
+#define SERIAL_XCAT3(a,b,c)    SERIAL_CAT3(a,b,c)
+
+#define SERIAL_FN(f)           SERIAL_XCAT3(uart, SERIAL_ID, _##f)                 //!< uartxn_f
+#define SERIAL_USART           SERIAL_XCAT2(USART, SERIAL_ID)                     //!< USARTxn
+#define SERIAL_RXC_vect        SERIAL_XCAT3(USART, SERIAL_ID, _RXC_vect)          //!< USARTxn_RXC_vect
+#define SERIAL_DRE_vect        SERIAL_XCAT3(USART, SERIAL_ID, _DRE_vect)          //!< USARTxn_DRE_vect
+#define SERIAL_DRE_TRIG        SERIAL_XCAT3(DMA_CH_TRIGSRC_USART, SERIAL_ID, _DRE_gc)
+#define SERIAL_RX_CTRL         SERIAL_XCAT3(PIN, SERIAL_RXPIN, CTRL)              //!< PINnCTRL of RX
+#define SERIAL_RX_bm           SERIAL_XCAT3(PIN, SERIAL_RXPIN, _bm)
+#define SERIAL_TX_bm           SERIAL_XCAT3(PIN, SERIAL_TXPIN, _bm)
+#define SERIAL_RTS_bm          SERIAL_XCAT3(PIN, SERIAL_RTS_PIN, _bm)
+#define SERIAL_CTS_bm          SERIAL_XCAT3(PIN, SERIAL_CTS_PIN, _bm)
+#define SERIAL_CTS_CTRL        SERIAL_XCAT3(PIN, SERIAL_CTS_PIN, CTRL)             //!< PINnCTRL of CTS
+
+static volatile uint8_t tx_wridx, tx_rdidx, tx_buf[SERIAL_TXDEPTH];
+static volatile uint8_t rx_wridx, rx_rdidx, rx_buf[SERIAL_RXDEPTH];
+static volatile serial_errors_t rx_errors;
+
+#ifdef SERIAL_TXDMA_CH
+#if SERIAL_TXDMA_CH == 0
+#define TXDMA            DMA.CH0          //!< DMA channel for sending
+#define TXDMA_vect       DMA_CH0_vect     //!< interrupt of the DMA channel
+#elif SERIAL_TXDMA_CH == 1
+#define TXDMA            DMA.CH1
+#define TXDMA_vect       DMA_CH1_vect
+#elif SERIAL_TXDMA_CH == 2
+#define TXDMA            DMA.CH2
+#define TXDMA_vect       DMA_CH2_vect
+#else
+#define TXDMA            DMA.CH3
+#define TXDMA_vect       DMA_CH3_vect
+#endif
+
+static volatile uint8_t tx_dmacnt;       // bytes of the TX buffer in the running transfer, 0 if none
+static volatile uint8_t tx_dmaext;       // 1 if a buffer of the caller is sent
+
+static void    StartDMA(const volatile uint8_t *src, uint16_t n);
+static void    NextDMA(void);
+#endif
+
+static uint8_t CanRead(void);
+static uint8_t ReadByte(void);
+static uint8_t CanWrite(void);
+static void    WriteByte(uint8_t data);
+static void    StartTX(void);
+#ifdef SERIAL_RTS_PIN
+static void    ReleaseRTS(void);
+#else
+#define ReleaseRTS()
+#endif
+
+/*! \brief  Send a byte to the USART
+ *
+ *  \param  data      byte to send
+ *
+ *  \return void
+ */
+inline void SERIAL_FN(putc)(uint8_t data)
+{
+  WriteByte(data);
+}
+
+/*! \brief  Read a byte from the USART
+ *
+ *  \return Received byte from buffer or
+ *          UART_NO_DATA if buffer is empty
+ */
+inline uint16_t SERIAL_FN(getc)(void)
+{
+  uint8_t data;
+
+  if ( ! CanRead() ) {
+    return UART_NO_DATA;
+  }
+
+  data = ReadByte();
+
+  return (data & 0x00FF);
+}
+
+/*! \brief  Send a string to the USART
+ *
+ *  \param  s      a pointer to the pointer
+ *
+ *  \return void
+ */
+void SERIAL_FN(puts)(char *s)
+{
+  char c;
+
+  while ( (c = *s++) ) {
+     WriteByte(c);
+  }
+}
+
+/*! \brief  Read the received bytes from the USART
+ *
+ *  \param  buf    pointer to a buffer for the bytes
+ *  \param  n      size of the buffer
+ *
+ *  \return the number of bytes read, 0 if no data is received,
+ *          it doesn't wait for data
+ */
+uint8_t SERIAL_FN(read)(uint8_t *buf, uint8_t n)
+{
+  uint8_t rdidx = rx_rdidx;
+  uint8_t cnt   = CanRead();
+  uint8_t i;
+
+  if ( n > cnt ) n = cnt;
+  for (i = 0; i < n; i++) {
+    buf[i] = rx_buf[rdidx++ & (SERIAL_RXDEPTH - 1)];
+  }
+  rx_rdidx = rdidx;
+  ReleaseRTS();
+
+  return n;
+}
+
+/*! \brief  Get the received bytes of the USART without a copy
+ *
+ *  \param  data   pointer to a pointer, it is set to the first received byte
+ *                 in the RX buffer
+ *
+ *  \details The bytes stay in the RX buffer until uartxn_skip() is called.
+ *           If the bytes wrap around the end of the buffer, only the bytes
+ *           up to the end are returned, the next call returns the rest.
+ *
+ *  \return the number of bytes at *data
+ */
+uint8_t SERIAL_FN(peek)(const uint8_t **data)
+{
+  uint8_t slot = rx_rdidx & (SERIAL_RXDEPTH - 1);
+  uint8_t cnt  = CanRead();
+
+  if ( cnt > SERIAL_RXDEPTH - slot ) cnt = SERIAL_RXDEPTH - slot;
+  *data = (const uint8_t *) rx_buf + slot;
+
+  return cnt;
+}
+
+/*! \brief  Remove received bytes from the RX buffer of the USART
+ *
+ *  \param  n      number of bytes, at most the number returned by uartxn_peek()
+ *
+ *  \return void
+ */
+void SERIAL_FN(skip)(uint8_t n)
+{
+  rx_rdidx += n;
+  ReleaseRTS();
+}
+
+/*! \brief  Send bytes to the USART
+ *
+ *  \param  buf    pointer to the bytes
+ *  \param  n      number of bytes
+ *
+ *  \return the number of bytes written to the TX buffer,
+ *          less than n if the buffer is full, it doesn't wait for space
+ */
+uint8_t SERIAL_FN(write)(const uint8_t *buf, uint8_t n)
+{
+  uint8_t wridx = tx_wridx;
+  uint8_t cnt   = CanWrite();
+  uint8_t i;
+
+  if ( n > cnt ) n = cnt;
+  if ( n == 0 ) return 0;
+
+  for (i = 0; i < n; i++) {
+    tx_buf[wridx++ & (SERIAL_TXDEPTH - 1)] = buf[i];
+  }
+  tx_wridx = wridx;
+  StartTX();
+
+  return n;
+}
+
+/*! \brief  Test if the USART is still sending bytes from its buffers
+ *
+ *  \return non-zero if the TX buffer is not empty or a transfer is running
+ */
+uint8_t SERIAL_FN(tx_busy)(void)
+{
+#ifdef SERIAL_TXDMA_CH
+  if ( tx_dmacnt || tx_dmaext ) return 1;
+#endif
+  return tx_wridx != tx_rdidx;
+}
+
+/*! \brief  Get the free space in the TX buffer of the USART
+ *
+ *  \return the number of bytes that can be written without waiting
+ */
+uint8_t SERIAL_FN(tx_free)(void)
+{
+  return CanWrite();
+}
+
+/*! \brief  Get the error counters of the USART
+ *
+ *  \param  errors pointer to a struct for the counters
+ *  \param  clear  non-zero to set the counters to zero
+ *
+ *  \details The counters are copied with the interrupts disabled. They wrap
+ *           around at 65536, a caller that doesn't clear them can use the
+ *           difference with the previous call.
+ *
+ *  \return void
+ */
+void SERIAL_FN(errors)(serial_errors_t *errors, uint8_t clear)
+{
+  uint8_t tmpSREG = SREG;
+
+  cli();
+  *errors = *(serial_errors_t *) &rx_errors;
+  if ( clear ) {
+    rx_errors.dropped = 0;
+    rx_errors.overrun = 0;
+    rx_errors.framing = 0;
+    rx_errors.parity  = 0;
+  }
+  SREG = tmpSREG;
+}
+
+#ifdef SERIAL_TXDMA_CH
+/*! \brief  Send a buffer to the USART with DMA without a copy
+ *
+ *  \param  buf    pointer to the bytes, it must not be changed until
+ *                 uartxn_tx_busy() returns zero
+ *  \param  n      number of bytes (1 ... 65535)
+ *
+ *  \details The function waits until the bytes in the TX buffer are sent,
+ *           bytes written during the transfer are sent after the buffer.
+ *
+ *  \return void
+ */
+void SERIAL_FN(send_dma)(const uint8_t *buf, uint16_t n)
+{
+  if ( n == 0 ) return;
+
+  while ( SERIAL_FN(tx_busy)() ) ;
+
+  tx_dmaext = 1;
+  StartDMA(buf, n);
+}
+#endif
+
+/*! \brief   Initializes the USART with settings for the baud rate
+ *
+ *  \param   baud     the settings, see serial_baud() and SERIAL_INIT()
+ *
+ *  \details The USART is set to 8N1. The RX interrupt has level medium, the
+ *           TX interrupts (and CTS) level low, both levels are enabled in the
+ *           PMIC.
+ *
+ *  \return  the error of the baud rate in 0.01 %
+ */
+int16_t SERIAL_FN(setup)(serial_baud_t baud)
+{
+	SERIAL_PORT.SERIAL_RX_CTRL = PORT_OPC_PULLUP_gc;  // pullup on rx
+	SERIAL_PORT.OUTSET = SERIAL_TX_bm;                // tx high
+	SERIAL_PORT.DIRSET = SERIAL_TX_bm;
+	SERIAL_PORT.DIRCLR = SERIAL_RX_bm;
+#ifdef SERIAL_RTS_PIN
+	SERIAL_PORT.OUTCLR = SERIAL_RTS_bm;               // ready to receive
+	SERIAL_PORT.DIRSET = SERIAL_RTS_bm;
+#endif
+#ifdef SERIAL_CTS_PIN
+	SERIAL_PORT.DIRCLR = SERIAL_CTS_bm;
+	SERIAL_PORT.SERIAL_CTS_CTRL = PORT_ISC_FALLING_gc; // interrupt when the other side is ready
+	SERIAL_PORT.INT1MASK |= SERIAL_CTS_bm;
+	SERIAL_PORT.INTCTRL = (SERIAL_PORT.INTCTRL & ~PORT_INT1LVL_gm) | PORT_INT1LVL_LO_gc;
+#endif
+
+	SERIAL_USART.BAUDCTRLA = baud.baudctrl & 0xFF;
+	SERIAL_USART.BAUDCTRLB = baud.baudctrl >> 8;
+
+ 	SERIAL_USART.CTRLB = USART_RXEN_bm | USART_TXEN_bm | (baud.clk2x ? USART_CLK2X_bm : 0);
+
+	SERIAL_USART.CTRLA = USART_RXCINTLVL_MED_gc |
+                       USART_TXCINTLVL_OFF_gc | USART_DREINTLVL_OFF_gc;
+
+	PMIC.CTRL |= PMIC_MEDLVLEN_bm | PMIC_LOLVLEN_bm;
+
+	return baud.error;
+}
+
+/*! \brief   Initializes the USART
+ *
+ *  \param   f_cpu    clock frequency
+ *  \param   baud     baud rate, e.g. BAUD_115K2
+ *
+ *  \details The settings for the baud rate are searched when it is called,
+ *           SERIAL_INIT() searches them at compile time.
+ *
+ *  \return  the error of the baud rate in 0.01 %
+ */
+int16_t SERIAL_FN(init)(uint32_t f_cpu, uint32_t baud)
+{
+	return SERIAL_FN(setup)(serial_baud_search(f_cpu, baud));
+}
+
+
+//@cond
+// from here borrowed from J.D.Bakker md_serial.c
+
+
+/*  \brief  Static function that tests if there is data in the RX buffer
+ *
+ *  \return the number of bytes in the buffer
+ */
+static uint8_t CanRead(void) {
+	return (uint8_t) (rx_wridx - rx_rdidx);
+} // CanRead
+
+
+/*  \brief  Static function that reads a byte
+ *          This function waits until there is a byte in the buffer.
+ *
+ *  \return The received byte
+ */
+static uint8_t ReadByte(void) {
+	uint8_t res, curSlot;
+
+	// Busy-wait for a byte to be available. Should not be necessary if the caller calls CanRead_xxx() first
+	while(!CanRead()) ;
+
+	curSlot = rx_rdidx;
+	res = rx_buf[curSlot & (SERIAL_RXDEPTH - 1)];
+	rx_rdidx = curSlot + 1;                      // the byte is read before the slot is freed
+	ReleaseRTS();
+
+	return res;
+} // ReadByte
+
+
+/*  \brief  Static function that tests if there is space in the TX buffer
+ *
+ *  \return the number of free bytes in the buffer
+ */
+static uint8_t CanWrite(void) {
+	return SERIAL_TXDEPTH - (uint8_t) (tx_wridx - tx_rdidx);
+} // CanWrite
+
+
+/*  \brief  Static function writes a byte to the TX buffer
+ *          This function waits until there is space in the buffer.
+ *
+ *          Sending is started after the index is updated. If the DRE ISR runs
+ *          in between and disables the interrupt, it is enabled again here; an
+ *          ISR with an empty buffer only disables it again.
+ *
+ *  \param  data    byte to be written
+ *
+ *  \return void
+ */
+static void WriteByte(uint8_t data) {
+	uint8_t curSlot;
+
+	// Busy-wait for a byte to be available. Should not be necessary if the caller calls CanWrite_xxx() first
+	while(!CanWrite())
+		StartTX();
+
+	curSlot = tx_wridx;
+	tx_buf[curSlot & (SERIAL_TXDEPTH - 1)] = data;
+	tx_wridx = curSlot + 1;                      // the byte is written before it is visible
+	StartTX();
+
+} // WriteByte
+
+#ifdef SERIAL_RTS_PIN
+/*  \brief  Static function that sets RTS low if the RX buffer has space again
+ *          The RX ISR sets RTS high when the buffer is almost full.
+ *          If the ISR sets it between the test and the write, the next
+ *          received byte sets it again; the buffer still has space for it.
+ *
+ *  \return void
+ */
+static void ReleaseRTS(void) {
+	if(CanRead() <= SERIAL_RTS_GO)
+		SERIAL_PORT.OUTCLR = SERIAL_RTS_bm;
+} // ReleaseRTS
+#endif
+
+#ifdef SERIAL_TXDMA_CH
+
+/*  \brief  Static function that starts a DMA transfer to the USART
+ *
+ *  \param  src     pointer to the first byte
+ *  \param  n       number of bytes
+ *
+ *  \return void
+ */
+static void StartDMA(const volatile uint8_t *src, uint16_t n) {
+	uint16_t addr = (uint16_t) src;
+
+	DMA.CTRL |= DMA_ENABLE_bm;
+	TXDMA.ADDRCTRL  = DMA_CH_SRCRELOAD_NONE_gc | DMA_CH_SRCDIR_INC_gc |
+	                  DMA_CH_DESTRELOAD_NONE_gc | DMA_CH_DESTDIR_FIXED_gc;
+	TXDMA.TRIGSRC   = SERIAL_DRE_TRIG;
+	TXDMA.TRFCNT    = n;
+	TXDMA.SRCADDR0  = addr & 0xFF;
+	TXDMA.SRCADDR1  = addr >> 8;
+	TXDMA.SRCADDR2  = 0;
+	TXDMA.DESTADDR0 = ((uint16_t) &SERIAL_USART.DATA) & 0xFF;
+	TXDMA.DESTADDR1 = ((uint16_t) &SERIAL_USART.DATA) >> 8;
+	TXDMA.DESTADDR2 = 0;
+	TXDMA.CTRLB     = DMA_CH_TRNIF_bm | DMA_CH_ERRIF_bm | DMA_CH_TRNINTLVL_LO_gc;
+	TXDMA.CTRLA     = DMA_CH_ENABLE_bm | DMA_CH_SINGLE_bm | DMA_CH_BURSTLEN_1BYTE_gc;
+
+} // StartDMA
+
+
+/*  \brief  Static function that sends the next part of the TX buffer with DMA
+ *          The part ends at the write index or at the end of the buffer.
+ *          It is called with no transfer running.
+ *
+ *  \return void
+ */
+static void NextDMA(void) {
+	uint8_t rdidx = tx_rdidx;
+	uint8_t slot  = rdidx & (SERIAL_TXDEPTH - 1);
+	uint8_t cnt   = tx_wridx - rdidx;
+
+	if(cnt > SERIAL_TXDEPTH - slot)
+		cnt = SERIAL_TXDEPTH - slot;
+	tx_dmacnt = cnt;
+	if(cnt)
+		StartDMA(tx_buf + slot, cnt);
+
+} // NextDMA
+
+
+/*  \brief  Static function that starts sending the TX buffer
+ *          A transfer is only started if none is running. The transfer
+ *          complete ISR only runs while a transfer is running, so it can't
+ *          run between the test and the start.
+ *
+ *  \return void
+ */
+static void StartTX(void) {
+	if(!tx_dmacnt && !tx_dmaext)
+		NextDMA();
+} // StartTX
+
+
+/*  \brief  ISR of the DMA channel, a transfer is complete.
+ *          The bytes of the transfer are freed and the next part is sent
+ */
+ISR(TXDMA_vect) {
+
+	TXDMA.CTRLB = DMA_CH_TRNIF_bm | DMA_CH_ERRIF_bm | DMA_CH_TRNINTLVL_LO_gc;
+
+	if(tx_dmaext)
+		tx_dmaext = 0;
+	else
+		tx_rdidx += tx_dmacnt;
+	NextDMA();
+
+} // ISR(TXDMA_vect)
+
+#else
+
+/*  \brief  Static function that starts sending the TX buffer
+ *          The DRE interrupt is enabled, the ISR disables it if the buffer
+ *          is empty.
+ *
+ *  \return void
+ */
+static void StartTX(void) {
+	SERIAL_USART.CTRLA = USART_RXCINTLVL_MED_gc | USART_TXCINTLVL_OFF_gc | USART_DREINTLVL_LO_gc;
+} // StartTX
+
+#endif // SERIAL_TXDMA_CH
+
+/*  \brief  ISR for receiving bytes from the USART.
+ *          It puts the received byte in the RX buffer, the byte is dropped
+ *          if the buffer is full or it has a framing or parity error.
+ *          The error flags belong to the byte in DATA, so STATUS is read
+ *          first. Every lost byte is counted.
+ */
+ISR(SERIAL_RXC_vect) {
+
+	uint8_t curSlot = rx_wridx;
+	uint8_t status  = SERIAL_USART.STATUS;
+	uint8_t data    = SERIAL_USART.DATA;
+
+	if(status & USART_BUFOVF_bm)
+		rx_errors.overrun++;
+
+	if(status & (USART_FERR_bm | USART_PERR_bm)) {
+		if(status & USART_FERR_bm)
+			rx_errors.framing++;
+		else
+			rx_errors.parity++;
+	} else if((uint8_t) (curSlot - rx_rdidx) != SERIAL_RXDEPTH) {
+		rx_buf[curSlot & (SERIAL_RXDEPTH - 1)] = data;
+		rx_wridx = ++curSlot;
+#ifdef SERIAL_RTS_PIN
+		if((uint8_t) (curSlot - rx_rdidx) >= SERIAL_RTS_STOP)
+			SERIAL_PORT.OUTSET = SERIAL_RTS_bm;     // stop the other side
+#endif
+	} else {
+		rx_errors.dropped++;
+	}
+
+} // ISR(SERIAL_RXC_vect)
+
+
+#ifndef SERIAL_TXDMA_CH
+/*  \brief  ISR for transmitting bytes to the USART.
+ *          If there is a byte to send in the TX buffer, it will be send
+ */
+ISR(SERIAL_DRE_vect) {
+
+	uint8_t curSlot = tx_rdidx;
+
+#ifdef SERIAL_CTS_PIN
+	if(SERIAL_PORT.IN & SERIAL_CTS_bm) {         // the other side is not ready, CTS ISR restarts
+		SERIAL_USART.CTRLA = USART_RXCINTLVL_MED_gc | USART_TXCINTLVL_OFF_gc | USART_DREINTLVL_OFF_gc;
+		return;
+	}
+#endif
+
+	if(curSlot != tx_wridx) {
+		SERIAL_USART.DATA = tx_buf[curSlot & (SERIAL_TXDEPTH - 1)];
+		tx_rdidx = ++curSlot;
+	}
+	if(curSlot == tx_wridx)
+		SERIAL_USART.CTRLA = USART_RXCINTLVL_MED_gc | USART_TXCINTLVL_OFF_gc | USART_DREINTLVL_OFF_gc;
+
+} // ISR(SERIAL_DRE_vect)
+#endif // SERIAL_TXDMA_CH
+
+#ifdef SERIAL_CTS_PIN
+/*  \brief  ISR of the CTS pin, the other side is ready again.
+ *          Sending is started if there are bytes in the TX buffer,
+ *          it has the same level as the DRE ISR.
+ */
+ISR(SERIAL_CTS_vect) {
+
+	if(tx_wridx != tx_rdidx)
+		StartTX();
+
+} // ISR(SERIAL_CTS_vect)
+#endif // SERIAL_CTS_PIN
+//@endcond
@@ -0,0 +1,179 @@
+/*!
+ *  \file    shellF0.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Command shell on the console (UARTF0)
+ *
+ *  \details See shellF0.h. A command runs in the main loop when its line is
+ *           complete. It should be short, its text is printed with printf,
+ *           which waits when the TX buffer is full.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "shellF0.h"
+
+/*  \brief  Splits a line in words, without copying
+ *
+ *  \param  line    the line, the spaces after the words are replaced by '\\0'
+ *  \param  argv    array for the pointers to the words
+ *
+ *  \return the number of words, or SHELL_MAX_ARGS + 1 if there are more
+ */
+static uint8_t Split(char *line, char *argv[])
+{
+  uint8_t argc = 0;
+
+  while (1) {
+    while ( *line == ' ' || *line == '\t' ) line++;
+    if ( *line == '\0' ) break;
+    if ( argc == SHELL_MAX_ARGS ) return SHELL_MAX_ARGS + 1;
+    argv[argc++] = line;
+    while ( *line != ' ' && *line != '\t' && *line != '\0' ) line++;
+    if ( *line == '\0' ) break;
+    *line++ = '\0';
+  }
+
+  return argc;
+}
+
+/*  \brief  Searches a command in the sorted table
+ *
+ *  \param  shell   the shell
+ *  \param  name    name of the command
+ *
+ *  \return pointer to the entry in flash, or 0 if it is not found
+ */
+static const shell_cmd_t *Find(shell_t *shell, const char *name)
+{
+  uint8_t lo = 0, hi = shell->count, mid;
+  int     cmp;
+
+  while ( lo < hi ) {
+    mid = (lo + hi) / 2;
+    cmp = strcmp_P(name, shell->cmds[mid].name);
+    if ( cmp == 0 ) return &shell->cmds[mid];
+    if ( cmp < 0 ) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  return 0;
+}
+
+/*  \brief  Prints the commands and their help
+ *
+ *  \param  shell   the shell
+ *
+ *  \return void
+ */
+static void Help(shell_t *shell)
+{
+  uint8_t i;
+
+  for (i = 0; i < shell->count; i++) {
+    printf_P(PSTR("  %-9S %S\n"), shell->cmds[i].name, shell->cmds[i].help);
+  }
+}
+
+/*! \brief  Initializes a shell and prints the prompt
+ *
+ *  \param  shell   the state of the shell
+ *  \param  cmds    the table of commands in flash, sorted by name (strcmp)
+ *  \param  count   number of commands, see SHELL_COUNT()
+ *
+ *  \details The characters of the line are echoed. If the table is not
+ *           sorted, the first command that is out of order is printed.
+ *
+ *  \return 0, or SHELL_ERR_ORDER if the table is not sorted
+ */
+int8_t shellF0_init(shell_t *shell, const shell_cmd_t *cmds, uint8_t count)
+{
+  char    prev[SHELL_NAME_SIZE];
+  uint8_t i;
+
+  line_init(&shell->line, shell->buf, SHELL_LINE_SIZE);
+  shell->line.flags |= LINE_FLAG_ECHO;
+  shell->cmds  = cmds;
+  shell->count = count;
+
+  for (i = 1; i < count; i++) {
+    memcpy_P(prev, cmds[i - 1].name, SHELL_NAME_SIZE);
+    if ( strcmp_P(prev, cmds[i].name) >= 0 ) {
+      printf_P(PSTR("shell: '%S' is not sorted\n"), cmds[i].name);
+      return SHELL_ERR_ORDER;
+    }
+  }
+
+  printf_P(PSTR(SHELL_PROMPT));
+
+  return 0;
+}
+
+/*! \brief  Executes a line with a command
+ *
+ *  \param  shell   the shell
+ *  \param  line    the line, it is changed by the splitting in words
+ *
+ *  \details An empty line does nothing. An unknown command and other errors
+ *           are not printed, shellF0_poll() prints them.
+ *
+ *  \return the result of the command or SHELL_ERR_...
+ */
+int8_t shellF0_exec(shell_t *shell, char *line)
+{
+  char              *argv[SHELL_MAX_ARGS];
+  uint8_t            argc;
+  const shell_cmd_t *cmd;
+  shell_fn_t         fn;
+
+  argc = Split(line, argv);
+  if ( argc == 0 ) return 0;
+  if ( argc > SHELL_MAX_ARGS ) return SHELL_ERR_ARGS;
+
+  cmd = Find(shell, argv[0]);
+  if ( cmd == 0 ) {
+    if ( strcmp_P(argv[0], PSTR("help")) != 0 ) return SHELL_ERR_UNKNOWN;
+    Help(shell);
+    return 0;
+  }
+
+  fn = (shell_fn_t) pgm_read_word(&cmd->fn);
+  return fn(argc, argv);
+}
+
+/*! \brief  Receives the line and executes the command without waiting
+ *
+ *  \param  shell   the shell, see shellF0_init()
+ *  \param  tick    the current time in milliseconds, see uartF0_readline()
+ *
+ *  \details Call it from the main loop. When a line is complete the command
+ *           is executed, an error is printed and the prompt is printed again.
+ *
+ *  \return 1 if a line was executed, else 0
+ */
+uint8_t shellF0_poll(shell_t *shell, uint16_t tick)
+{
+  uint8_t res = uartF0_readline(&shell->line, tick);
+  int8_t  err;
+
+  if ( res == LINE_PARTIAL ) return 0;
+
+  err = ( res == LINE_OVERFLOW ) ? SHELL_ERR_LINE : shellF0_exec(shell, shell->line.buf);
+
+  switch (err) {
+    case 0:                                                                        break;
+    case SHELL_ERR_UNKNOWN: printf_P(PSTR("unknown command, try help\n"));         break;
+    case SHELL_ERR_ARGS:    printf_P(PSTR("too many words\n"));                    break;
+    case SHELL_ERR_LINE:    printf_P(PSTR("line too long\n"));                     break;
+    default:                printf_P(PSTR("error %d\n"), err);                     break;
+  }
+  printf_P(PSTR(SHELL_PROMPT));
+
+  return 1;
+}
@@ -0,0 +1,80 @@
+/*!
+ *  \file    shellF0.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Command shell on the console (UARTF0)
+ *
+ *  \details The shell reads a line with uartF0_readline(), so it doesn't wait
+ *           for the user and runs in the main loop:
+ *  \code
+    static const shell_cmd_t cmds[] PROGMEM = {    // sorted by name
+      { "devices", cmd_devices, "number of connected devices" },
+      { "state",   cmd_state,   "show the state" },
+    };
+    shell_t shell;
+
+    shellF0_init(&shell, cmds, SHELL_COUNT(cmds));
+    while (1) {
+      shellF0_poll(&shell, tick);
+      ...
+    } \endcode
+ *           The table of the commands is in flash and sorted by name, a command
+ *           is found with a binary search. shellF0_init() checks the order.
+ *           The words of the line are separated by spaces. They are not
+ *           copied, the spaces in the line buffer are replaced by '\\0' and
+ *           argv[] points to the words. argv[0] is the name of the command.
+ *           A command returns 0 or an error number, which is printed.
+ *           The command "help" lists the commands if it is not in the table.
+ */
+
+#ifndef SHELLF0_H_
+#define SHELLF0_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#include "serialF0.h"
+
+#ifndef SHELL_LINE_SIZE
+#define SHELL_LINE_SIZE   64       //!<  size of the line buffer (including the '\\0')
+#endif
+#ifndef SHELL_MAX_ARGS
+#define SHELL_MAX_ARGS    8        //!<  maximum number of words in a line (including the command)
+#endif
+#define SHELL_NAME_SIZE   10       //!<  size of the name of a command (including the '\\0')
+#define SHELL_HELP_SIZE   40       //!<  size of the help text of a command (including the '\\0')
+
+#define SHELL_PROMPT      "> "     //!<  the prompt
+
+#define SHELL_ERR_UNKNOWN -1       //!<  the command is not in the table
+#define SHELL_ERR_ARGS    -2       //!<  more than SHELL_MAX_ARGS words
+#define SHELL_ERR_LINE    -3       //!<  the line didn't fit in the buffer
+#define SHELL_ERR_ORDER   -4       //!<  shellF0_init: the table is not sorted
+
+//! A command: returns 0 or an error number, argv[0] is the name of the command
+typedef int8_t (*shell_fn_t)(uint8_t argc, char *argv[]);
+
+//! An entry of the table of commands, the table is in flash (PROGMEM)
+typedef struct {
+  char        name[SHELL_NAME_SIZE]; //!<  name of the command
+  shell_fn_t  fn;                    //!<  the function of the command
+  char        help[SHELL_HELP_SIZE]; //!<  one line of help
+} shell_cmd_t;
+
+//! State of a shell
+typedef struct {
+  line_t             line;                   //!<  state of the line that is received
+  char               buf[SHELL_LINE_SIZE];   //!<  buffer for the line
+  const shell_cmd_t *cmds;                   //!<  table of commands in flash
+  uint8_t            count;                  //!<  number of commands
+} shell_t;
+
+//! Number of commands in a table
+#define SHELL_COUNT(cmds) ((uint8_t) (sizeof(cmds) / sizeof(shell_cmd_t)))
+
+int8_t    shellF0_init(shell_t *shell, const shell_cmd_t *cmds, uint8_t count);
+uint8_t   shellF0_poll(shell_t *shell, uint16_t tick);
+int8_t    shellF0_exec(shell_t *shell, char *line);
+
+#endif // SHELLF0_H_
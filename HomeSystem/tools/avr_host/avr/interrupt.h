@@ -0,0 +1,23 @@
+/*!
+ *  \file    avr/interrupt.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Interrupts for the host shim
+ *
+ *  \details An ISR is a normal function, avr_host.c calls it from a signal
+ *           handler on the thread of the program, so it interrupts the
+ *           program like on the Xmega. sei() and cli() set the I bit of SREG,
+ *           the signal handler doesn't call ISRs while it is cleared.
+ */
+
+#ifndef AVR_HOST_INTERRUPT_H_
+#define AVR_HOST_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector)   void vector(void)           //!<  defines an ISR
+#define sei()         (SREG |= CPU_I_bm)           //!<  enables the interrupts
+#define cli()         (SREG &= ~CPU_I_bm)          //!<  disables the interrupts
+
+#endif // AVR_HOST_INTERRUPT_H_
@@ -0,0 +1,124 @@
+/*!
+ *  \file    avr/io.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Registers of the Xmega for the host shim
+ *
+ *  \details Only the registers and bits that the serial drivers use, with the
+ *           values of the atxmega256a3u. The registers are variables in
+ *           avr_host.c, USARTF0, USARTC0 and USARTE0 can be connected to a pty
+ *           or a socket with uart_host_open().
+ *
+ *           DATA is 16 bit, so the shim sees if an ISR wrote a byte: it is
+ *           set to UART_HOST_NO_DATA before the DRE ISR is called.
+ *           There is no DMA, compile without TXDMA_CH_xn.
+ */
+
+#ifndef AVR_HOST_IO_H_
+#define AVR_HOST_IO_H_
+
+#include <stdint.h>
+
+#if defined(TXDMA_CH_F0) || defined(TXDMA_CH_C0) || defined(TXDMA_CH_E0)
+#error "the host shim has no DMA, compile without TXDMA_CH_xn"
+#endif
+
+//! USART
+typedef struct {
+  volatile uint16_t DATA;          //!<  data register (16 bit in the shim)
+  volatile uint8_t  STATUS;        //!<  status register
+  volatile uint8_t  CTRLA;         //!<  interrupt levels
+  volatile uint8_t  CTRLB;         //!<  RX/TX enable, CLK2X
+  volatile uint8_t  CTRLC;         //!<  frame format
+  volatile uint8_t  BAUDCTRLA;     //!<  BSEL low
+  volatile uint8_t  BAUDCTRLB;     //!<  BSCALE and BSEL high
+} USART_t;
+
+//! I/O port
+typedef struct {
+  volatile uint8_t  DIR, DIRSET, DIRCLR, DIRTGL;
+  volatile uint8_t  OUT, OUTSET, OUTCLR, OUTTGL;
+  volatile uint8_t  IN, INTCTRL, INT0MASK, INT1MASK, INTFLAGS;
+  volatile uint8_t  PIN0CTRL, PIN1CTRL, PIN2CTRL, PIN3CTRL, PIN4CTRL, PIN5CTRL, PIN6CTRL, PIN7CTRL;
+} PORT_t;
+
+//! Programmable multilevel interrupt controller
+typedef struct {
+  volatile uint8_t  STATUS;
+  volatile uint8_t  INTPRI;
+  volatile uint8_t  CTRL;
+} PMIC_t;
+
+extern USART_t USARTC0, USARTE0, USARTF0;
+extern PORT_t  PORTC, PORTE, PORTF;
+extern PMIC_t  PMIC;
+extern volatile uint8_t SREG;      //!<  status register, only the I bit is used
+
+#define CPU_I_bm                  0x80
+
+#define USART_RXCIF_bm            0x80
+#define USART_TXCIF_bm            0x40
+#define USART_DREIF_bm            0x20
+#define USART_FERR_bm             0x10
+#define USART_BUFOVF_bm           0x08
+#define USART_PERR_bm             0x04
+
+#define USART_RXCINTLVL_gm        0x30
+#define USART_RXCINTLVL_gp        4
+#define USART_RXCINTLVL_OFF_gc    0x00
+#define USART_RXCINTLVL_LO_gc     0x10
+#define USART_RXCINTLVL_MED_gc    0x20
+#define USART_RXCINTLVL_HI_gc     0x30
+#define USART_TXCINTLVL_gm        0x0C
+#define USART_TXCINTLVL_OFF_gc    0x00
+#define USART_DREINTLVL_gm        0x03
+#define USART_DREINTLVL_gp        0
+#define USART_DREINTLVL_OFF_gc    0x00
+#define USART_DREINTLVL_LO_gc     0x01
+#define USART_DREINTLVL_MED_gc    0x02
+#define USART_DREINTLVL_HI_gc     0x03
+
+#define USART_RXEN_bm             0x10
+#define USART_TXEN_bm             0x08
+#define USART_CLK2X_bm            0x04
+
+#define USART_BSEL_gm             0xFF
+#define USART_BSCALE_gm           0xF0
+#define USART_BSCALE_gp           4
+
+#define PMIC_HILVLEN_bm           0x04
+#define PMIC_MEDLVLEN_bm          0x02
+#define PMIC_LOLVLEN_bm           0x01
+
+#define PORT_OPC_PULLUP_gc        0x18
+#define PORT_ISC_FALLING_gc       0x02
+#define PORT_INT1LVL_gm           0x0C
+#define PORT_INT1LVL_LO_gc        0x04
+
+#define PIN0_bm                   0x01
+#define PIN1_bm                   0x02
+#define PIN2_bm                   0x04
+#define PIN3_bm                   0x08
+#define PIN4_bm                   0x10
+#define PIN5_bm                   0x20
+#define PIN6_bm                   0x40
+#define PIN7_bm                   0x80
+#define PIN0_bp                   0
+#define PIN1_bp                   1
+#define PIN2_bp                   2
+#define PIN3_bp                   3
+#define PIN4_bp                   4
+#define PIN5_bp                   5
+#define PIN6_bp                   6
+#define PIN7_bp                   7
+
+//! The ISRs of the drivers, ISR() defines them as normal functions
+void USARTC0_RXC_vect(void);
+void USARTC0_DRE_vect(void);
+void USARTE0_RXC_vect(void);
+void USARTE0_DRE_vect(void);
+void USARTF0_RXC_vect(void);
+void USARTF0_DRE_vect(void);
+
+#endif // AVR_HOST_IO_H_
@@ -0,0 +1,28 @@
+/*!
+ *  \file    avr/pgmspace.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Program memory for the host shim
+ *
+ *  \details The host has one address space, data in PROGMEM is normal data
+ *           and the _P functions are the normal functions.
+ */
+
+#ifndef AVR_HOST_PGMSPACE_H_
+#define AVR_HOST_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+#define PROGMEM
+#define PSTR(s)                   (s)
+#define pgm_read_byte(p)          (*(const uint8_t *) (p))
+#define pgm_read_word(p)          (*(p))          //!<  also reads a function pointer on the host
+#define strcmp_P(s, p)            strcmp((s), (p))
+#define strlen_P(p)               strlen(p)
+#define memcpy_P(d, p, n)         memcpy((d), (p), (n))
+#define printf_P                  printf
+
+#endif // AVR_HOST_PGMSPACE_H_
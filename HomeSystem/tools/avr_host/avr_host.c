@@ -0,0 +1,499 @@
+/*!
+ *  \file    avr_host.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Host shim for the serial drivers: a USART on a pty or a socket
+ *
+ *  \details See avr_host.h. The registers of the shim are defined here, with
+ *           the streams of avr-libc (stdio.h of the shim) and the threads of
+ *           the USARTs.
+ *
+ *           A thread shares the receive buffer (rx_fifo) and the transmit
+ *           data (tx_data) with the signal handler, both with one writer and
+ *           one reader, through atomic indices and flags. The registers are
+ *           only written by the program and the ISRs, the thread only reads
+ *           CTRLA, CTRLB and the baud rate.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+#include "avr_host.h"
+
+#define UART_HOST_MAX     3        // USARTs that can be connected at the same time
+#define UART_HOST_SIGNAL  SIGUSR1  // the interrupt request
+#define UART_HOST_POLL    20000    // ns between two looks at the registers
+#define UART_HOST_WAIT    50000    // ns before the next try if the RXC ISR is late
+
+USART_t USARTC0, USARTE0, USARTF0;
+PORT_t  PORTC, PORTE, PORTF;
+PMIC_t  PMIC;
+volatile uint8_t SREG;
+
+avr_file_t *avr_stdin, *avr_stdout;
+
+static uart_host_t *uarts[UART_HOST_MAX];
+static pthread_t    cpu;                 // the thread of the program, gets the interrupts
+
+/*  \brief  Tests if an interrupt level is enabled in the PMIC
+ *
+ *  \param  level   the level (0: off, 1: low, 2: medium, 3: high)
+ *
+ *  \return non-zero if the ISR may be called
+ */
+static int Enabled(uint8_t level)
+{
+  return level != 0 && (PMIC.CTRL & (1 << (level - 1)));
+}
+
+/*  \brief  Signal handler, calls the ISRs of the USARTs with a request
+ *
+ *  \param  sig     UART_HOST_SIGNAL
+ */
+static void Interrupt(int sig)
+{
+  uart_host_t *u;
+  unsigned     rd;
+  int          i;
+
+  (void) sig;
+  if ( !(SREG & CPU_I_bm) ) return;      // the thread requests again
+
+  for (i = 0; i < UART_HOST_MAX; i++) {  // RXC, medium level
+    if ( (u = uarts[i]) == 0 ) continue;
+    while ( (rd = atomic_load(&u->rx_rd)) != atomic_load(&u->rx_wr) &&
+            Enabled((u->usart->CTRLA & USART_RXCINTLVL_gm) >> USART_RXCINTLVL_gp) ) {
+      u->usart->DATA   = u->rx_fifo[rd & 1];
+      u->usart->STATUS = USART_RXCIF_bm | (atomic_exchange(&u->rx_ovf, 0) ? USART_BUFOVF_bm : 0);
+      atomic_store(&u->rx_rd, rd + 1);
+      u->rxc();
+      u->usart->STATUS = 0;
+    }
+  }
+
+  for (i = 0; i < UART_HOST_MAX; i++) {  // DRE, low level
+    if ( (u = uarts[i]) == 0 ) continue;
+    if ( !atomic_load(&u->tx_full) &&
+         Enabled((u->usart->CTRLA & USART_DREINTLVL_gm) >> USART_DREINTLVL_gp) ) {
+      u->usart->DATA = UART_HOST_NO_DATA;
+      u->dre();
+      if ( u->usart->DATA != UART_HOST_NO_DATA ) {
+        u->tx_data = u->usart->DATA;
+        atomic_store(&u->tx_full, 1);
+      }
+    }
+  }
+}
+
+/*  \brief  Time of a byte (start bit, 8 data bits and stop bit) on the line
+ *
+ *  \param  u       the USART
+ *
+ *  \return the time in ns, 0 if the baud rate is not set
+ */
+static uint64_t ByteTime(const uart_host_t *u)
+{
+  double baud = uart_host_baud(u);
+
+  return baud > 0 ? (uint64_t) (10e9 / baud) : 0;
+}
+
+/*  \brief  Sleeps until a time or until a byte can be read
+ *
+ *  \param  fd      the file descriptor, -1 to only sleep
+ *  \param  ns      the time
+ */
+static void Sleep(int fd, uint64_t ns)
+{
+  struct pollfd   pfd = { fd, POLLIN, 0 };
+  struct timespec ts  = { 0, (long) ns };
+
+  ppoll(&pfd, 1, &ts, 0);
+}
+
+/*  \brief  Start of a byte on the line
+ *
+ *  \param  idle    non-zero if the line was idle after the previous byte
+ *  \param  done    end of the previous byte
+ *  \param  now     the time
+ *  \param  byte    time of a byte
+ *
+ *  \return the end of the byte: a byte after an idle line starts now, a byte
+ *          that follows the previous one starts at its end, but a thread that
+ *          runs late catches up one byte at most
+ */
+static uint64_t Start(int idle, uint64_t done, uint64_t now, uint64_t byte)
+{
+  uint64_t start = idle ? now : done;
+
+  if ( start + byte < now ) start = now - byte;
+  return start + byte;
+}
+
+/*  \brief  The thread of a USART, it plays the line and the shift registers
+ *
+ *  \details A received byte is taken from the file descriptor when its start
+ *           bit begins and is put in the receive buffer one byte time later.
+ *           A byte of the DRE ISR goes to the shift register when it is free
+ *           and is written to the file descriptor when it is sent, so the line
+ *           never goes faster than the baud rate.
+ *
+ *           A received byte is only lost if the receive buffer is full while
+ *           the program blocks the RXC ISR (cli() or the level disabled). If
+ *           the ISR could run but the host didn't run it yet, the line waits:
+ *           lost bytes depend on the program, not on the load of the host.
+ *           The thread sleeps until the next byte is done, a byte can be read
+ *           or the next look at the registers, it never spins: with one CPU
+ *           the program needs it.
+ *
+ *  \param  arg     the USART
+ */
+static void *Line(void *arg)
+{
+  uart_host_t *u = arg;
+  uint64_t now, next, byte, rx_done = 0, tx_done = 0;
+  uint8_t  rx_shift = 0, tx_shift = 0;
+  int      rx_busy = 0, tx_busy = 0, rx_idle = 1, tx_idle = 1, rx_wait, pending;
+  unsigned wr;
+
+  prctl(PR_SET_TIMERSLACK, 1UL);
+
+  while ( atomic_load(&u->run) ) {
+    now  = uart_host_ns();
+    byte = ByteTime(u);
+    if ( byte == 0 ) {
+      Sleep(-1, UART_HOST_POLL);
+      continue;
+    }
+
+    rx_wait = 0;
+    if ( rx_busy && now >= rx_done ) {               // the stop bit is received
+      wr = atomic_load(&u->rx_wr);
+      if ( wr - atomic_load(&u->rx_rd) < 2 ) {
+        u->rx_fifo[wr & 1] = rx_shift;
+        atomic_store(&u->rx_wr, wr + 1);
+        rx_busy = 0;
+      } else if ( !(SREG & CPU_I_bm) ||
+                  !Enabled((u->usart->CTRLA & USART_RXCINTLVL_gm) >> USART_RXCINTLVL_gp) ) {
+        atomic_store(&u->rx_ovf, 1);
+        atomic_fetch_add(&u->lost, 1);
+        rx_busy = 0;
+      } else {
+        rx_wait = 1;                                 // the ISR is late, not blocked
+        rx_done = now;
+      }
+      if ( !rx_busy ) atomic_fetch_add(&u->rx_count, 1);
+    }
+    if ( !rx_busy && (u->usart->CTRLB & USART_RXEN_bm) ) {
+      if ( read(u->fd, &rx_shift, 1) == 1 ) {
+        rx_done = Start(rx_idle, rx_done, now, byte);
+        rx_busy = 1;
+        rx_idle = 0;
+      } else {
+        rx_idle = 1;
+      }
+    }
+
+    if ( tx_busy && now >= tx_done ) {               // the stop bit is sent
+      if ( write(u->fd, &tx_shift, 1) == 1 || errno != EAGAIN ) {
+        atomic_fetch_add(&u->tx_count, 1);
+        tx_busy = 0;
+      }
+    }
+    if ( !tx_busy ) {
+      if ( atomic_load(&u->tx_full) && (u->usart->CTRLB & USART_TXEN_bm) ) {
+        tx_shift = u->tx_data;
+        atomic_store(&u->tx_full, 0);
+        tx_done = Start(tx_idle, tx_done, now, byte);
+        tx_busy = 1;
+        tx_idle = 0;
+      } else {
+        tx_idle = 1;
+      }
+    }
+
+    pending = ( atomic_load(&u->rx_rd) != atomic_load(&u->rx_wr) &&
+                (u->usart->CTRLA & USART_RXCINTLVL_gm) ) ||
+              ( !atomic_load(&u->tx_full) && (u->usart->CTRLA & USART_DREINTLVL_gm) );
+    if ( pending ) pthread_kill(cpu, UART_HOST_SIGNAL);
+
+    next = now + ( rx_wait ? UART_HOST_WAIT : UART_HOST_POLL );
+    if ( rx_busy && !rx_wait && rx_done < next ) next = rx_done;
+    if ( tx_busy && tx_done < next ) next = tx_done;
+    now = uart_host_ns();
+    if ( next > now ) {
+      Sleep( !rx_busy && (u->usart->CTRLB & USART_RXEN_bm) ? u->fd : -1, next - now );
+    }
+  }
+
+  return 0;
+}
+
+/*! \brief  Connects a USART to a file descriptor
+ *
+ *  \param  uart    the state of the connection
+ *  \param  usart   the registers, e.g. &USARTF0
+ *  \param  rxc     the RXC ISR, e.g. USARTF0_RXC_vect
+ *  \param  dre     the DRE ISR, e.g. USARTF0_DRE_vect
+ *  \param  fd      the other side of the line, it is made non-blocking
+ *  \param  f_cpu   the clock frequency of the program
+ *
+ *  \details Use UART_HOST_OPEN(). The ISRs interrupt the calling thread. It
+ *           gets the lowest priority, so a thread of a USART gets the CPU as
+ *           soon as it wakes up, also on a host with one CPU.
+ *
+ *  \return 0, or -1 if all connections are used or the thread fails
+ */
+int uart_host_open(uart_host_t *uart, USART_t *usart, void (*rxc)(void), void (*dre)(void), int fd, uint32_t f_cpu)
+{
+  struct sigaction sa;
+  sigset_t block, old;
+  int      i, res;
+
+  for (i = 0; i < UART_HOST_MAX && uarts[i] != 0; i++) ;
+  if ( i == UART_HOST_MAX ) return -1;
+
+  memset(uart, 0, sizeof(*uart));
+  uart->usart = usart;
+  uart->rxc   = rxc;
+  uart->dre   = dre;
+  uart->fd    = fd;
+  uart->f_cpu = f_cpu;
+  atomic_store(&uart->run, 1);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = Interrupt;
+  sa.sa_flags   = SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  sigaction(UART_HOST_SIGNAL, &sa, 0);
+  cpu = pthread_self();
+  setpriority(PRIO_PROCESS, gettid(), 19);   // on Linux only the calling thread
+
+  sigemptyset(&block);                       // the thread doesn't get the interrupts
+  sigaddset(&block, UART_HOST_SIGNAL);
+  pthread_sigmask(SIG_BLOCK, &block, &old);
+  res = pthread_create(&uart->thread, 0, Line, uart);
+  pthread_sigmask(SIG_SETMASK, &old, 0);
+  if ( res != 0 ) return -1;
+
+  uarts[i] = uart;
+  return 0;
+}
+
+/*! \brief  Disconnects a USART, the file descriptor is not closed
+ *
+ *  \param  uart    the connection
+ *
+ *  \return void
+ */
+void uart_host_close(uart_host_t *uart)
+{
+  int i;
+
+  atomic_store(&uart->run, 0);
+  pthread_join(uart->thread, 0);
+  for (i = 0; i < UART_HOST_MAX; i++) {
+    if ( uarts[i] == uart ) uarts[i] = 0;
+  }
+}
+
+/*! \brief  Opens a pty for a USART
+ *
+ *  \param  name    buffer for the name of the terminal side, e.g. /dev/pts/3
+ *  \param  size    size of the buffer
+ *
+ *  \details The terminal side is set to raw mode and stays open, so a
+ *           terminal program can connect and disconnect.
+ *
+ *  \return the file descriptor of the other side, for uart_host_open(), or -1
+ */
+int uart_host_pty(char *name, size_t size)
+{
+  struct termios tio;
+  int master, slave;
+
+  if ( (master = posix_openpt(O_RDWR | O_NOCTTY)) < 0 ) return -1;
+  if ( grantpt(master) < 0 || unlockpt(master) < 0 ) return -1;
+  if ( ptsname_r(master, name, size) != 0 ) return -1;
+  if ( (slave = open(name, O_RDWR | O_NOCTTY)) < 0 ) return -1;
+
+  tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+
+  return master;
+}
+
+/*! \brief  The baud rate of a USART
+ *
+ *  \param  uart    the connection
+ *
+ *  \details Calculated from BAUDCTRLA, BAUDCTRLB and CLK2X like the Xmega,
+ *           see serial_baud_try() in serial.h.
+ *
+ *  \return the baud rate, 0 if the USART is not set up
+ */
+double uart_host_baud(const uart_host_t *uart)
+{
+  const USART_t *usart = uart->usart;
+  uint16_t bsel   = ((usart->BAUDCTRLB & 0x0F) << 8) | usart->BAUDCTRLA;
+  int8_t   bscale = (int8_t) usart->BAUDCTRLB >> USART_BSCALE_gp;
+  double   n      = ( usart->CTRLB & USART_CLK2X_bm ) ? 8 : 16;
+
+  if ( !(usart->CTRLB & (USART_RXEN_bm | USART_TXEN_bm)) ) return 0;
+
+  if ( bscale >= 0 ) {
+    return uart->f_cpu / (n * (1 << bscale) * (bsel + 1));
+  }
+  return uart->f_cpu / (n * (bsel / (double) (1 << -bscale) + 1));
+}
+
+/*! \brief  The time of the host
+ *
+ *  \return a monotonic time in ns
+ */
+uint64_t uart_host_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*  \brief  Changes a format of avr-libc for the host: %S becomes %s
+ *
+ *  \param  fmt     the format
+ *  \param  buf     buffer for the new format
+ *  \param  size    size of the buffer
+ */
+static void Format(const char *fmt, char *buf, size_t size)
+{
+  size_t i = 0;
+
+  while ( *fmt && i + 1 < size ) {
+    buf[i++] = *fmt;
+    if ( *fmt++ != '%' ) continue;
+    while ( *fmt && strchr("-+ #0123456789.*hl", *fmt) && i + 1 < size ) buf[i++] = *fmt++;
+    if ( *fmt && i + 1 < size ) buf[i++] = ( *fmt == 'S' ) ? 's' : *fmt, fmt++;
+  }
+  buf[i] = '\0';
+}
+
+/*! \brief  printf() of avr-libc: prints to stdout of the program (avr_stdout)
+ *
+ *  \param  fmt     the format
+ *
+ *  \return the number of characters, or EOF
+ */
+int avr_printf(const char *fmt, ...)
+{
+  char    f[256], buf[512];
+  va_list ap;
+  int     n, i;
+
+  Format(fmt, f, sizeof(f));
+  va_start(ap, fmt);
+  n = vsnprintf(buf, sizeof(buf), f, ap);
+  va_end(ap);
+  if ( n >= (int) sizeof(buf) ) n = sizeof(buf) - 1;
+
+  for (i = 0; i < n; i++) {
+    if ( avr_putchar(buf[i]) == EOF ) return EOF;
+  }
+  return n;
+}
+
+/*! \brief  puts() of avr-libc
+ *
+ *  \param  s       the string, a newline is added
+ *
+ *  \return 0, or EOF
+ */
+int avr_puts(const char *s)
+{
+  while ( *s ) {
+    if ( avr_putchar(*s++) == EOF ) return EOF;
+  }
+  return avr_putchar('\n') == EOF ? EOF : 0;
+}
+
+/*! \brief  putchar() of avr-libc
+ *
+ *  \param  c       the character
+ *
+ *  \return the character, or EOF
+ */
+int avr_putchar(int c)
+{
+  if ( avr_stdout == 0 || !(avr_stdout->flags & _FDEV_SETUP_WRITE) ) return EOF;
+  return avr_stdout->put((char) c, avr_stdout) == 0 ? (uint8_t) c : EOF;
+}
+
+/*! \brief  getchar() of avr-libc, waits if the stream waits
+ *
+ *  \return the character, or EOF
+ */
+int avr_getchar(void)
+{
+  int c;
+
+  if ( avr_stdin == 0 || !(avr_stdin->flags & _FDEV_SETUP_READ) ) return EOF;
+  if ( avr_stdin->unget != EOF ) {
+    c = avr_stdin->unget;
+    avr_stdin->unget = EOF;
+    return c;
+  }
+  c = avr_stdin->get(avr_stdin);
+  return c < 0 ? EOF : (uint8_t) c;
+}
+
+/*! \brief  ungetc() of avr-libc, one character
+ *
+ *  \param  c       the character
+ *  \param  stream  the stream
+ *
+ *  \return the character, or EOF
+ */
+int avr_ungetc(int c, avr_file_t *stream)
+{
+  if ( c == EOF || stream->unget != EOF ) return EOF;
+  stream->unget = (uint8_t) c;
+  return stream->unget;
+}
+
+#undef stdout
+
+/*! \brief  printf() on stdout of the host, not on the USART
+ *
+ *  \param  fmt     the format
+ *
+ *  \return the number of characters
+ */
+int host_printf(const char *fmt, ...)
+{
+  va_list ap;
+  int     n;
+
+  va_start(ap, fmt);
+  n = vfprintf(stdout, fmt, ap);
+  va_end(ap);
+  fflush(stdout);
+  return n;
+}
@@ -0,0 +1,78 @@
+/*!
+ *  \file    avr_host.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Host shim for the serial drivers: a USART on a pty or a socket
+ *
+ *  \details The drivers of serialF0/ are compiled unmodified for Linux with
+ *           the headers in this directory (avr/io.h, avr/interrupt.h,
+ *           avr/pgmspace.h and stdio.h) instead of avr-libc. A USART is
+ *           connected to a file descriptor, the other end of a pty or of a
+ *           socketpair, with uart_host_open():
+ *  \code
+    uart_host_t uart;
+    int sv[2];
+
+    socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    UART_HOST_OPEN(&uart, F0, sv[0], F_CPU);
+    init_stream(F_CPU);                   // the baud rate of the line is set here
+    sei();
+    write(sv[1], "hello\r", 6);           // the other side of the line
+    getline(buf, sizeof buf); \endcode
+ *           A thread plays the USART: it takes the received bytes from the
+ *           file descriptor and sends the bytes of the DRE ISR, one byte per
+ *           10 bits at the baud rate of BAUDCTRLA, BAUDCTRLB and CLK2X. The
+ *           USART has a receive buffer of 2 bytes like the Xmega. If a byte is
+ *           received while this buffer is full, it is lost and BUFOVF is set.
+ *
+ *           The ISRs are called by a signal handler on the thread that called
+ *           uart_host_open(), so they interrupt the program at any point like
+ *           on the Xmega and never run at the same time as the program. They
+ *           are not called while the I bit of SREG is cleared (cli()). The RXC
+ *           ISR has priority over the DRE ISR.
+ *
+ *           Not in the shim: DMA, RTS/CTS and the TXC interrupt.
+ */
+
+#ifndef AVR_HOST_H_
+#define AVR_HOST_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <avr/io.h>
+
+#define UART_HOST_NO_DATA  0x0100  //!<  DATA before the DRE ISR: no byte written
+
+//! A USART connected to a file descriptor
+typedef struct {
+  USART_t       *usart;            //!<  registers of the USART
+  void         (*rxc)(void);       //!<  RXC ISR
+  void         (*dre)(void);       //!<  DRE ISR
+  int            fd;               //!<  the other side of the line
+  uint32_t       f_cpu;            //!<  clock frequency, for the baud rate
+  pthread_t      thread;           //!<  the thread of the USART
+  atomic_int     run;              //!<  0 stops the thread
+  uint8_t        rx_fifo[2];       //!<  receive buffer of the USART
+  atomic_uint    rx_wr, rx_rd;     //!<  free running indices of rx_fifo
+  atomic_int     rx_ovf;           //!<  a byte was lost, BUFOVF for the next byte
+  atomic_int     tx_full;          //!<  the DRE ISR wrote a byte that is not sent yet
+  uint8_t        tx_data;          //!<  the byte of the DRE ISR
+  atomic_ulong   rx_count;         //!<  bytes received on the line
+  atomic_ulong   tx_count;         //!<  bytes sent on the line
+  atomic_ulong   lost;             //!<  bytes lost in the USART (overrun)
+} uart_host_t;
+
+//! Connects USARTid (e.g. F0) and its ISRs to file descriptor fd
+#define UART_HOST_OPEN(uart, id, fd, f_cpu) \
+  uart_host_open((uart), &USART##id, USART##id##_RXC_vect, USART##id##_DRE_vect, (fd), (f_cpu))
+
+int       uart_host_open(uart_host_t *uart, USART_t *usart, void (*rxc)(void), void (*dre)(void), int fd, uint32_t f_cpu);
+void      uart_host_close(uart_host_t *uart);
+int       uart_host_pty(char *name, size_t size);
+double    uart_host_baud(const uart_host_t *uart);
+uint64_t  uart_host_ns(void);
+
+#endif // AVR_HOST_H_
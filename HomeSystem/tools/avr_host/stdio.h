@@ -0,0 +1,60 @@
+/*!
+ *  \file    stdio.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Streams of avr-libc for the host shim
+ *
+ *  \details The drivers make a FILE with FDEV_SETUP_STREAM() and set stdin
+ *           and stdout to it, like avr-libc. This header includes the stdio.h
+ *           of the host and replaces FILE, stdin, stdout and the functions on
+ *           them by a small version of the avr-libc streams (avr_host.c).
+ *           printf() formats like the host, %S prints a string like %s.
+ *           host_printf() prints to the stdout of the host, e.g. the results
+ *           of a test.
+ */
+
+#ifndef AVR_HOST_STDIO_H_
+#define AVR_HOST_STDIO_H_
+
+#include_next <stdio.h>
+#include <stdint.h>
+
+//! A stream of avr-libc
+typedef struct avr_file {
+  int   (*put)(char, struct avr_file *);   //!<  sends a character, 0 if it succeeded
+  int   (*get)(struct avr_file *);         //!<  receives a character
+  uint8_t flags;                           //!<  _FDEV_SETUP_...
+  int     unget;                           //!<  the character of ungetc(), or EOF
+} avr_file_t;
+
+#define _FDEV_SETUP_READ          0x01
+#define _FDEV_SETUP_WRITE         0x02
+#define _FDEV_SETUP_RW            (_FDEV_SETUP_READ | _FDEV_SETUP_WRITE)
+#define _FDEV_ERR                 (-1)
+#define _FDEV_EOF                 (-2)
+
+#define FDEV_SETUP_STREAM(p, g, f)  { (p), (g), (f), EOF }
+
+extern avr_file_t *avr_stdin, *avr_stdout;
+
+int   avr_printf(const char *fmt, ...);
+int   avr_puts(const char *s);
+int   avr_putchar(int c);
+int   avr_getchar(void);
+int   avr_ungetc(int c, avr_file_t *stream);
+int   host_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#undef  stdin
+#undef  stdout
+#define FILE                      avr_file_t
+#define stdin                     avr_stdin
+#define stdout                    avr_stdout
+#define printf                    avr_printf
+#define puts                      avr_puts
+#define putchar                   avr_putchar
+#define getchar                   avr_getchar
+#define ungetc                    avr_ungetc
+#define getline                   avr_getline     // getline() of serialF0.h, not of POSIX
+
+#endif // AVR_HOST_STDIO_H_
@@ -0,0 +1,180 @@
+/*!
+ *  \file    frame_host.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Framed binary messages on the PC (POSIX)
+ *
+ *  \details See frame_host.h. The port is set to raw mode, 8N1, without flow
+ *           control, like USARTF0 of the board.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "frame_host.h"
+
+/*  brief   Converts a baud rate to a termios speed
+ *
+ *  param   baud    the baud rate
+ *
+ *  return  the speed, B0 if the baud rate is not supported
+ */
+static speed_t frame_speed(long baud)
+{
+  switch ( baud ) {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    default:      return B0;
+  }
+}
+
+/*! \brief  Opens a serial port for frames
+ *
+ *  \param  port    pointer to the port
+ *  \param  path    the device, e.g. /dev/ttyACM0
+ *  \param  baud    the baud rate, e.g. 115200
+ *
+ *  \return 0 if succeeded, else -1 (see errno)
+ */
+int frame_port_open(frame_port_t *port, const char *path, long baud)
+{
+  struct termios tio;
+  speed_t speed = frame_speed(baud);
+  int fd;
+
+  if ( speed == B0 ) {
+    errno = EINVAL;
+    return -1;
+  }
+  if ( (fd = open(path, O_RDWR | O_NOCTTY)) < 0 ) return -1;
+
+  if ( tcgetattr(fd, &tio) < 0 ) {
+    close(fd);
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cflag |= CLOCAL | CREAD;
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  if ( tcsetattr(fd, TCSANOW, &tio) < 0 ) {
+    close(fd);
+    return -1;
+  }
+
+  frame_port_attach(port, fd);
+  return 0;
+}
+
+/*! \brief  Uses an open file descriptor (e.g. a pty) for frames
+ *
+ *  \param  port    pointer to the port
+ *  \param  fd      the file descriptor
+ *
+ *  \return void
+ */
+void frame_port_attach(frame_port_t *port, int fd)
+{
+  port->fd  = fd;
+  port->pos = 0;
+  port->len = 0;
+  frame_decoder_init(&port->dec);
+}
+
+/*! \brief  Closes a port
+ *
+ *  \param  port    pointer to the port
+ *
+ *  \return void
+ */
+void frame_port_close(frame_port_t *port)
+{
+  close(port->fd);
+  port->fd = -1;
+}
+
+/*! \brief  Sends a message
+ *
+ *  \param  port    pointer to the port
+ *  \param  type    the type of the message
+ *  \param  data    the data of the message
+ *  \param  len     the length of the data (at most FRAME_MAX_DATA)
+ *
+ *  \return 0 if succeeded, else -1 (see errno)
+ */
+int frame_port_send(frame_port_t *port, uint8_t type, const uint8_t *data, uint8_t len)
+{
+  uint8_t  out[FRAME_MAX_SIZE];
+  size_t   n, i = 0;
+  ssize_t  w;
+
+  if ( (n = frame_encode(out, type, data, len)) == 0 ) {
+    errno = EINVAL;
+    return -1;
+  }
+  while ( i < n ) {
+    w = write(port->fd, out + i, n - i);
+    if ( w < 0 ) {
+      if ( errno == EINTR ) continue;
+      return -1;
+    }
+    i += w;
+  }
+  return 0;
+}
+
+/*! \brief  Receives a message
+ *
+ *  \param  port        pointer to the port
+ *  \param  timeout_ms  the maximum time to wait for a message, -1 is forever
+ *
+ *  \details The message is in port->dec (frame_type(), frame_length() and
+ *           frame_data()) until the next call. Frames with errors are dropped
+ *           and counted in port->dec.errors.
+ *
+ *  \return FRAME_OK if a message is received, FRAME_NONE after the timeout,
+ *          -1 if the port failed or is closed (see errno)
+ */
+int frame_port_recv(frame_port_t *port, int timeout_ms)
+{
+  struct pollfd pfd;
+  ssize_t  r;
+  int      ready;
+
+  for (;;) {
+    while ( port->pos < port->len ) {
+      if ( frame_decode(&port->dec, port->buf[port->pos++]) == FRAME_OK ) return FRAME_OK;
+    }
+
+    pfd.fd     = port->fd;
+    pfd.events = POLLIN;
+    ready = poll(&pfd, 1, timeout_ms);
+    if ( ready < 0 ) {
+      if ( errno == EINTR ) continue;
+      return -1;
+    }
+    if ( ready == 0 ) return FRAME_NONE;
+
+    r = read(port->fd, port->buf, sizeof(port->buf));
+    if ( r < 0 ) {
+      if ( errno == EINTR || errno == EAGAIN ) continue;
+      return -1;
+    }
+    if ( r == 0 ) {
+      errno = EPIPE;
+      return -1;
+    }
+    port->pos = 0;
+    port->len = r;
+  }
+}
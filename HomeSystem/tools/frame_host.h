@@ -0,0 +1,37 @@
+/*!
+ *  \file    frame_host.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Framed binary messages on the PC (POSIX)
+ *
+ *  \details The PC side of serialF0/frameF0.c: messages are sent and received as
+ *           frames (serialF0/frame.h) over a serial port or a pty. Compile it with
+ *           serialF0/frame.c, e.g.
+ *  \verbatim
+    gcc -O2 -I../serialF0 -o frame_loop frame_loop.c frame_host.c ../serialF0/frame.c \endverbatim
+ */
+
+#ifndef FRAME_HOST_H_
+#define FRAME_HOST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "frame.h"
+
+//! A serial port for frames
+typedef struct {
+  int              fd;             //!<  file descriptor of the port
+  frame_decoder_t  dec;            //!<  receiver of the frames
+  uint8_t          buf[512];       //!<  bytes read from the port
+  size_t           pos;            //!<  next byte in buf to decode
+  size_t           len;            //!<  number of bytes in buf
+} frame_port_t;
+
+int  frame_port_open(frame_port_t *port, const char *path, long baud);
+void frame_port_attach(frame_port_t *port, int fd);
+void frame_port_close(frame_port_t *port);
+int  frame_port_send(frame_port_t *port, uint8_t type, const uint8_t *data, uint8_t len);
+int  frame_port_recv(frame_port_t *port, int timeout_ms);
+
+#endif // FRAME_HOST_H_
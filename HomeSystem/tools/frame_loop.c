@@ -0,0 +1,131 @@
+/*!
+ *  \file    frame_loop.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Loopback test of the framed messages over a pty
+ *
+ *  \details Sends measurements from one end of a pty to the other, once as
+ *           frames (frame_host.c) and once as text with printf and sscanf like
+ *           the current tools, and prints the bytes and the time per message.
+ *           Every tenth frame is corrupted to check that it is dropped and the
+ *           next frame is received. Compile and run:
+ *  \verbatim
+    gcc -O2 -I../serialF0 -o frame_loop frame_loop.c frame_host.c ../serialF0/frame.c
+    ./frame_loop [number of messages] \endverbatim
+ *           The time per message on a serial line is the number of bytes times
+ *           10 bits / 115200 baud.
+ */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "frame_host.h"
+
+#define MSG_MEASUREMENT   0x10     //!< type of a measurement: 4 values of 16 bit
+
+/*  brief   Returns the time in seconds
+ */
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*  brief   Opens a pty in raw mode
+ *
+ *  param   master  pointer to the file descriptor of the master
+ *  param   slave   pointer to the file descriptor of the slave
+ *
+ *  return  0 if succeeded
+ */
+static int open_pty(int *master, int *slave)
+{
+  struct termios tio;
+
+  if ( (*master = posix_openpt(O_RDWR | O_NOCTTY)) < 0 ) return -1;
+  if ( grantpt(*master) < 0 || unlockpt(*master) < 0 ) return -1;
+  if ( (*slave = open(ptsname(*master), O_RDWR | O_NOCTTY)) < 0 ) return -1;
+
+  tcgetattr(*slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(*slave, TCSANOW, &tio);
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  frame_port_t  tx, rx;
+  int       master, slave, i, n, received = 0, lost = 0;
+  uint8_t   data[8], out[FRAME_MAX_SIZE];
+  uint16_t  v[4], w[4];
+  size_t    frame_bytes;
+  double    t, t_frame, t_text;
+  char      line[64];
+  FILE     *in;
+
+  n = ( argc > 1 ) ? atoi(argv[1]) : 20000;
+  if ( open_pty(&master, &slave) < 0 ) {
+    perror("pty");
+    return 1;
+  }
+  frame_port_attach(&tx, master);
+  frame_port_attach(&rx, slave);
+
+  // frames
+  t = now();
+  for (i = 0; i < n; i++) {
+    v[0] = 2153 + i; v[1] = 452; v[2] = 1013; v[3] = i & 0x3FF;
+    data[0] = v[0] >> 8; data[1] = v[0]; data[2] = v[1] >> 8; data[3] = v[1];
+    data[4] = v[2] >> 8; data[5] = v[2]; data[6] = v[3] >> 8; data[7] = v[3];
+
+    if ( i % 10 == 9 ) {                 // line noise: a bit of the frame is wrong
+      frame_bytes = frame_encode(out, MSG_MEASUREMENT, data, sizeof(data));
+      out[3] ^= 0x04;
+      if ( write(master, out, frame_bytes) != (ssize_t) frame_bytes ) return 1;
+      lost++;
+      continue;
+    }
+    frame_port_send(&tx, MSG_MEASUREMENT, data, sizeof(data));
+    if ( frame_port_recv(&rx, 1000) != FRAME_OK ) break;
+    if ( frame_type(&rx.dec) != MSG_MEASUREMENT || frame_length(&rx.dec) != sizeof(data) ||
+         memcmp(frame_data(&rx.dec), data, sizeof(data)) != 0 ) break;
+    received++;
+  }
+  t_frame = (now() - t) / n;
+  frame_port_recv(&rx, 100);           // the last corrupted frame
+  frame_bytes = frame_encode(out, MSG_MEASUREMENT, data, sizeof(data));
+
+  // text
+  in = fdopen(dup(slave), "r");
+  t = now();
+  for (i = 0; i < n; i++) {
+    v[0] = 2153 + i; v[1] = 452; v[2] = 1013; v[3] = i & 0x3FF;
+    dprintf(master, "T=%u.%02u H=%u.%u P=%u L=%u\r\n", v[0] / 100, v[0] % 100, v[1] / 10, v[1] % 10, v[2], v[3]);
+    if ( fgets(line, sizeof(line), in) == NULL ) break;
+    unsigned a, b, c, d, e, f;
+    if ( sscanf(line, "T=%u.%u H=%u.%u P=%u L=%u", &a, &b, &c, &d, &e, &f) != 6 ) break;
+    w[0] = a * 100 + b; w[1] = c * 10 + d; w[2] = e; w[3] = f;
+    if ( memcmp(v, w, sizeof(v)) != 0 ) break;
+  }
+  t_text = (now() - t) / n;
+
+  printf("frames: %d of %d received, %d corrupted dropped (errors %u)\n",
+         received, n - lost, lost, rx.dec.errors);
+  printf("frame: %zu bytes, %.2f ms at 115200 baud, %.1f us on the pty\n",
+         frame_bytes, frame_bytes * 10 / 115.2, t_frame * 1e6);
+  printf("text:  %zu bytes, %.2f ms at 115200 baud, %.1f us on the pty\n",
+         strlen(line), strlen(line) * 10 / 115.2, t_text * 1e6);
+
+  return ( received == n - lost && rx.dec.errors == (unsigned) lost ) ? 0 : 1;
+}
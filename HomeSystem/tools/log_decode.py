@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""Prints the deferred log records of serialF0/logF0.c as text
+
+Usage:
+  log_decode.py [-b baud] [-v] program.elf port
+
+  program.elf  the ELF file of the program on the board (avr-gcc output)
+  port         the serial port, e.g. /dev/ttyACM0, a file with the received
+               bytes or - for stdin
+  -b           baud rate of the serial port (default 115200)
+  -v           also print the messages that are not log records
+
+The board sends a record as a frame (serialF0/frame.h) of type FRAME_LOG
+with the address of the format string in flash and the values of the
+arguments, low byte first. The format strings are read from the ELF file,
+the arguments are formatted like printf on the AVR: int is 2 bytes, long
+and float 4 bytes. Error counters of the serial ports (FRAME_SERIAL_ERRORS)
+are printed too.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+FRAME_LOG = 0xFD
+FRAME_SERIAL_ERRORS = 0xFE
+LOG_ID_DROPPED = 0
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l)?([diuxXocfeEgGps%])")
+
+
+def read_flash(path):
+  """Returns the loaded sections in flash of an ELF32 file as (address, data)"""
+  with open(path, "rb") as f:
+    elf = f.read()
+  if elf[:4] != b"\x7fELF" or elf[4] != 1:
+    sys.exit("log_decode: %s is not an ELF32 file" % path)
+  end = "<" if elf[5] == 1 else ">"
+  shoff, = struct.unpack_from(end + "I", elf, 0x20)
+  shentsize, shnum = struct.unpack_from(end + "HH", elf, 0x2E)
+  sections = []
+  for i in range(shnum):
+    _, sh_type, flags, addr, offset, size = struct.unpack_from(end + "IIIIII", elf, shoff + i * shentsize)
+    if sh_type == 1 and flags & 0x2 and addr < 0x800000:     # PROGBITS, ALLOC, not in RAM
+      sections.append((addr, elf[offset:offset + size]))
+  return sections
+
+
+def format_string(flash, fid):
+  for addr, data in flash:
+    if addr <= fid < addr + len(data):
+      s = data[fid - addr:]
+      return s[:s.find(b"\0")].decode("latin-1")
+  return None
+
+
+def format_record(fmt, args):
+  """Formats the arguments like printf on the AVR"""
+  out = []
+  pos = 0
+  for m in CONVERSION.finditer(fmt):
+    out.append(fmt[pos:m.start()])
+    pos = m.end()
+    flags, width, prec, length, conv = m.groups()
+    if conv == "%":
+      out.append("%")
+      continue
+    if conv in "feEgG":
+      code = "<f"
+    elif length in ("l", "ll"):
+      code = "<l" if conv in "di" else "<L"
+    else:
+      code = "<h" if conv in "di" else "<H"
+    size = struct.calcsize(code)
+    if len(args) < size:
+      out.append("<?>")
+      continue
+    value, = struct.unpack_from(code, args)
+    args = args[size:]
+    if conv == "s":
+      out.append("<str 0x%04x>" % value)
+    elif conv == "p":
+      out.append("0x%04x" % value)
+    else:
+      spec = "%" + flags + width + ("." + prec if prec else "") + ("d" if conv in "iu" else conv)
+      out.append(spec % (chr(value & 0xFF) if conv == "c" else value))
+  out.append(fmt[pos:])
+  return "".join(out)
+
+
+def cobs_frames(stream):
+  """Yields the decoded frames (type, data) with a correct CRC"""
+  buf = bytearray()
+  while True:
+    chunk = stream.read(256)
+    if not chunk:
+      return
+    for c in chunk:
+      if c != 0:
+        buf.append(c)
+        continue
+      raw = bytearray()
+      i = 0
+      while i < len(buf):
+        code = buf[i]
+        raw += buf[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(buf):
+          raw.append(0)
+      buf = bytearray()
+      if len(raw) < 4 or raw[1] != len(raw) - 4 or crc16(raw) != 0:
+        continue
+      yield raw[0], bytes(raw[2:-2])
+
+
+def crc16(data):
+  crc = 0xFFFF
+  for b in data:
+    crc ^= b << 8
+    for _ in range(8):
+      crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+      crc &= 0xFFFF
+  return crc
+
+
+def open_port(path, baud):
+  if path == "-":
+    return sys.stdin.buffer
+  f = open(path, "rb", buffering=0)
+  if os.isatty(f.fileno()):
+    import termios
+    import tty
+    tty.setraw(f.fileno())
+    attr = termios.tcgetattr(f.fileno())
+    speed = getattr(termios, "B%d" % baud)
+    attr[4] = attr[5] = speed
+    termios.tcsetattr(f.fileno(), termios.TCSANOW, attr)
+  return f
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Prints the deferred log records of serialF0/logF0.c as text")
+  parser.add_argument("-b", type=int, default=115200, help="baud rate (default 115200)")
+  parser.add_argument("-v", action="store_true", help="also print the other messages")
+  parser.add_argument("elf")
+  parser.add_argument("port")
+  args = parser.parse_args()
+
+  flash = read_flash(args.elf)
+  for ftype, data in cobs_frames(open_port(args.port, args.b)):
+    if ftype == FRAME_LOG and len(data) >= 2:
+      fid, = struct.unpack_from("<H", data)
+      if fid == LOG_ID_DROPPED:
+        print("<%d records dropped>" % struct.unpack_from("<H", data, 2))
+        continue
+      fmt = format_string(flash, fid)
+      if fmt is None:
+        print("<unknown format 0x%04x: %s>" % (fid, data[2:].hex()))
+      else:
+        print(format_record(fmt, data[2:]))
+    elif ftype == FRAME_SERIAL_ERRORS and len(data) == 9:
+      print("<serial %02X: dropped %d, overrun %d, framing %d, parity %d>" % ((data[0],) + struct.unpack(">4H", data[1:])))
+    elif args.v:
+      print("<message 0x%02x: %s>" % (ftype, data.hex()))
+    sys.stdout.flush()
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,394 @@
+/*!
+ *  \file    serialF0_host_test.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Tests and benchmarks of serialF0 on the PC
+ *
+ *  \details The unmodified driver (serialF0.c, serial_template.c and serial.c)
+ *           runs on Linux with the shim of avr_host/: USARTF0 is connected to
+ *           a socketpair and the ISRs interrupt the program like on the Xmega,
+ *           at the baud rate of the USART. Compile and run:
+ *  \verbatim
+    gcc -O2 -pthread -Iavr_host -I../serialF0 -o serialF0_host_test serialF0_host_test.c \
+        avr_host/avr_host.c ../serialF0/serialF0.c ../serialF0/serial.c
+    ./serialF0_host_test          run the tests, the exit status is the number of failures
+    ./serialF0_host_test -p       USARTF0 on a pty: echo the characters like serialF0_test.c \endverbatim
+ *           The tests check the streams (printf, getline), uartF0_readline(),
+ *           the throughput of receiving and sending at several baud rates, the
+ *           latency of a received byte and the counting of lost bytes: dropped
+ *           with a full RX buffer and overrun in the USART with the interrupts
+ *           disabled.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+
+#include "avr_host.h"
+#include "serialF0.h"
+
+#define F_CPU     32000000UL             //!<  Clock frequency of the program
+
+//! Checks a condition, a failure is printed and counted
+#define CHECK(cond)                                                                   \
+  do { checks++;                                                                      \
+       if ( !(cond) ) { failures++; host_printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); } \
+  } while (0)
+
+static int          checks, failures;
+static uart_host_t  uart;                //!<  USARTF0 on the line
+static int          line;                //!<  the other side of the line
+
+/*! \brief  Waits until the USART has received or sent a number of bytes
+ *
+ *  \param  count   the counter of the USART, uart.rx_count or uart.tx_count
+ *  \param  n       the number of bytes
+ *  \param  ms      timeout
+ *
+ *  \return 1 if the number is reached, 0 after the timeout
+ */
+static int wait_count(atomic_ulong *count, unsigned long n, unsigned ms)
+{
+  uint64_t end = uart_host_ns() + (uint64_t) ms * 1000000;
+
+  while ( atomic_load(count) < n ) {
+    if ( uart_host_ns() > end ) return 0;
+    usleep(100);
+  }
+  return 1;
+}
+
+/*! \brief  Reads bytes on the other side of the line
+ *
+ *  \param  buf     buffer
+ *  \param  n       the number of bytes
+ *  \param  ms      timeout
+ *
+ *  \return the number of bytes read
+ */
+static size_t line_read(uint8_t *buf, size_t n, int ms)
+{
+  struct pollfd pfd = { line, POLLIN, 0 };
+  uint64_t end = uart_host_ns() + (uint64_t) ms * 1000000;
+  size_t   len = 0;
+  ssize_t  k;
+
+  while ( len < n ) {                    // poll() is interrupted by the ISRs
+    if ( poll(&pfd, 1, 1) > 0 ) {
+      if ( (k = read(line, buf + len, n - len)) <= 0 ) break;
+      len += k;
+    } else if ( uart_host_ns() >= end ) {
+      break;
+    }
+  }
+  return len;
+}
+
+/*! \brief  Sets the baud rate and clears the buffers and the counters
+ *
+ *  \param  baud    the baud rate
+ *
+ *  \return the actual baud rate of the USART
+ */
+static double set_baud(uint32_t baud)
+{
+  serial_errors_t errors;
+  uint8_t         buf[64];
+
+  while ( uartF0_tx_busy() ) ;
+  usleep(5000);                          // the last 2 bytes in the USART, at least 9600 baud
+  while ( uartF0_read(buf, sizeof(buf)) ) ;
+  while ( line_read(buf, sizeof(buf), 0) ) ;
+  init_stream_setup(serial_baud(F_CPU, baud));
+  uartF0_errors(&errors, 1);
+  atomic_store(&uart.lost, 0);
+
+  return uart_host_baud(&uart);
+}
+
+/*! \brief  Tests printf, puts and getline on the standard streams
+ *
+ *  \return void
+ */
+static void test_stream(void)
+{
+  char    buf[32];
+  uint8_t rx[32];
+  size_t  n;
+
+  set_baud(BAUD_115K2);
+
+  printf("value %d\n", 42);
+  n = line_read(rx, 10, 100);
+  CHECK(n == 10 && memcmp(rx, "value 42\r\n", 10) == 0);
+
+  write(line, "hello world\r\n", 13);     // getline() waits a short time for the LF
+  wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 13, 100);
+  getline(buf, sizeof(buf));
+  CHECK(strcmp(buf, "hello world") == 0);
+
+  write(line, "x\ry\n", 4);                // CR alone, the next character is put back
+  wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 4, 100);
+  getline(buf, sizeof(buf));
+  CHECK(strcmp(buf, "x") == 0);
+  getline(buf, sizeof(buf));
+  CHECK(strcmp(buf, "y") == 0);
+}
+
+/*! \brief  Tests uartF0_readline() with a line in parts
+ *
+ *  \return void
+ */
+static void test_readline(void)
+{
+  line_t   l;
+  char     buf[16];
+  uint8_t  res;
+  uint16_t tick = 0;                     // ms, the polls below are set apart in ticks
+
+  set_baud(BAUD_115K2);
+  line_init(&l, buf, sizeof(buf));
+
+  write(line, "abc", 3);
+  wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 3, 100);
+  CHECK(uartF0_readline(&l, tick) == LINE_PARTIAL);
+  write(line, "def\r\n", 5);
+  while ( (res = uartF0_readline(&l, tick)) == LINE_PARTIAL ) usleep(10);
+  CHECK(res == LINE_READY && strcmp(buf, "abcdef") == 0);
+
+  write(line, "0123456789abcdefgh\n", 19);
+  while ( (res = uartF0_readline(&l, tick)) == LINE_PARTIAL ) usleep(10);
+  CHECK(res == LINE_OVERFLOW && strlen(buf) == sizeof(buf) - 1);
+
+  // a CRLF that is received before the poll: the LF is not an empty line
+  write(line, "gh\r\n", 4);
+  wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 4, 100);
+  CHECK(uartF0_readline(&l, tick) == LINE_READY && strcmp(buf, "gh") == 0);
+  tick += 1000;
+  CHECK(uartF0_readline(&l, tick) == LINE_PARTIAL && buf[0] == '\0');
+
+  // the LF of a CRLF later, within LINE_CRLF_TICKS and after it
+  write(line, "ij\r", 3);
+  while ( (res = uartF0_readline(&l, tick)) == LINE_PARTIAL ) usleep(10);
+  CHECK(res == LINE_READY && strcmp(buf, "ij") == 0);
+  write(line, "\n", 1);
+  wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 1, 100);
+  CHECK(uartF0_readline(&l, tick + LINE_CRLF_TICKS) == LINE_PARTIAL);
+  write(line, "kl\r", 3);
+  while ( (res = uartF0_readline(&l, tick)) == LINE_PARTIAL ) usleep(10);
+  CHECK(res == LINE_READY && strcmp(buf, "kl") == 0);
+  write(line, "\n", 1);
+  wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 1, 100);
+  CHECK(uartF0_readline(&l, tick + LINE_CRLF_TICKS + 1) == LINE_READY && buf[0] == '\0');
+}
+
+/*! \brief  Measures the throughput of receiving and sending at a baud rate
+ *
+ *  \param  baud    the baud rate
+ *
+ *  \details The other side sends a block at once, the program reads it with
+ *           uartF0_read(). The program sends a block with uartF0_write(). The
+ *           block is sent in 0.25 s. The throughput is compared with the line
+ *           (10 bits per byte). A received byte is read or, if the program is
+ *           too slow on this host, counted as dropped.
+ *
+ *  \return void
+ */
+static void test_throughput(uint32_t baud)
+{
+  double   actual = set_baud(baud);
+  size_t   n = baud / 40, len = 0, got, i;
+  ssize_t  k;
+  uint8_t *tx = malloc(n), *rx = malloc(n);
+  uint64_t t0;
+  double   t_rx, t_tx, line_rate = actual / 10;
+  unsigned long sent = atomic_load(&uart.tx_count), received = atomic_load(&uart.rx_count);
+  serial_errors_t errors;
+  int      ok, done;
+
+  for (i = 0; i < n; i++) tx[i] = i * 7;
+
+  t0  = uart_host_ns();
+  write(line, tx, n);
+  do {                                   // a slow host can't always empty the buffer in time
+    done = ( atomic_load(&uart.rx_count) == received + n &&
+             atomic_load(&uart.rx_rd) == atomic_load(&uart.rx_wr) );
+    k = uartF0_read(rx + len, n - len > 255 ? 255 : n - len);
+    len += k;
+  } while ( len < n && !(done && k == 0) && uart_host_ns() - t0 < 2000000000u );
+  t_rx = (uart_host_ns() - t0) / 1e9;
+  uartF0_errors(&errors, 1);
+  CHECK(len + errors.dropped == n && (errors.dropped || memcmp(tx, rx, n) == 0));
+
+  t0 = uart_host_ns();
+  for (len = 0, got = 0; len < n; ) {    // the other side reads, the socket holds few writes of 1 byte
+    len += uartF0_write(tx + len, n - len > 255 ? 255 : n - len);
+    if ( (k = recv(line, rx + got, n - got, MSG_DONTWAIT)) > 0 ) got += k;
+  }
+  ok = wait_count(&uart.tx_count, sent + n, 2000);
+  t_tx = (uart_host_ns() - t0) / 1e9;
+  got += line_read(rx + got, n - got, 100);
+  CHECK(ok && got == n && memcmp(tx, rx, n) == 0);
+
+  host_printf("%7lu baud (%9.1f)  rx %8.0f B/s %5.1f %% %5u dropped   tx %8.0f B/s %5.1f %%\n",
+              (unsigned long) baud, actual, n / t_rx, 100 * n / t_rx / line_rate,
+              errors.dropped, n / t_tx, 100 * n / t_tx / line_rate);
+  CHECK(n / t_rx < 1.02 * line_rate && n / t_tx < 1.02 * line_rate);   // a slow host is slower
+
+  free(tx);
+  free(rx);
+}
+
+/*! \brief  Measures the time from the start bit of a byte to uartF0_getc()
+ *
+ *  \details The minimum is the time of the byte on the line (10 bits), the
+ *           rest is the latency of the shim.
+ *
+ *  \return void
+ */
+static void test_latency(void)
+{
+  double   byte = 10e6 / set_baud(BAUD_115K2);
+  double   t, min = 1e9, max = 0, sum = 0;
+  uint64_t t0;
+  int      i, n = 200;
+
+  for (i = 0; i < n; i++) {
+    t0 = uart_host_ns();
+    write(line, "L", 1);
+    while ( uartF0_getc() == UART_NO_DATA ) ;
+    t = (uart_host_ns() - t0) / 1e3;
+    if ( t < min ) min = t;
+    if ( t > max ) max = t;
+    sum += t;
+  }
+
+  host_printf("latency at 115200: byte %.1f us, min %.1f us, mean %.1f us, max %.1f us\n",
+              byte, min, sum / n, max);
+  CHECK(min >= byte);
+}
+
+/*! \brief  Tests the counting of bytes that are dropped with a full RX buffer
+ *
+ *  \return void
+ */
+static void test_overflow(void)
+{
+  serial_errors_t errors;
+  uint8_t  tx[300], rx[300];
+  size_t   len = 0, i;
+
+  set_baud(BAUD_921K6);
+  for (i = 0; i < sizeof(tx); i++) tx[i] = i;
+
+  write(line, tx, sizeof(tx));
+  CHECK(wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + sizeof(tx), 1000));
+  while ( (i = uartF0_read(rx + len, 255)) ) len += i;     // n is a uint8_t
+  uartF0_errors(&errors, 1);
+
+  host_printf("overflow: sent %u, read %u, dropped %u, overrun %u\n",
+              (unsigned) sizeof(tx), (unsigned) len, errors.dropped, errors.overrun);
+  CHECK(len == RXBUF_DEPTH_F0 && memcmp(tx, rx, len) == 0);
+  CHECK(errors.dropped == sizeof(tx) - RXBUF_DEPTH_F0 && errors.overrun == 0);
+}
+
+/*! \brief  Tests the counting of bytes that are lost in the USART
+ *
+ *  \details With the interrupts disabled the USART keeps 2 bytes, the rest is
+ *           lost. The RXC ISR counts one overrun when it reads the next byte.
+ *
+ *  \return void
+ */
+static void test_overrun(void)
+{
+  serial_errors_t errors;
+  uint8_t  rx[32];
+  size_t   len;
+
+  set_baud(BAUD_921K6);
+
+  cli();
+  write(line, "0123456789", 10);
+  CHECK(wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 10, 100));
+  sei();
+  write(line, "A", 1);
+  CHECK(wait_count(&uart.rx_count, atomic_load(&uart.rx_count) + 1, 100));
+  usleep(1000);
+  len = uartF0_read(rx, sizeof(rx));
+  uartF0_errors(&errors, 1);
+
+  host_printf("overrun: sent 11 with 10 during cli(), read %u, lost in the USART %lu, overrun %u\n",
+              (unsigned) len, atomic_load(&uart.lost), errors.overrun);
+  CHECK(len == 3 && memcmp(rx, "01A", 3) == 0);
+  CHECK(atomic_load(&uart.lost) == 8 && errors.overrun == 1);
+}
+
+/*! \brief  USARTF0 on a pty, echoes the characters like serialF0_test.c
+ *
+ *  \return never
+ */
+static void run_pty(void)
+{
+  char     name[64];
+  uint16_t c;
+
+  if ( (line = uart_host_pty(name, sizeof(name))) < 0 ) {
+    perror("serialF0_host_test: pty");
+    exit(1);
+  }
+  UART_HOST_OPEN(&uart, F0, line, F_CPU);
+  init_stream(F_CPU);
+  sei();
+  host_printf("USARTF0 on %s at %.0f baud\n", name, uart_host_baud(&uart));
+
+  while (1) {
+    c = uartF0_getc();
+    if ( c == UART_NO_DATA ) {
+      usleep(100);
+      continue;
+    }
+    printf("Character: '%c' Hex: %#x\n", c, c);
+  }
+}
+
+/*! \brief  Runs the tests
+ *
+ *  \return the number of failures
+ */
+int main(int argc, char *argv[])
+{
+  static const uint32_t bauds[] = { BAUD_9K6, BAUD_38K4, BAUD_115K2, BAUD_460K8, BAUD_921K6 };
+  int    sv[2];
+  size_t i;
+
+  if ( argc > 1 && strcmp(argv[1], "-p") == 0 ) run_pty();
+
+  if ( socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0 ) {
+    perror("serialF0_host_test: socketpair");
+    return 1;
+  }
+  line = sv[1];
+  UART_HOST_OPEN(&uart, F0, sv[0], F_CPU);
+  init_stream(F_CPU);
+  sei();
+
+  test_stream();
+  test_readline();
+  for (i = 0; i < sizeof(bauds) / sizeof(bauds[0]); i++) test_throughput(bauds[i]);
+  test_latency();
+  test_overflow();
+  test_overrun();
+
+  uart_host_close(&uart);
+  host_printf("%d checks, %d failures\n", checks, failures);
+
+  return failures;
+}
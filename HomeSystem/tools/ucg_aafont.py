@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""Converts a TTF/OTF or BDF font to an anti-aliased font for ucg_aafont.c
+
+Usage:
+  ucg_aafont.py [-b 2|4] [-s size] [-S scale] [-r 32-126] [-n name] [-o file.c] font
+
+  -b  bits per pixel of the gray levels (2 or 4, default 4)
+  -s  pixel size of a TTF/OTF font (default 16), needs Pillow
+  -S  supersampling of a BDF font: the 1-bpp glyphs are reduced by this
+      factor, every gray level is the coverage of a scale x scale block
+      (default 1, a BDF font drawn at its own size)
+  -r  range(s) of encodings, e.g. 32-126,176 (default 32-126)
+  -n  name of the C array (default ucg_aafont_<font>)
+  -o  output file (default stdout)
+
+The format of the font data is described in ucglib/ucg_aafont.c.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+
+class Glyph:
+  """One glyph: gray levels (0..1) in rows, the box is relative to the
+  origin on the baseline"""
+  def __init__(self, encoding, width, height, xoffset, top, advance, pixels):
+    self.encoding = encoding
+    self.width    = width
+    self.height   = height
+    self.xoffset  = xoffset
+    self.top      = top
+    self.advance  = advance
+    self.pixels   = pixels
+
+
+def parse_ranges(text):
+  codes = []
+  for part in text.split(','):
+    if '-' in part:
+      lo, hi = part.split('-')
+      codes.extend(range(int(lo, 0), int(hi, 0) + 1))
+    else:
+      codes.append(int(part, 0))
+  return sorted(set(c for c in codes if 0 < c < 256))
+
+
+def load_ttf(path, size, codes):
+  try:
+    from PIL import Image, ImageDraw, ImageFont
+  except ImportError:
+    sys.exit("ucg_aafont: Pillow is needed for TTF/OTF fonts (pip install pillow)")
+
+  font = ImageFont.truetype(path, size)
+  ascent, descent = font.getmetrics()
+  glyphs = []
+  for code in codes:
+    ch = bytes([code]).decode('latin-1')
+    left, top, right, bottom = font.getbbox(ch, anchor='ls')
+    advance = int(round(font.getlength(ch)))
+    width, height = right - left, bottom - top
+    pixels = []
+    if width > 0 and height > 0:
+      img = Image.new('L', (width, height), 0)
+      ImageDraw.Draw(img).text((-left, -top), ch, font=font, fill=255, anchor='ls')
+      data = img.load()
+      pixels = [[data[x, y] / 255.0 for x in range(width)] for y in range(height)]
+    glyphs.append(Glyph(code, width, height, left, -top, advance, pixels))
+  return ascent, descent, glyphs
+
+
+def load_bdf(path, scale, codes):
+  ascent = descent = 0
+  glyphs = []
+  with open(path, encoding='latin-1') as f:
+    lines = iter(f.read().splitlines())
+  for line in lines:
+    if line.startswith('FONT_ASCENT'):
+      ascent = int(line.split()[1])
+    elif line.startswith('FONT_DESCENT'):
+      descent = int(line.split()[1])
+    elif line.startswith('STARTCHAR'):
+      code, advance, bbx, rows = -1, 0, (0, 0, 0, 0), []
+      for line in lines:
+        if line.startswith('ENCODING'):
+          code = int(line.split()[1])
+        elif line.startswith('DWIDTH'):
+          advance = int(line.split()[1])
+        elif line.startswith('BBX'):
+          bbx = tuple(int(v) for v in line.split()[1:5])
+        elif line.startswith('BITMAP'):
+          for line in lines:
+            if line.startswith('ENDCHAR'):
+              break
+            rows.append(line.strip())
+          break
+      if code not in codes:
+        continue
+      w, h, xo, yo = bbx
+      bits = [[(int(r, 16) >> (len(r) * 4 - 1 - x)) & 1 for x in range(w)] for r in rows[:h]]
+      glyphs.append(reduce_glyph(code, w, h, xo, yo + h, advance, bits, scale))
+  return (ascent + scale - 1) // scale, (descent + scale - 1) // scale, glyphs
+
+
+def reduce_glyph(code, w, h, xo, top, advance, bits, scale):
+  """Reduces a 1-bpp glyph by scale, the gray level is the coverage of a block.
+  The blocks are aligned on the origin, so the baseline stays on a row edge."""
+  x0, y0 = xo // scale, -(top // -scale)          # floor of x, ceil of top
+  x1, y1 = -((xo + w) // -scale), (top - h) // scale
+  width, height = max(x1 - x0, 0), max(y0 - y1, 0)
+  pixels = []
+  for row in range(height):
+    line = []
+    for col in range(width):
+      n = 0
+      for sy in range(scale):
+        by = (y0 - row) * scale - 1 - sy           # source row above the baseline
+        iy = top - 1 - by
+        if 0 <= iy < h:
+          for sx in range(scale):
+            ix = (x0 + col) * scale + sx - xo
+            if 0 <= ix < w:
+              n += bits[iy][ix]
+      line.append(n / float(scale * scale))
+    pixels.append(line)
+  return Glyph(code, width, height, x0, y0, int(round(advance / float(scale))), pixels)
+
+
+def trim(glyph, maxlevel):
+  """Quantizes the gray levels and removes empty rows and columns"""
+  rows = [[int(round(v * maxlevel)) for v in line] for line in glyph.pixels]
+  while rows and not any(rows[0]):
+    rows.pop(0)
+    glyph.top -= 1
+  while rows and not any(rows[-1]):
+    rows.pop()
+  while rows and not any(r[0] for r in rows):
+    rows = [r[1:] for r in rows]
+    glyph.xoffset += 1
+  while rows and not any(r[-1] for r in rows):
+    rows = [r[:-1] for r in rows]
+  glyph.pixels = rows
+  glyph.height = len(rows)
+  glyph.width = len(rows[0]) if rows else 0
+  if glyph.width == 0:
+    glyph.xoffset = glyph.top = 0
+
+
+def encode_glyph(glyph, bpp):
+  maxrun = 1 << (8 - bpp)
+  data = []
+  flat = [v for line in glyph.pixels for v in line]
+  i = 0
+  while i < len(flat):
+    run = 1
+    while i + run < len(flat) and flat[i + run] == flat[i] and run < maxrun:
+      run += 1
+    data.append(((run - 1) << bpp) | flat[i])
+    i += run
+  size = 8 + len(data)
+  if size > 0xffff:
+    sys.exit("ucg_aafont: glyph %d is too large" % glyph.encoding)
+  for v in (glyph.xoffset, glyph.top):
+    if not -128 <= v <= 127:
+      sys.exit("ucg_aafont: glyph %d is out of range" % glyph.encoding)
+  return [glyph.encoding, size >> 8, size & 0xff,
+          glyph.width, glyph.height, glyph.xoffset & 0xff, glyph.top & 0xff,
+          glyph.advance & 0xff] + data
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Converts a font to an anti-aliased ucglib font")
+  parser.add_argument('font')
+  parser.add_argument('-b', dest='bpp', type=int, choices=(2, 4), default=4)
+  parser.add_argument('-s', dest='size', type=int, default=16)
+  parser.add_argument('-S', dest='scale', type=int, default=1)
+  parser.add_argument('-r', dest='ranges', default='32-126')
+  parser.add_argument('-n', dest='name')
+  parser.add_argument('-o', dest='output')
+  args = parser.parse_args()
+
+  codes = parse_ranges(args.ranges)
+  base = os.path.splitext(os.path.basename(args.font))[0]
+  if args.font.lower().endswith('.bdf'):
+    ascent, descent, glyphs = load_bdf(args.font, args.scale, codes)
+    source = "%s, scale 1/%d" % (os.path.basename(args.font), args.scale)
+  else:
+    ascent, descent, glyphs = load_ttf(args.font, args.size, codes)
+    source = "%s, %d pixels" % (os.path.basename(args.font), args.size)
+  name = args.name or 'ucg_aafont_' + re.sub(r'\W', '_', base).lower()
+
+  maxlevel = (1 << args.bpp) - 1
+  data = [args.bpp, len(glyphs), ascent & 0xff, descent & 0xff]
+  for glyph in sorted(glyphs, key=lambda g: g.encoding):
+    trim(glyph, maxlevel)
+    data += encode_glyph(glyph, args.bpp)
+  data += [0, 0, 0]
+
+  out = open(args.output, 'w') if args.output else sys.stdout
+  out.write("/*\n  Anti-aliased font generated by ucg_aafont.py\n"
+            "  Source: %s\n  Bits per pixel: %d, glyphs: %d, size: %d bytes\n*/\n\n"
+            % (source, args.bpp, len(glyphs), len(data)))
+  out.write('#include "ucg.h"\n\n')
+  out.write("const ucg_fntpgm_uint8_t %s[%d] UCG_FONT_SECTION(\"%s\") = {\n" % (name, len(data), name))
+  for i in range(0, len(data), 16):
+    out.write("  " + ",".join("%3d" % v for v in data[i:i + 16]) + ",\n")
+  out.write("};\n")
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Converts PNG/PPM images to compressed bitmaps for ucg_DrawCBmp()
+
+Usage:
+  ucg_cbmp.py [-o file.c] [-c] image [image ...]
+
+  image   PNG or PPM image, the name of the array is ucg_cbmp_<name of the file>,
+          or name=image to choose the name of the array
+  -o      output file (default stdout)
+  -c      check: decode every bitmap again and compare it with the image
+
+The format is described in ucglib/ucg_cbmp.c. Colors are reduced to 6 bits per
+component (like the ST7735 in 18-bit mode), transparent pixels become black.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from ucg_image import read_image, write_c_array
+
+OP_INDEX, OP_DIFF, OP_LUMA, OP_RUN, OP_RGB, OP_LONG_RUN = 0x00, 0x40, 0x80, 0xc0, 0xfe, 0xff
+
+
+def index_of(px):
+  return (3 * px[0] + 5 * px[1] + 7 * px[2]) % 64
+
+
+def encode(width, height, pixels):
+  data = [width >> 8, width & 0xff, height >> 8, height & 0xff]
+  flat = [tuple(v >> 2 if a >= 128 else 0 for v in (r, g, b)) for row in pixels for (r, g, b, a) in row]
+  cache = [(0, 0, 0)] * 64
+  prev = (0, 0, 0)
+  run = 0
+
+  def flush_run(run):
+    while run > 0:
+      if run >= 63:
+        n = min(run, 318)
+        data.extend([OP_LONG_RUN, n - 63])
+      else:
+        n = run
+        data.append(OP_RUN | (n - 1))
+      run -= n
+
+  for px in flat:
+    if px == prev:
+      run += 1
+      continue
+    flush_run(run)
+    run = 0
+    i = index_of(px)
+    d = [((px[k] - prev[k] + 32) % 64) - 32 for k in range(3)]
+    if cache[i] == px:
+      data.append(OP_INDEX | i)
+    elif all(-2 <= v <= 1 for v in d):
+      data.append(OP_DIFF | ((d[0] + 2) << 4) | ((d[1] + 2) << 2) | (d[2] + 2))
+    elif -32 <= d[1] <= 31 and -8 <= d[0] - d[1] <= 7 and -8 <= d[2] - d[1] <= 7:
+      data.extend([OP_LUMA | (d[1] + 32), ((d[0] - d[1] + 8) << 4) | (d[2] - d[1] + 8)])
+    else:
+      data.extend([OP_RGB, px[0], px[1], px[2]])
+    cache[i] = px
+    prev = px
+  flush_run(run)
+  return data, flat
+
+
+def decode(data):
+  """Decodes like ucg_DrawCBmp(), returns the colors with 6 bits per component"""
+  width, height = (data[0] << 8) | data[1], (data[2] << 8) | data[3]
+  cache = [(0, 0, 0)] * 64
+  px, out, pos = (0, 0, 0), [], 4
+  while len(out) < width * height:
+    op = data[pos]
+    pos += 1
+    run = 0
+    if op == OP_RGB:
+      px = tuple(data[pos:pos + 3])
+      pos += 3
+    elif op == OP_LONG_RUN:
+      run = data[pos] + 63
+      pos += 1
+    elif op & 0xc0 == OP_INDEX:
+      px = cache[op]
+    elif op & 0xc0 == OP_DIFF:
+      px = (px[0] + ((op >> 4) & 3) - 2, px[1] + ((op >> 2) & 3) - 2, px[2] + (op & 3) - 2)
+    elif op & 0xc0 == OP_LUMA:
+      d, b = (op & 0x3f) - 32, data[pos]
+      pos += 1
+      px = (px[0] + d + (b >> 4) - 8, px[1] + d, px[2] + d + (b & 0x0f) - 8)
+    else:
+      run = (op & 0x3f) + 1
+    if run == 0:
+      px = tuple(v & 0x3f for v in px)
+      cache[index_of(px)] = px
+      run = 1
+    out.extend([px] * run)
+  return out[:width * height]
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Converts images to compressed bitmaps for ucg_DrawCBmp()")
+  parser.add_argument('images', nargs='+')
+  parser.add_argument('-o', dest='output')
+  parser.add_argument('-c', dest='check', action='store_true')
+  args = parser.parse_args()
+
+  out = open(args.output, 'w') if args.output else sys.stdout
+  out.write("/*\n  Compressed bitmaps generated by ucg_cbmp.py\n*/\n\n#include \"ucg.h\"\n")
+  for arg in args.images:
+    name, _, path = arg.rpartition('=')
+    if not name:
+      name = 'ucg_cbmp_' + re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0]).lower()
+    width, height, pixels = read_image(path)
+    if width > 0xffff or height > 0xffff:
+      sys.exit("ucg_cbmp: %s is too large" % path)
+    data, flat = encode(width, height, pixels)
+    if args.check and decode(data) != flat:
+      sys.exit("ucg_cbmp: %s is not decoded correctly" % path)
+    raw = width * height * 3
+    write_c_array(out, name, data, "%s: %d x %d, %d bytes (raw %d bytes, %.1fx)"
+                  % (os.path.basename(path), width, height, len(data), raw, raw / float(len(data))))
+    sys.stderr.write("%s: %d bytes, raw %d bytes (%.1fx)\n" % (name, len(data), raw, raw / float(len(data))))
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,218 @@
+/*!
+ *  \file    ucg_host.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Host shim for ucglib: an emulated ST7735 (18-bit) on the PC
+ *
+ *  \details See ucg_host.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ucg_host.h"
+
+static void Pixel(ucg_host_t *lcd);
+static void Byte(ucg_host_t *lcd, uint8_t b);
+
+/*  \brief  Writes the current pixel at the address of the window and
+ *          moves the address, like the ST7735 with MV = 0
+ *
+ *  \param  lcd     the emulated display
+ *
+ *  \return void
+ */
+static void Pixel(ucg_host_t *lcd)
+{
+  uint16_t x = ( lcd->madctl & 0x40 ) ? UCG_HOST_WIDTH  - 1 - lcd->col : lcd->col;
+  uint16_t y = ( lcd->madctl & 0x80 ) ? UCG_HOST_HEIGHT - 1 - lcd->row : lcd->row;
+
+  if ( x < UCG_HOST_WIDTH && y < UCG_HOST_HEIGHT ) {
+    memcpy(lcd->fb[y][x], lcd->px, 3);
+  }
+  lcd->pixels++;
+
+  if ( ++lcd->col > lcd->xe ) {
+    lcd->col = lcd->xs;
+    if ( ++lcd->row > lcd->ye ) lcd->row = lcd->ys;
+  }
+}
+
+/*  \brief  Receives a byte on the bus
+ *
+ *  \param  lcd     the emulated display
+ *  \param  b       the byte
+ *
+ *  \return void
+ */
+static void Byte(ucg_host_t *lcd, uint8_t b)
+{
+  lcd->bytes++;
+
+  if ( lcd->cd == 0 ) {                          // a command
+    lcd->cmd  = b;
+    lcd->narg = 0;
+    lcd->npx  = 0;
+    if ( b == 0x2C ) {
+      lcd->col = lcd->xs;
+      lcd->row = lcd->ys;
+      lcd->windows++;
+    }
+    return;
+  }
+
+  if ( lcd->cmd == 0x2C ) {                      // data of RAMWR: the pixels
+    lcd->px[lcd->npx++] = ( lcd->colmod == 0x05 ) ? b : b & 0xFC;   // 18-bit: the upper 6 bits
+    if ( lcd->colmod == 0x05 && lcd->npx == 2 ) {
+      uint16_t c = (lcd->px[0] << 8) | lcd->px[1];
+      lcd->px[0] = (c >> 8) & 0xF8;
+      lcd->px[1] = (c >> 3) & 0xFC;
+      lcd->px[2] = (c << 3) & 0xF8;
+      lcd->npx = 3;
+    }
+    if ( lcd->npx == 3 ) {
+      Pixel(lcd);
+      lcd->npx = 0;
+    }
+    return;
+  }
+
+  if ( lcd->narg < sizeof(lcd->arg) ) lcd->arg[lcd->narg] = b;
+  lcd->narg++;
+  switch ( lcd->cmd ) {
+    case 0x2A:
+      if ( lcd->narg == 4 ) {
+        lcd->xs = (lcd->arg[0] << 8) | lcd->arg[1];
+        lcd->xe = (lcd->arg[2] << 8) | lcd->arg[3];
+      }
+      break;
+    case 0x2B:
+      if ( lcd->narg == 4 ) {
+        lcd->ys = (lcd->arg[0] << 8) | lcd->arg[1];
+        lcd->ye = (lcd->arg[2] << 8) | lcd->arg[3];
+      }
+      break;
+    case 0x36:
+      if ( lcd->narg == 1 ) lcd->madctl = b;
+      break;
+    case 0x3A:
+      if ( lcd->narg == 1 ) lcd->colmod = b & 0x07;
+      break;
+  }
+}
+
+/*! \brief  The com callback of the emulated ST7735
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  msg      number of the message (action to be done)
+ *  \param  arg      depends on msg: number of bytes, level of a line, ...
+ *  \param  data     pointer to the bytes that are sent
+ *
+ *  \return 1
+ */
+int16_t ucg_host_com(ucg_t *ucg, int16_t msg, uint16_t arg, uint8_t *data)
+{
+  ucg_host_t *lcd = ucg_GetUserPtr(ucg);
+
+  switch ( msg ) {
+    case UCG_COM_MSG_CHANGE_CD_LINE:
+      lcd->cd = arg;
+      break;
+    case UCG_COM_MSG_SEND_BYTE:
+      Byte(lcd, arg);
+      break;
+    case UCG_COM_MSG_REPEAT_1_BYTE:
+      while ( arg-- > 0 ) Byte(lcd, data[0]);
+      break;
+    case UCG_COM_MSG_REPEAT_2_BYTES:
+      while ( arg-- > 0 ) {
+        Byte(lcd, data[0]);
+        Byte(lcd, data[1]);
+      }
+      break;
+    case UCG_COM_MSG_REPEAT_3_BYTES:
+      while ( arg-- > 0 ) {
+        Byte(lcd, data[0]);
+        Byte(lcd, data[1]);
+        Byte(lcd, data[2]);
+      }
+      break;
+    case UCG_COM_MSG_SEND_STR:
+      while ( arg-- > 0 ) Byte(lcd, *data++);
+      break;
+    case UCG_COM_MSG_SEND_CD_DATA_SEQUENCE:
+      while ( arg-- > 0 ) {                      // pairs: 1 CD low, 2 CD high, 0 no change
+        if ( data[0] != 0 ) lcd->cd = ( data[0] == 1 ) ? 0 : 1;
+        Byte(lcd, data[1]);
+        data += 2;
+      }
+      break;
+  }
+
+  return 1;
+}
+
+/*! \brief  Initializes ucglib with an emulated ST7735 of 128x160 pixels
+ *
+ *          The frame buffer is black, the counters are 0 after the initialization.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  lcd      the emulated display
+ *
+ *  \return void
+ */
+void ucg_host_open(ucg_t *ucg, ucg_host_t *lcd)
+{
+  memset(lcd, 0, sizeof(*lcd));
+  lcd->colmod = 0x06;
+  lcd->xe     = UCG_HOST_WIDTH - 1;
+  lcd->ye     = UCG_HOST_HEIGHT - 1;
+
+  memset(ucg, 0, sizeof(*ucg));
+  ucg_SetUserPtr(ucg, lcd);
+  ucg_Init(ucg, ucg_dev_st7735_18x128x160, ucg_ext_st7735_18, ucg_host_com);
+
+  memset(lcd->fb, 0, sizeof(lcd->fb));
+  lcd->bytes   = 0;
+  lcd->pixels  = 0;
+  lcd->windows = 0;
+}
+
+/*! \brief  Fills the frame buffer with a color, without bytes on the bus
+ *
+ *  \param  lcd      the emulated display
+ *  \param  r        red
+ *  \param  g        green
+ *  \param  b        blue
+ *
+ *  \return void
+ */
+void ucg_host_fill(ucg_host_t *lcd, uint8_t r, uint8_t g, uint8_t b)
+{
+  uint16_t x, y;
+
+  for (y = 0; y < UCG_HOST_HEIGHT; y++) {
+    for (x = 0; x < UCG_HOST_WIDTH; x++) {
+      lcd->fb[y][x][0] = r;
+      lcd->fb[y][x][1] = g;
+      lcd->fb[y][x][2] = b;
+    }
+  }
+}
+
+/*! \brief  Saves the frame buffer as a PPM image, e.g. to look at a failed test
+ *
+ *  \param  lcd      the emulated display
+ *  \param  name     name of the file
+ *
+ *  \return void
+ */
+void ucg_host_save(ucg_host_t *lcd, const char *name)
+{
+  FILE *fp = fopen(name, "wb");
+
+  if ( fp == NULL ) return;
+  fprintf(fp, "P6\n%d %d\n255\n", UCG_HOST_WIDTH, UCG_HOST_HEIGHT);
+  fwrite(lcd->fb, 1, sizeof(lcd->fb), fp);
+  fclose(fp);
+}
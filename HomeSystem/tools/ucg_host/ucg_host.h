@@ -0,0 +1,60 @@
+/*!
+ *  \file    ucg_host.h
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Host shim for ucglib: an emulated ST7735 (18-bit) on the PC
+ *
+ *  \details The drivers of ucglib/ are compiled unmodified for Linux (with
+ *           -D__memx=). The com callback ucg_host_com() plays the SPI bus and
+ *           the ST7735 controller: it decodes the commands CASET (0x2A),
+ *           RASET (0x2B), RAMWR (0x2C), MADCTL (0x36) and COLMOD (0x3A) and
+ *           writes the pixels in a frame buffer of 128x160 pixels. It counts
+ *           the bytes on the bus, so the tests can compare the bytes that a
+ *           drawing function sends:
+ *  \code
+    ucg_t      ucg;
+    ucg_host_t lcd;
+
+    ucg_host_open(&ucg, &lcd);            // ucg_Init() with ucg_dev_st7735_18x128x160
+    lcd.bytes = 0;
+    ucg_DrawBox(&ucg, 0, 0, 10, 10);
+    // lcd.bytes is the number of bytes on the bus, lcd.fb[y][x] the pixels \endcode
+ *           The emulation uses the user pointer of ucg_t. Only the address
+ *           modes of MADCTL that ucglib uses are emulated: mirrored columns
+ *           (MX) and rows (MY), not the exchange of rows and columns (MV).
+ */
+
+#ifndef UCG_HOST_H_
+#define UCG_HOST_H_
+
+#include <stdint.h>
+#include "ucg.h"
+
+#define UCG_HOST_WIDTH    128      //!<  width of the ST7735
+#define UCG_HOST_HEIGHT   160      //!<  height of the ST7735
+
+//! An emulated ST7735
+typedef struct {
+  uint8_t   fb[UCG_HOST_HEIGHT][UCG_HOST_WIDTH][3];   //!<  the pixels (red, green, blue)
+  uint32_t  bytes;                 //!<  bytes on the bus (commands and data)
+  uint32_t  pixels;                //!<  pixels written with RAMWR
+  uint32_t  windows;               //!<  number of RAMWR commands
+  uint8_t   cd;                    //!<  level of the CD line: 0 command, 1 data
+  uint8_t   cmd;                   //!<  current command
+  uint8_t   arg[4];                //!<  arguments of the current command
+  uint8_t   narg;                  //!<  number of received arguments
+  uint8_t   madctl;                //!<  memory access control
+  uint8_t   colmod;                //!<  pixel format: 0x05 16-bit, 0x06 18-bit
+  uint16_t  xs, xe, ys, ye;        //!<  the window
+  uint16_t  col, row;              //!<  address of the next pixel
+  uint8_t   px[3];                 //!<  bytes of the current pixel
+  uint8_t   npx;                   //!<  number of bytes of the current pixel
+} ucg_host_t;
+
+int16_t   ucg_host_com(ucg_t *ucg, int16_t msg, uint16_t arg, uint8_t *data);
+void      ucg_host_open(ucg_t *ucg, ucg_host_t *lcd);
+void      ucg_host_fill(ucg_host_t *lcd, uint8_t r, uint8_t g, uint8_t b);
+void      ucg_host_save(ucg_host_t *lcd, const char *name);
+
+#endif // UCG_HOST_H_
@@ -0,0 +1,1039 @@
+/*!
+ *  \file    ucg_host_test.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Tests of the additions to ucglib on the PC
+ *
+ *  \details The unmodified ucglib/ draws on an emulated ST7735 (ucg_host/), the
+ *           tests compare the frame buffer and the bytes on the bus with the
+ *           expected values. The bitmaps are generated by ucg_ibmp.py from the
+ *           images in ucg_host/images/. Compile and run (in tools/):
+ *  \verbatim
+    python3 ucg_ibmp.py -c -o ucg_host_images.c mono=ucg_host/images/mono.ppm \
+        four=ucg_host/images/four.ppm sixteen=ucg_host/images/sixteen.png many=ucg_host/images/many.ppm \
+        tiles=ucg_host/images/tiles.png
+    gcc -O2 -D__memx= -I../ucglib -Iucg_host -o ucg_host_test ucg_host_test.c ucg_host_images.c \
+        ucg_host/ucg_host.c ../ucglib/ucg*.c -lz
+    ./ucg_host_test               run the tests, the exit status is the number of failures \endverbatim
+ *           The tests check:
+ *           - indexed-color bitmaps (ucg_DrawIBmp()): the output of ucg_ibmp.py is
+ *             drawn in all directions, with and without clipping, and compared
+ *             with the source image
+ *           - tile maps (ucg_DrawTileMap()): the pixels and the bytes on the bus of
+ *             the full map, of changed tiles and of sprites, with a strip buffer and
+ *             with dirty rectangles. The bytes and the time of an update are printed.
+ *           - display lists: the bytes of the items, the dirty rectangles of
+ *             ucg_DiffDList() and the updates with ucg_FlushDirty(), which must give
+ *             the picture of a full redraw (directly and with a strip buffer)
+ *           - the strip buffer (ucg_SetStrip()): the pictures in all rotations (below
+ *             and above the strip) and clip ranges, compared with direct drawing
+ *           - the alpha blending of the strip buffer (ucg_SetAlpha()), compared
+ *             with a blending in float
+ *           - the dirty rectangles (ucg_MarkDirty()): merging, clipping to the display
+ *             and the statistics of ucg_FlushDirty()
+ *           - the conversions of ucg_Print() (%%, fixed-point, unknown conversions)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "ucg_host.h"
+
+//! Checks a condition, a failure is printed and counted
+#define CHECK(cond)                                                                   \
+  do { checks++;                                                                      \
+       if ( !(cond) ) { failures++; printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); } \
+  } while (0)
+
+#define IMAGE_MAX   128                  //!<  maximal width and height of a test image
+
+//! An image with alpha
+typedef struct {
+  int       w, h;                        //!<  width and height
+  uint8_t   px[IMAGE_MAX][IMAGE_MAX][4]; //!<  the pixels (red, green, blue, alpha)
+} image_t;
+
+//! The expected content of the display
+typedef uint8_t frame_t[UCG_HOST_HEIGHT][UCG_HOST_WIDTH][3];
+
+extern const uint8_t mono[], four[], sixteen[], many[], tiles[];
+
+static int          checks, failures;
+static ucg_t        ucg;
+static ucg_host_t   lcd;
+static frame_t      expect;
+
+/*  brief   Reads a PPM (P6) or PNG (8 bit RGB or RGBA, not interlaced) image
+ *
+ *  param   name    name of the file
+ *  param   img     the image
+ *
+ *  return  1 if the image is read, 0 otherwise
+ */
+static int read_image(const char *name, image_t *img)
+{
+  static uint8_t  file[65536], idat[sizeof(file)], raw[IMAGE_MAX * (IMAGE_MAX * 4 + 1)];
+  uint8_t   *line, *prev;
+  uLongf    nraw = sizeof(raw);
+  size_t    n, pos, nidat = 0;
+  int       maxval, ch = 0, x, y, i, a, b, c, p;
+  FILE      *fp = fopen(name, "rb");
+
+  if ( fp == NULL ) return 0;
+  n = fread(file, 1, sizeof(file), fp);
+  fclose(fp);
+
+  if ( memcmp(file, "P6", 2) == 0 ) {
+    if ( sscanf((char *) file, "P6 %d %d %d%n", &img->w, &img->h, &maxval, &i) != 3 ) return 0;
+    if ( img->w > IMAGE_MAX || img->h > IMAGE_MAX || maxval != 255 ) return 0;
+    pos = i + 1;
+    for (y = 0; y < img->h; y++) {
+      for (x = 0; x < img->w; x++, pos += 3) {
+        memcpy(img->px[y][x], file + pos, 3);
+        img->px[y][x][3] = 255;
+      }
+    }
+    return pos <= n;
+  }
+
+  if ( memcmp(file, "\x89PNG\r\n\x1a\n", 8) != 0 ) return 0;
+  for (pos = 8; pos + 12 <= n; pos += 12 + (size_t) i) {
+    i = (file[pos] << 24) | (file[pos+1] << 16) | (file[pos+2] << 8) | file[pos+3];
+    if ( memcmp(file + pos + 4, "IHDR", 4) == 0 ) {
+      img->w = (file[pos+10] << 8) | file[pos+11];
+      img->h = (file[pos+14] << 8) | file[pos+15];
+      if ( file[pos+16] != 8 || file[pos+20] != 0 ) return 0;
+      ch = ( file[pos+17] == 6 ) ? 4 : ( file[pos+17] == 2 ) ? 3 : 0;
+    } else if ( memcmp(file + pos + 4, "IDAT", 4) == 0 ) {
+      memcpy(idat + nidat, file + pos + 8, i);
+      nidat += i;
+    }
+  }
+  if ( ch == 0 || img->w > IMAGE_MAX || img->h > IMAGE_MAX ) return 0;
+  if ( uncompress(raw, &nraw, idat, nidat) != Z_OK ) return 0;
+
+  prev = NULL;
+  for (y = 0; y < img->h; y++) {
+    line = raw + y * (img->w * ch + 1);
+    for (i = 1; i <= img->w * ch; i++) {         // undo the filter of the line
+      a = ( i > ch ) ? line[i - ch] : 0;
+      b = prev ? prev[i] : 0;
+      c = ( prev && i > ch ) ? prev[i - ch] : 0;
+      p = a + b - c;
+      switch ( line[0] ) {
+        case 1: line[i] += a; break;
+        case 2: line[i] += b; break;
+        case 3: line[i] += (a + b) / 2; break;
+        case 4: line[i] += ( abs(p-a) <= abs(p-b) && abs(p-a) <= abs(p-c) ) ? a : ( abs(p-b) <= abs(p-c) ) ? b : c; break;
+      }
+    }
+    for (x = 0; x < img->w; x++) {
+      memcpy(img->px[y][x], line + 1 + x * ch, 3);
+      img->px[y][x][3] = ( ch == 4 ) ? line[1 + x * ch + 3] : 255;
+    }
+    prev = line;
+  }
+  return 1;
+}
+
+/*  brief   Clears the display and the expected content
+ *
+ *  return  void
+ */
+static void clear(void)
+{
+  ucg_host_fill(&lcd, 4, 8, 12);           // a color that is not in the images, see expect_only()
+  memcpy(expect, lcd.fb, sizeof(expect));
+  lcd.bytes   = 0;
+  lcd.pixels  = 0;
+  lcd.windows = 0;
+}
+
+/*  brief   Sets a pixel of the expected content, if it is in the clip box
+ *          and on the display
+ *
+ *  param   x       the x-position
+ *  param   y       the y-position
+ *  param   rgb     the color
+ *  param   clip    the clip box
+ *
+ *  return  1 if the pixel is visible, 0 otherwise
+ */
+static int expect_pixel(int x, int y, const uint8_t *rgb, const ucg_box_t *clip)
+{
+  if ( x < 0 || x >= UCG_HOST_WIDTH || y < 0 || y >= UCG_HOST_HEIGHT ) return 0;
+  if ( x < clip->ul.x || x >= clip->ul.x + clip->size.w ) return 0;
+  if ( y < clip->ul.y || y >= clip->ul.y + clip->size.h ) return 0;
+  memcpy(expect[y][x], rgb, 3);
+  return 1;
+}
+
+/*  brief   Tests an indexed-color bitmap: ucg_DrawIBmp() in all directions
+ *          with and without clipping, compared with the source image
+ *
+ *  param   ibmp    the bitmap, generated by ucg_ibmp.py
+ *  param   name    name of the source image
+ *
+ *  return  void
+ */
+static void test_ibmp_image(const uint8_t *ibmp, const char *name)
+{
+  static image_t img;
+  ucg_box_t box, clip;
+  uint8_t   rgb[3];
+  int       dir, k, r, c, x, y, px, py, visible, opaque;
+
+  CHECK(read_image(name, &img));
+  CHECK(((ibmp[0] << 8) | ibmp[1]) == img.w && ((ibmp[2] << 8) | ibmp[3]) == img.h);
+  opaque = !(ibmp[5] & 1);
+
+  for (k = 0; k < 3; k++) {
+    for (dir = 0; dir < 4; dir++) {
+      // the box of the bitmap on the display: k = 2 is in the upper left corner,
+      // 3 columns and 2 rows are outside of the display
+      box.size.w = ( dir & 1 ) ? img.h : img.w;
+      box.size.h = ( dir & 1 ) ? img.w : img.h;
+      box.ul.x   = ( k == 2 ) ? -3 : 47;
+      box.ul.y   = ( k == 2 ) ? -2 : 30;
+      x = box.ul.x + ( ( dir == 2 || dir == 3 ) ? box.size.w : 0 ) - ( dir == 3 );
+      y = box.ul.y + ( ( dir == 1 || dir == 2 ) ? box.size.h : 0 );
+
+      // k = 1: the clip box cuts every side of the bitmap, it must be on the
+      // display (like the rectangles of ucg_MarkDirty())
+      clip.ul.x   = ( k == 1 ) ? box.ul.x + 2 : 0;
+      clip.ul.y   = ( k == 1 ) ? box.ul.y + 1 : 0;
+      clip.size.w = ( k == 1 ) ? box.size.w - 3 : UCG_HOST_WIDTH;
+      clip.size.h = ( k == 1 ) ? box.size.h - 2 : UCG_HOST_HEIGHT;
+      if ( clip.ul.x + clip.size.w > UCG_HOST_WIDTH ) clip.size.w = UCG_HOST_WIDTH - clip.ul.x;
+      if ( clip.ul.y + clip.size.h > UCG_HOST_HEIGHT ) clip.size.h = UCG_HOST_HEIGHT - clip.ul.y;
+
+      clear();
+      ucg_SetClipRange(&ucg, clip.ul.x, clip.ul.y, clip.size.w, clip.size.h);
+      ucg_DrawIBmp(&ucg, x, y, dir, ibmp);
+      ucg_SetMaxClipRange(&ucg);
+
+      visible = 0;
+      for (r = 0; r < img.h; r++) {
+        for (c = 0; c < img.w; c++) {
+          if ( img.px[r][c][3] < 128 ) continue; // transparent
+          switch ( dir ) {
+            case 0:  px = x + c;     py = y + r;     break;
+            case 1:  px = x + r;     py = y - 1 - c; break;
+            case 2:  px = x - 1 - c; py = y - 1 - r; break;
+            default: px = x - r;     py = y + c;     break;
+          }
+          rgb[0] = img.px[r][c][0] & 0xFC;       // 6 bits per component
+          rgb[1] = img.px[r][c][1] & 0xFC;
+          rgb[2] = img.px[r][c][2] & 0xFC;
+          visible += expect_pixel(px, py, rgb, &clip);
+        }
+      }
+      if ( memcmp(lcd.fb, expect, sizeof(expect)) != 0 ) {
+        printf("%s: dir %d, clip %d differs, see ucg_host_fail.ppm\n", name, dir, k);
+        ucg_host_save(&lcd, "ucg_host_fail.ppm");
+      }
+      CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+      // only the visible pixels are sent, with one window for an opaque bitmap in dir 0 and 2
+      CHECK(lcd.pixels == (uint32_t) visible);
+      if ( opaque && (dir & 1) == 0 ) CHECK(lcd.windows == 1);
+    }
+  }
+}
+
+/*  brief   Tests the indexed-color bitmaps of 1, 2, 4 and 8 bits per pixel
+ *
+ *  return  void
+ */
+static void test_ibmp(void)
+{
+  CHECK(mono[4] == 1 && four[4] == 2 && sixteen[4] == 4 && many[4] == 8);
+  CHECK((sixteen[5] & 1) && !(mono[5] & 1));     // with and without transparent pixels
+
+  test_ibmp_image(mono,    "ucg_host/images/mono.ppm");
+  test_ibmp_image(four,    "ucg_host/images/four.ppm");
+  test_ibmp_image(sixteen, "ucg_host/images/sixteen.png");
+  test_ibmp_image(many,    "ucg_host/images/many.ppm");
+  test_ibmp_image(tiles,   "ucg_host/images/tiles.png");    // black and transparent pixels
+}
+
+/*  brief   Converts a color like the strip buffer: RGB 565 and back, see
+ *          _ucg_strip_color() in ucg_strip.c
+ *
+ *  param   rgb     the color, converted in place
+ *
+ *  return  void
+ */
+static void strip_color(uint8_t *rgb)
+{
+  rgb[0] = ((rgb[0] & 0xF8) | (rgb[0] >> 5)) & 0xFC;
+  rgb[1] = rgb[1] & 0xFC;
+  rgb[2] = ((rgb[2] & 0xF8) | (rgb[2] >> 5)) & 0xFC;
+}
+
+/*  brief   Calculates the expected content of the display with a tile map
+ *          from the tile sheet image: the tiles, their attribute colors
+ *          and the sprites
+ *
+ *  param   tm      pointer to struct for the tile map
+ *  param   sheet   the image of the tile sheet
+ *  param   strip   1 if the colors are converted like the strip buffer
+ *
+ *  return  void
+ */
+static void expect_tilemap(ucg_tilemap_t *tm, const image_t *sheet, int strip)
+{
+  ucg_tile_t   *t;
+  ucg_sprite_t *sp;
+  const uint8_t *p;
+  uint8_t  rgb[3];
+  int      x, y, i, sx, sy;
+
+  for (y = 0; y < tm->rows * tm->th; y++) {
+    for (x = 0; x < tm->cols * tm->tw; x++) {
+      t = &tm->map[(y / tm->th) * tm->cols + x / tm->tw];
+      memcpy(rgb, tm->colors[t->attr], 3);
+      if ( t->index != UCG_TILE_NONE ) {
+        p = sheet->px[t->index * tm->th + y % tm->th][x % tm->tw];
+        if ( p[3] >= 128 ) memcpy(rgb, p, 3);
+      }
+      for (i = 0; i < UCG_TILE_SPRITES; i++) {   // the last sprite is on top
+        sp = &tm->sprite[i];
+        sx = x - sp->x;
+        sy = y - sp->y;
+        if ( sp->index == UCG_TILE_NONE || sx < 0 || sx >= tm->tw || sy < 0 || sy >= tm->th ) continue;
+        p = sheet->px[sp->index * tm->th + sy][sx];
+        if ( p[3] >= 128 ) memcpy(rgb, p, 3);
+      }
+      rgb[0] &= 0xFC;
+      rgb[1] &= 0xFC;
+      rgb[2] &= 0xFC;
+      if ( strip ) strip_color(rgb);
+      memcpy(expect[tm->y + y][tm->x + x], rgb, 3);
+    }
+  }
+}
+
+/*  brief   Sets the expected content outside of a rectangle to the color of clear()
+ *
+ *  param   x       the x-position of the rectangle
+ *  param   y       the y-position of the rectangle
+ *  param   w       the width of the rectangle
+ *  param   h       the height of the rectangle
+ *
+ *  return  void
+ */
+static void expect_only(int x, int y, int w, int h)
+{
+  static const uint8_t bg[3] = { 4, 8, 12 };
+  int  px, py;
+
+  for (py = 0; py < UCG_HOST_HEIGHT; py++) {
+    for (px = 0; px < UCG_HOST_WIDTH; px++) {
+      if ( px < x || px >= x + w || py < y || py >= y + h ) memcpy(expect[py][px], bg, 3);
+    }
+  }
+}
+
+/*  brief   Counts the changed tiles of a tile map
+ *
+ *  param   tm      pointer to struct for the tile map
+ *
+ *  return  the number of changed tiles
+ */
+static int dirty_tiles(ucg_tilemap_t *tm)
+{
+  int k, n = 0;
+
+  for (k = 0; k < tm->cols * tm->rows; k++) n += tm->map[k].dirty;
+  return n;
+}
+
+static ucg_tilemap_t  tm;                //!<  the tile map of test_tilemap()
+
+/*  brief   A bus that does nothing, to measure the time of the drawing functions
+ *
+ *  return  1
+ */
+static int16_t null_com(ucg_t *ucg, int16_t msg, uint16_t arg, uint8_t *data)
+{
+  return 1;
+}
+
+/*  brief   Draws the tile map, the draw function of ucg_FlushDirty()
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  void
+ */
+static void draw_tilemap(ucg_t *ucg)
+{
+  ucg_DrawTileMap(ucg, &tm);
+}
+
+/*  brief   Tests the tile maps (ucg_DrawTileMap()): the pixels and the bytes
+ *          on the bus of the full map, of changed tiles and of moved sprites,
+ *          with a strip buffer and with dirty rectangles
+ *
+ *  return  void
+ */
+static void test_tilemap(void)
+{
+  static image_t sheet;
+  static ucg_tile_t map[4 * 5];
+  static ucg_strip_t strip;
+  static uint8_t buf[UCG_STRIP_BUF_SIZE(UCG_HOST_WIDTH, 16)];
+  static ucg_dirty_t dirty;
+  const uint32_t window = 15;            // a window of a bitmap stream: MADCTL 2x 1+1, CASET 1+4, RASET 1+4, RAMWR 1
+  struct timespec t0, t1;
+  double   us[2];
+  uint32_t bytes_map, bytes_tile, bytes_sprite;
+  int      c, r, n, i, k;
+
+  CHECK(read_image("ucg_host/images/tiles.png", &sheet));
+
+  // a dashboard of 4x5 tiles of 32x32 pixels, the whole display
+  CHECK(ucg_InitTileMap(&tm, 0, 0, 4, 5, map, tiles, 32) && tm.count == 4);
+  ucg_SetTileColor(&tm, 0, 0, 0, 80);
+  ucg_SetTileColor(&tm, 1, 0, 160, 0);
+  ucg_SetTileColor(&tm, 2, 200, 120, 0);
+  ucg_SetTileColor(&tm, 3, 200, 0, 0);
+  for (r = 0; r < 5; r++) {
+    for (c = 0; c < 4; c++) {
+      ucg_SetTile(&tm, c, r, ( r == 4 && c == 3 ) ? UCG_TILE_NONE : (c + r) % 3, (c * 3 + r) % 4);
+    }
+  }
+
+  clear();
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 20);
+  expect_tilemap(&tm, &sheet, 0);
+  CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+  CHECK(lcd.windows == 5 && lcd.pixels == 128 * 160);   // one window per row of the map
+  CHECK(lcd.bytes == 3 * lcd.pixels + 5 * window);
+  bytes_map = lcd.bytes;
+
+  clear();
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 0 && lcd.bytes == 0);   // nothing changed
+
+  // one tile
+  clear();
+  ucg_SetTile(&tm, 2, 3, 0, 3);
+  ucg_SetTile(&tm, 1, 1, map[1 * 4 + 1].index, map[1 * 4 + 1].attr);    // the same values
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 1 && dirty_tiles(&tm) == 0);
+  CHECK(lcd.windows == 1 && lcd.pixels == 32 * 32 && lcd.bytes == 3 * 32 * 32 + window);
+  expect_tilemap(&tm, &sheet, 0);
+  expect_only(64, 96, 32, 32);
+  CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+  bytes_tile = lcd.bytes;
+
+  // the color of an attribute: all tiles with the attribute are drawn
+  for (i = n = 0; i < 20; i++) n += ( map[i].attr == 2 );
+  ucg_SetTileColor(&tm, 2, 240, 200, 0);
+  lcd.bytes = lcd.pixels = lcd.windows = 0;
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == n && lcd.pixels == (uint32_t) n * 32 * 32);
+
+  // a sprite: shown over 4 tiles, moved by one tile to the right (6 tiles) and hidden
+  ucg_SetSprite(&tm, 0, 40, 50, 3);
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 4);
+  ucg_SetSprite(&tm, 0, 72, 50, 3);
+  lcd.bytes = lcd.pixels = lcd.windows = 0;
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 6);
+  CHECK(lcd.windows == 2 && lcd.bytes == 3 * 6 * 32 * 32 + 2 * window);
+  bytes_sprite = lcd.bytes;
+  ucg_SetSprite(&tm, 1, 80, 60, 3);        // two sprites, the second one is on top
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 4);
+  ucg_host_fill(&lcd, 4, 8, 12);
+  ucg_InvalidateTileMap(&tm);
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 20);
+  expect_tilemap(&tm, &sheet, 0);
+  CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+  ucg_SetSprite(&tm, 0, 0, 0, UCG_TILE_NONE);
+  ucg_SetSprite(&tm, 1, 0, 0, UCG_TILE_NONE);
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 4);
+  expect_tilemap(&tm, &sheet, 0);
+  CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+
+  // a strip buffer: every strip draws the changed tiles, they are unchanged after the last strip
+  ucg_SetStrip(&ucg, &strip, buf, 16);
+  ucg_host_fill(&lcd, 4, 8, 12);
+  ucg_InvalidateTileMap(&tm);
+  ucg_FirstPage(&ucg);
+  n = 0;
+  do {
+    n += ucg_DrawTileMap(&ucg, &tm);
+    CHECK(dirty_tiles(&tm) == 20 || ucg.strip->y + 16 >= UCG_HOST_HEIGHT);
+  } while ( ucg_NextPage(&ucg) );
+  ucg_UndoStrip(&ucg);
+  CHECK(dirty_tiles(&tm) == 0);
+  expect_tilemap(&tm, &sheet, 1);
+  CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+
+  // dirty rectangles: a tile in two rectangles is drawn in both and stays
+  // changed, a tile in one rectangle is drawn once
+  ucg_host_fill(&lcd, 4, 8, 12);
+  ucg_InvalidateTileMap(&tm);
+  ucg_DrawTileMap(&ucg, &tm);
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_SetTile(&tm, 1, 1, 0, 2);
+  ucg_SetTile(&tm, 3, 0, 1, 1);
+  ucg_MarkDirty(&ucg, 32, 32, 16, 32);     // left half of tile (1,1)
+  ucg_MarkDirty(&ucg, 48, 32, 16, 128);    // right half of tile (1,1) and the tiles below
+  ucg_MarkDirty(&ucg, 96, 0, 32, 32);      // tile (3,0)
+  CHECK(dirty.cnt == 3);
+  ucg_FlushDirty(&ucg, draw_tilemap);
+  expect_tilemap(&tm, &sheet, 0);
+  CHECK(memcmp(lcd.fb, expect, sizeof(expect)) == 0);
+  CHECK(dirty_tiles(&tm) == 1 && tm.map[1 * 4 + 1].dirty && !tm.map[3].dirty);
+  CHECK(ucg_DrawTileMap(&ucg, &tm) == 1 && dirty_tiles(&tm) == 0);
+  ucg.dirty = NULL;
+
+  // the time of one changed tile, with the emulated display and with a bus that does nothing
+  for (k = 0; k < 2; k++) {
+    if ( k == 1 ) ucg.com_cb = null_com;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < 1000; i++) {
+      ucg_SetTile(&tm, 2, 3, i & 1, 3);
+      ucg_DrawTileMap(&ucg, &tm);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    us[k] = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1000 / 1e3;
+  }
+  ucg.com_cb = ucg_host_com;
+
+  printf("tile map 4x5 of 32x32: full map %u bytes, one tile %u bytes, sprite moved by a tile %u bytes\n"
+         "  one changed tile: %.1f us with the emulated display, %.1f us without\n",
+         bytes_map, bytes_tile, bytes_sprite, us[0], us[1]);
+}
+
+/*  brief   Builds the display list of a test page: a value with a bar
+ *
+ *  param   dl      pointer to struct for the display list
+ *  param   buf     the buffer of the list
+ *  param   size    the size of the buffer
+ *  param   value   the text of the value
+ *  param   bar     the width of the bar
+ *  param   line    1: a line is inserted before the value
+ *
+ *  return  void
+ */
+static void build_page(ucg_dlist_t *dl, uint8_t *buf, uint16_t size, const char *value, int bar, int line)
+{
+  ucg_InitDList(dl, buf, size);
+  ucg_DListColor(dl, 0, 0, 80);
+  ucg_DListBox(dl, 0, 0, 128, 160);
+  ucg_DListColor(dl, 255, 255, 255);
+  ucg_DListFrame(dl, 4, 4, 120, 40);
+  ucg_DListColor(dl, 60, 60, 60);
+  ucg_DListRBox(dl, 10, 50, 108, 20, 5);
+  ucg_DListColor(dl, 0, 200, 0);
+  ucg_DListBox(dl, 12, 52, bar, 16);
+  if ( line ) {
+    ucg_DListColor(dl, 255, 0, 0);
+    ucg_DListLine(dl, 0, 80, 127, 84);
+  }
+  ucg_DListColor(dl, 255, 255, 255);
+  ucg_DListText(dl, 10, 110, ucg_font_ncenR12_tr, value);
+  ucg_DListIBmp(dl, 20, 130, mono);
+}
+
+static const ucg_dlist_t *draw_dl;       //!<  the display list of draw_dlist()
+
+/*  brief   Draws the display list draw_dl, the draw function of ucg_FlushDirty()
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  void
+ */
+static void draw_dlist(ucg_t *ucg)
+{
+  ucg_DrawDList(ucg, draw_dl);
+}
+
+/*  brief   Draws a display list completely, with a strip buffer in a page loop
+ *
+ *  param   dl      pointer to struct for the display list
+ *
+ *  return  void
+ */
+static void draw_full(const ucg_dlist_t *dl)
+{
+  if ( ucg.strip == NULL ) {
+    ucg_DrawDList(&ucg, dl);
+    return;
+  }
+  ucg_FirstPage(&ucg);
+  do {
+    ucg_DrawDList(&ucg, dl);
+  } while ( ucg_NextPage(&ucg) );
+}
+
+/*  brief   Tests the update from one display list to the next: the dirty
+ *          rectangles of ucg_DiffDList() and the picture after ucg_FlushDirty(),
+ *          which must be the picture of a full redraw
+ *
+ *  param   prev    pointer to struct for the old display list
+ *  param   next    pointer to struct for the new display list
+ *  param   rects   the expected dirty rectangles
+ *  param   n       the number of expected dirty rectangles
+ *  param   bytes   the bytes of the update and of a full redraw
+ *
+ *  return  void
+ */
+static void test_dlist_update(const ucg_dlist_t *prev, const ucg_dlist_t *next,
+                              const ucg_box_t *rects, int n, uint32_t *bytes)
+{
+  static ucg_dirty_t dirty;
+  static frame_t update;
+  int  i;
+
+  clear();
+  draw_full(prev);
+
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_DiffDList(&ucg, prev, next);
+  CHECK(dirty.cnt == n);
+  for (i = 0; i < n && i < dirty.cnt; i++) {
+    CHECK(memcmp(&dirty.rect[i], &rects[i], sizeof(ucg_box_t)) == 0);
+    if ( memcmp(&dirty.rect[i], &rects[i], sizeof(ucg_box_t)) != 0 ) {
+      printf("  rect %d: %d,%d %dx%d\n", i, dirty.rect[i].ul.x, dirty.rect[i].ul.y,
+             dirty.rect[i].size.w, dirty.rect[i].size.h);
+    }
+  }
+
+  lcd.bytes = 0;
+  draw_dl = next;
+  ucg_FlushDirty(&ucg, draw_dlist);
+  ucg.dirty = NULL;
+  bytes[0] = lcd.bytes;
+  memcpy(update, lcd.fb, sizeof(update));
+
+  clear();
+  draw_full(next);
+  bytes[1] = lcd.bytes;
+  CHECK(memcmp(update, lcd.fb, sizeof(update)) == 0);
+}
+
+/*  brief   Tests the display lists: the bytes of the items, the dirty rectangles
+ *          of ucg_DiffDList() and the updates with ucg_FlushDirty(), directly on
+ *          the display and with a strip buffer
+ *
+ *  return  void
+ */
+static void test_dlist(void)
+{
+  static uint8_t buf[2][256];
+  static ucg_dlist_t dl[2];
+  static ucg_strip_t strip;
+  static uint8_t sbuf[UCG_STRIP_BUF_SIZE(UCG_HOST_WIDTH, 16)];
+  static const uint8_t golden[] = {
+    1, 13, 1, 2, 3,  10, 0, 0xFE, 0xFF, 0x2C, 0x01, 20, 0,           // box 10, -2, 300, 20
+    2, 13, 1, 2, 3,  0, 0, 0, 0, 1, 0, 1, 0,                         // frame 0, 0, 1, 1
+    3, 15, 4, 5, 6,  5, 0, 6, 0, 7, 0, 8, 0, 3, 0,                   // rbox 5, 6, 7, 8, 3
+    4, 13, 4, 5, 6,  0x80, 0, 0xFF, 0xFF, 0, 0x80, 0x9F, 0,          // line 128, -1, -32768, 159
+  };
+  static const ucg_box_t rects_value[] = { { { 9, 97 }, { 49, 17 } } };    // x_offset of the font: -1
+  static const ucg_box_t rects_bar[] = { { { 12, 52 }, { 81, 16 } } };
+  static const ucg_box_t rects_line[] = { { { 0, 80 }, { 128, 5 } } };
+  static const ucg_box_t rects_all[] = { { { 0, 0 }, { 128, 160 } } };
+  const ucg_fntpgm_uint8_t *f;
+  uint32_t bytes[4][2];
+  int  s, len;
+
+  // the bytes of the items
+  ucg_InitDList(&dl[0], buf[0], sizeof(buf[0]));
+  ucg_DListColor(&dl[0], 1, 2, 3);
+  CHECK(ucg_DListBox(&dl[0], 10, -2, 300, 20));
+  CHECK(ucg_DListFrame(&dl[0], 0, 0, 1, 1));
+  ucg_DListColor(&dl[0], 4, 5, 6);
+  CHECK(ucg_DListRBox(&dl[0], 5, 6, 7, 8, 3));
+  CHECK(ucg_DListLine(&dl[0], 128, -1, -32768, 159));
+  CHECK(dl[0].len == sizeof(golden) && memcmp(buf[0], golden, sizeof(golden)) == 0);
+  len = dl[0].len;
+  CHECK(ucg_DListText(&dl[0], 1, 2, ucg_font_ncenR12_tr, "ab"));
+  memcpy(&f, buf[0] + len + 9, sizeof(f));
+  CHECK(buf[0][len] == 5 && buf[0][len + 1] == 9 + sizeof(f) + 3 && buf[0][len + 5] == 1 && buf[0][len + 7] == 2);
+  CHECK(f == ucg_font_ncenR12_tr && memcmp(buf[0] + len + 9 + sizeof(f), "ab", 3) == 0);
+
+  // a full buffer: the item is not appended, the whole display is marked
+  ucg_InitDList(&dl[1], buf[1], 20);
+  CHECK(ucg_DListBox(&dl[1], 0, 0, 1, 1) && !ucg_DListBox(&dl[1], 0, 0, 1, 1));
+  CHECK(dl[1].len == 13 && dl[1].overflow);
+
+  for (s = 0; s < 2; s++) {
+    if ( s == 1 ) ucg_SetStrip(&ucg, &strip, sbuf, 16);
+
+    // a changed value, a longer bar, an inserted line and a full buffer
+    build_page(&dl[0], buf[0], sizeof(buf[0]), "21.5 C", 40, 0);
+    build_page(&dl[1], buf[1], sizeof(buf[1]), "22.0 C", 40, 0);
+    test_dlist_update(&dl[0], &dl[1], rects_value, 1, bytes[0]);
+    build_page(&dl[1], buf[1], sizeof(buf[1]), "21.5 C", 81, 0);
+    test_dlist_update(&dl[0], &dl[1], rects_bar, 1, bytes[1]);
+    build_page(&dl[1], buf[1], sizeof(buf[1]), "21.5 C", 40, 1);
+    test_dlist_update(&dl[0], &dl[1], rects_line, 1, bytes[2]);
+    test_dlist_update(&dl[1], &dl[0], rects_line, 1, bytes[3]);   // the line is removed
+    build_page(&dl[1], buf[1], 60, "21.5 C", 40, 0);
+    CHECK(dl[1].overflow);
+    test_dlist_update(&dl[0], &dl[1], rects_all, 1, bytes[3]);
+
+    printf("display list%s: value %u bytes, bar %u bytes, line %u bytes, full redraw %u bytes (with the line %u)\n",
+           s ? " (strip)" : "", bytes[0][0], bytes[1][0], bytes[2][0], bytes[0][1], bytes[2][1]);
+  }
+  ucg_UndoStrip(&ucg);
+}
+
+/*  brief   Draws the scene of test_strip(): boxes, lines, a disc, text and
+ *          bitmaps, in the coordinates of the (rotated) display
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  void
+ */
+static void draw_scene(ucg_t *ucg)
+{
+  ucg_int_t  w = ucg_GetWidth(ucg);
+  ucg_int_t  h = ucg_GetHeight(ucg);
+
+  ucg_SetColor(ucg, 0, 0, 0, 80);
+  ucg_DrawBox(ucg, 0, 0, w, h);
+  ucg_SetColor(ucg, 0, 200, 40, 40);
+  ucg_DrawBox(ucg, 10, 12, 50, 30);
+  ucg_SetColor(ucg, 0, 250, 250, 0);
+  ucg_DrawFrame(ucg, 5, 60, 70, 40);
+  ucg_DrawRBox(ucg, w - 40, h - 30, 35, 25, 6);
+  ucg_DrawHLine(ucg, 0, h / 2, w);
+  ucg_SetColor(ucg, 0, 40, 220, 90);
+  ucg_DrawLine(ucg, 0, 0, w - 1, h - 1);
+  ucg_DrawDisc(ucg, w / 2, h / 3, 17, UCG_DRAW_ALL);
+  ucg_SetColor(ucg, 0, 255, 255, 255);
+  ucg_SetFont(ucg, ucg_font_ncenR12_tr);
+  ucg_DrawString(ucg, 8, 52, 0, "21.5 C");
+  ucg_DrawIBmp(ucg, 70, 20, 0, sixteen);
+  ucg_DrawIBmp(ucg, 20, h - 10, 1, many);
+}
+
+/*  brief   Converts every pixel of a frame like the strip buffer
+ *
+ *  param   fb      the frame, converted in place
+ *
+ *  return  void
+ */
+static void strip_frame(frame_t fb)
+{
+  int  x, y;
+
+  for (y = 0; y < UCG_HOST_HEIGHT; y++) {
+    for (x = 0; x < UCG_HOST_WIDTH; x++) strip_color(fb[y][x]);
+  }
+}
+
+/*  brief   Sets the rotation of the display
+ *
+ *  param   rot     0, 1, 2 or 3: 0, 90, 180 or 270 degrees
+ *
+ *  return  void
+ */
+static void set_rotation(int rot)
+{
+  switch ( rot ) {
+    case 1:  ucg_SetRotate90(&ucg);  break;
+    case 2:  ucg_SetRotate180(&ucg); break;
+    case 3:  ucg_SetRotate270(&ucg); break;
+    default: ucg_UndoRotate(&ucg);   break;
+  }
+}
+
+/*  brief   Tests the strip buffer against direct drawing: the rotations 0, 90,
+ *          180 and 270 below the strip (set before ucg_SetStrip(), for 90 and
+ *          270 without a window, the rows are sent as lines) and above the
+ *          strip, with the whole display and with clip ranges that are not
+ *          aligned to the strips. The pictures must be the same after the
+ *          conversion to RGB 565.
+ *
+ *  return  void
+ */
+static void test_strip(void)
+{
+  static ucg_strip_t strip;
+  static uint8_t sbuf[UCG_STRIP_BUF_SIZE(UCG_HOST_HEIGHT, 16)];
+  static frame_t direct;
+  uint32_t bytes[2][2];
+  ucg_int_t cx, cy, cw, ch;
+  int  rot, above, k, n, h, strips;
+
+  for (rot = 0; rot < 4; rot++) {
+    for (above = 0; above < 2; above++) {
+      if ( rot == 0 && above ) continue;
+      for (k = 0; k < 3; k++) {
+        // k = 1: a clip range inside of the display, k = 2: from the middle
+        // of a strip to the right and lower edge
+        set_rotation(rot);
+        cw = ucg_GetWidth(&ucg);
+        ch = ucg_GetHeight(&ucg);
+        cx = ( k == 0 ) ? 0 : ( k == 1 ) ? 9 : 37;
+        cy = ( k == 0 ) ? 0 : ( k == 1 ) ? 21 : 45;
+        cw = ( k == 1 ) ? cw - 30 : cw - cx;
+        ch = ( k == 1 ) ? ch - 50 : ch - cy;
+
+        clear();
+        ucg_SetClipRange(&ucg, cx, cy, cw, ch);
+        draw_scene(&ucg);
+        memcpy(direct, lcd.fb, sizeof(direct));
+        strip_frame(direct);
+        if ( k == 0 && rot < 2 && !above ) bytes[rot][0] = lcd.bytes;
+
+        // the rotation is below the strip (set before ucg_SetStrip()) or above it
+        clear();
+        if ( above ) ucg_UndoRotate(&ucg);
+        ucg_SetStrip(&ucg, &strip, sbuf, 16);
+        if ( above ) set_rotation(rot);
+        ucg_SetClipRange(&ucg, cx, cy, cw, ch);
+        n = (strip.clip.ul.y + strip.clip.size.h - 1) / 16 - strip.clip.ul.y / 16 + 1;
+        h = strip.clip.size.h;
+        ucg_FirstPage(&ucg);
+        strips = 0;
+        do {
+          draw_scene(&ucg);
+          strips++;
+        } while ( ucg_NextPage(&ucg) );
+        if ( above ) ucg_UndoRotate(&ucg);
+        ucg_UndoStrip(&ucg);
+        ucg_UndoRotate(&ucg);
+        if ( k == 0 && rot < 2 && !above ) bytes[rot][1] = lcd.bytes;
+
+        strip_frame(lcd.fb);
+        if ( memcmp(lcd.fb, direct, sizeof(direct)) != 0 ) {
+          printf("strip: rotation %d %s the strip, clip %d differs, see ucg_host_fail.ppm\n",
+                 rot * 90, above ? "above" : "below", k);
+          ucg_host_save(&lcd, "ucg_host_fail.ppm");
+        }
+        CHECK(memcmp(lcd.fb, direct, sizeof(direct)) == 0);
+        // only the strips in the clip range are drawn (in the coordinates of the
+        // strip), every strip in one window or without a window in lines
+        CHECK(strips == n);
+        if ( !above && (rot & 1) ) CHECK(lcd.windows > (uint32_t) h);
+        else CHECK(lcd.windows == (uint32_t) strips);
+      }
+    }
+  }
+  ucg_SetMaxClipRange(&ucg);
+
+  printf("strip: full scene %u bytes instead of %u (rotation 0), %u bytes instead of %u (rotation 90 below the strip)\n",
+         bytes[0][1], bytes[0][0], bytes[1][1], bytes[1][0]);
+}
+
+/*  brief   Tests the alpha blending of the strip buffer: every alpha 0 ... 255
+ *          for a few pairs of colors, compared with a blending in float
+ *          in the resolution of RGB 565
+ *
+ *  return  void
+ */
+static void test_alpha(void)
+{
+  static const uint8_t fg[4][3] = { { 255, 255, 255 }, { 0, 0, 0 }, { 200, 100, 37 }, { 13, 240, 180 } };
+  static const uint8_t bg[4][3] = { { 0, 0, 0 }, { 255, 255, 255 }, { 13, 240, 180 }, { 200, 100, 37 } };
+  static const int     bits[3] = { 5, 6, 5 };
+  static ucg_strip_t strip;
+  static uint8_t sbuf[UCG_STRIP_BUF_SIZE(UCG_HOST_WIDTH, 16)];
+  double   f, b, ref, err, worst = 0;
+  int      a, i, k, v;
+
+  clear();
+  ucg_SetStrip(&ucg, &strip, sbuf, 16);
+  ucg_FirstPage(&ucg);
+  do {
+    for (i = 0; i < 4; i++) {              // two lines per pair, a pixel per alpha
+      ucg_SetAlpha(&ucg, 255);
+      ucg_SetColor(&ucg, 0, bg[i][0], bg[i][1], bg[i][2]);
+      ucg_DrawBox(&ucg, 0, i * 2, UCG_HOST_WIDTH, 2);
+      ucg_SetColor(&ucg, 0, fg[i][0], fg[i][1], fg[i][2]);
+      for (a = 0; a < 256; a++) {
+        ucg_SetAlpha(&ucg, a);
+        ucg_DrawBox(&ucg, a % UCG_HOST_WIDTH, i * 2 + a / UCG_HOST_WIDTH, 1, 1);
+      }
+    }
+    ucg_SetAlpha(&ucg, 255);
+  } while ( ucg_NextPage(&ucg) );
+  ucg_UndoStrip(&ucg);
+
+  for (i = 0; i < 4; i++) {
+    for (a = 0; a < 256; a++) {
+      for (k = 0; k < 3; k++) {
+        f   = fg[i][k] >> (8 - bits[k]);
+        b   = bg[i][k] >> (8 - bits[k]);
+        ref = (f * a + b * (255 - a)) / 255.0;
+        v   = lcd.fb[i * 2 + a / UCG_HOST_WIDTH][a % UCG_HOST_WIDTH][k] >> (8 - bits[k]);
+        err = ( v > ref ) ? v - ref : ref - v;
+        if ( err > worst ) worst = err;
+      }
+    }
+  }
+  CHECK(worst <= 1.0);
+  printf("alpha: worst error %.2f LSB of RGB 565 (256 alphas, 4 pairs of colors)\n", worst);
+}
+
+static ucg_box_t  flushed[UCG_DIRTY_RECTS];   //!<  the clip boxes of draw_flushed()
+static int        nflushed;                    //!<  the number of calls of draw_flushed()
+
+/*  brief   Stores the clip box, the draw function of ucg_FlushDirty() in test_dirty()
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  void
+ */
+static void draw_flushed(ucg_t *ucg)
+{
+  if ( nflushed < UCG_DIRTY_RECTS ) flushed[nflushed] = ucg->clip_box;
+  nflushed++;
+}
+
+/*  brief   Checks if a rectangle is one of the dirty rectangles
+ *
+ *  param   d       pointer to struct for the dirty rectangles
+ *  param   x       the x-position of the rectangle
+ *  param   y       the y-position of the rectangle
+ *  param   w       the width of the rectangle
+ *  param   h       the height of the rectangle
+ *
+ *  return  1 if the rectangle is dirty
+ */
+static int is_dirty(const ucg_dirty_t *d, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h)
+{
+  uint8_t  i;
+
+  for (i = 0; i < d->cnt; i++) {
+    if ( d->rect[i].ul.x == x && d->rect[i].ul.y == y && d->rect[i].size.w == w && d->rect[i].size.h == h ) return 1;
+  }
+  return 0;
+}
+
+/*  brief   Tests the dirty rectangles: the merging with UCG_DIRTY_COST, the
+ *          merging again after a merge, the merging with the rectangle that
+ *          grows least if all rectangles are used, the clipping to the display
+ *          and the statistics of ucg_FlushDirty()
+ *
+ *  return  void
+ */
+static void test_dirty(void)
+{
+  static ucg_dirty_t dirty;
+  int  i;
+
+  // two rectangles of 8x8 with a gap of 8 pixels: 192 <= 64 + 64 + 64,
+  // with a gap of 9 pixels: 200 > 192
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_MarkDirty(&ucg, 0, 0, 8, 8);
+  ucg_MarkDirty(&ucg, 16, 0, 8, 8);
+  CHECK(dirty.cnt == 1 && is_dirty(&dirty, 0, 0, 24, 8));
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_MarkDirty(&ucg, 0, 0, 8, 8);
+  ucg_MarkDirty(&ucg, 17, 0, 8, 8);
+  CHECK(dirty.cnt == 2 && is_dirty(&dirty, 0, 0, 8, 8) && is_dirty(&dirty, 17, 0, 8, 8));
+
+  // the new rectangle is merged with the second one (140 <= 264), the union
+  // then with the first one (400 <= 140 + 200 + 64), which was checked before
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_MarkDirty(&ucg, 0, 10, 20, 10);
+  ucg_MarkDirty(&ucg, 0, 0, 10, 10);
+  CHECK(dirty.cnt == 2);
+  ucg_MarkDirty(&ucg, 4, 0, 10, 10);
+  CHECK(dirty.cnt == 1 && is_dirty(&dirty, 0, 0, 20, 20));
+
+  // all rectangles are used: the ninth one is merged with (80, 40), which
+  // grows by 712 pixels, (40, 80) would grow by 872 pixels
+  ucg_SetDirty(&ucg, &dirty);
+  for (i = 0; i < UCG_DIRTY_RECTS; i++) ucg_MarkDirty(&ucg, 40 * (i % 3), 40 * (i / 3), 10, 10);
+  CHECK(dirty.cnt == UCG_DIRTY_RECTS);
+  ucg_MarkDirty(&ucg, 84, 88, 10, 10);
+  CHECK(dirty.cnt == UCG_DIRTY_RECTS && is_dirty(&dirty, 80, 40, 14, 58) && !is_dirty(&dirty, 80, 40, 10, 10));
+  CHECK(is_dirty(&dirty, 40, 80, 10, 10));
+
+  // clipped to the display, a rectangle outside of the display is ignored
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_MarkDirty(&ucg, -5, -3, 20, 10);
+  ucg_MarkDirty(&ucg, 120, 150, 20, 20);
+  ucg_MarkDirty(&ucg, -20, 50, 10, 10);
+  ucg_MarkDirty(&ucg, 50, 160, 10, 10);
+  CHECK(dirty.cnt == 2 && is_dirty(&dirty, 0, 0, 15, 7) && is_dirty(&dirty, 120, 150, 8, 10));
+  CHECK(dirty.marked_sum == 15 * 7 + 8 * 10);
+
+  // the statistics: two overlapping rectangles (marked 200 + 200 pixels) are
+  // one rectangle of 300 pixels, the draw function is called per rectangle
+  ucg_SetDirty(&ucg, &dirty);
+  ucg_MarkDirty(&ucg, 10, 10, 20, 10);
+  ucg_MarkDirty(&ucg, 20, 10, 20, 10);
+  ucg_MarkDirty(&ucg, 100, 100, 5, 4);
+  nflushed = 0;
+  CHECK(ucg_FlushDirty(&ucg, draw_flushed) == 300 + 20);
+  CHECK(dirty.regions == 2 && dirty.marked == 420 && dirty.pixels == 320);
+  CHECK(nflushed == 2 && dirty.cnt == 0 && dirty.marked_sum == 0);
+  CHECK(flushed[0].ul.x == 10 && flushed[0].ul.y == 10 && flushed[0].size.w == 30 && flushed[0].size.h == 10);
+  CHECK(flushed[1].ul.x == 100 && flushed[1].ul.y == 100 && flushed[1].size.w == 5 && flushed[1].size.h == 4);
+  CHECK(ucg.clip_box.size.w == UCG_HOST_WIDTH && ucg.clip_box.size.h == UCG_HOST_HEIGHT);
+  nflushed = 0;
+  CHECK(ucg_FlushDirty(&ucg, draw_flushed) == 0);
+  CHECK(nflushed == 0 && dirty.regions == 0 && dirty.marked == 0);
+  ucg.dirty = NULL;
+}
+
+/*  brief   Checks the text of a text field
+ *
+ *  param   tf      pointer to struct for the text field
+ *  param   str     the expected text
+ *
+ *  return  1 if the text field shows the text
+ */
+static int textfield_is(const ucg_textfield_t *tf, const char *str)
+{
+  uint8_t  i;
+
+  if ( tf->len != strlen(str) ) return 0;
+  for (i = 0; i < tf->len; i++) {
+    if ( tf->text[i] != (uint8_t) str[i] ) return 0;
+  }
+  return 1;
+}
+
+/*  brief   Tests the conversions of ucg_Print() with a text field
+ *
+ *  return  void
+ */
+static void test_print(void)
+{
+  static ucg_textfield_t tf;
+
+  ucg_SetFont(&ucg, ucg_font_ncenR12_tr);
+  ucg_InitTextField(&tf, 10, 40, 0);
+
+  ucg_PrintTextField(&ucg, &tf, "%d%% load %d", 5, 7);
+  CHECK(textfield_is(&tf, "5% load 7"));
+  ucg_PrintTextField(&ucg, &tf, "%3%|%-3%|%.2F", 1234);
+  CHECK(textfield_is(&tf, "  %|%  |12.34"));
+  ucg_PrintTextField(&ucg, &tf, "%lX %.1P %.2F", 0xBEEFUL, 455, -5);
+  CHECK(textfield_is(&tf, "BEEF 45.5% -0.05"));
+  ucg_PrintTextField(&ucg, &tf, "a %f b %d", 3, 4);  // unknown: printed as is, the rest is dropped
+  CHECK(textfield_is(&tf, "a %f"));
+  ucg_ClearTextField(&ucg, &tf);
+}
+
+/*! \brief  Runs the tests
+ *
+ *  \return the number of failures
+ */
+int main(void)
+{
+  ucg_host_open(&ucg, &lcd);
+
+  test_ibmp();
+  test_tilemap();
+  test_dlist();
+  test_strip();
+  test_alpha();
+  test_dirty();
+  test_print();
+
+  printf("%d checks, %d failures\n", checks, failures);
+  return failures;
+}
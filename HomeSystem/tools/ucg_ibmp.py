@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Converts PNG/PPM images to indexed-color bitmaps for ucg_DrawIBmp()
+
+Usage:
+  ucg_ibmp.py [-b bpp] [-o file.c] [-c] image [image ...]
+
+  image   PNG or PPM image, the name of the array is ucg_ibmp_<name of the file>,
+          or name=image to choose the name of the array
+  -b      bits per pixel (1, 2, 4 or 8), default: the smallest that fits
+  -o      output file (default stdout)
+  -c      check: decode every bitmap again and compare it with the image
+
+The format is described in ucglib/ucg_ibmp.c. Colors are reduced to 6 bits per
+component (like the ST7735 in 18-bit mode), an image can have at most 256
+colors (including transparent). Pixels with an alpha below 128 are transparent.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from ucg_image import read_image, write_c_array
+
+FLAG_TRANSPARENT = 0x01
+HEADER_SIZE = 8
+
+
+def quantize(pixels):
+  """Returns the colors of the pixels in the format of the display, None is transparent"""
+  return [[(r & 0xfc, g & 0xfc, b & 0xfc) if a >= 128 else None for (r, g, b, a) in row] for row in pixels]
+
+
+def encode(width, height, colors, bpp):
+  palette = []
+  for row in colors:
+    for px in row:
+      if px is not None and px not in palette:
+        palette.append(px)
+  transparent = any(px is None for row in colors for px in row)
+  needed = len(palette) + (1 if transparent else 0)
+  if needed > 256:
+    sys.exit("ucg_ibmp: the image has %d colors, at most 256 are possible" % needed)
+  if bpp is None:
+    bpp = next(b for b in (1, 2, 4, 8) if needed <= (1 << b))
+  elif needed > (1 << bpp):
+    sys.exit("ucg_ibmp: the image has %d colors, %d bits per pixel are too few" % (needed, bpp))
+
+  index = {px: i for i, px in enumerate(palette)}
+  tindex = len(palette) if transparent else 0
+  if transparent:
+    palette.append((0, 0, 0))                  # not in index: black pixels keep their own index
+
+  data = [width >> 8, width & 0xff, height >> 8, height & 0xff, bpp,
+          FLAG_TRANSPARENT if transparent else 0, tindex, len(palette) - 1]
+  for px in palette:
+    data.extend(px)
+  for row in colors:
+    bits, nbits = 0, 0
+    for px in row:
+      bits = (bits << bpp) | (tindex if px is None else index[px])
+      nbits += bpp
+      if nbits == 8:
+        data.append(bits)
+        bits, nbits = 0, 0
+    if nbits:
+      data.append(bits << (8 - nbits))
+  return data
+
+
+def decode(data):
+  """Decodes like ucg_DrawIBmp(), returns the rows of colors, None is transparent"""
+  width, height = (data[0] << 8) | data[1], (data[2] << 8) | data[3]
+  bpp, flags, tindex, ncolors = data[4], data[5], data[6], data[7] + 1
+  palette = [tuple(data[HEADER_SIZE + 3 * i:HEADER_SIZE + 3 * i + 3]) for i in range(ncolors)]
+  stride = (width * bpp + 7) // 8
+  pos = HEADER_SIZE + 3 * ncolors
+  colors = []
+  for r in range(height):
+    row = data[pos + r * stride:pos + (r + 1) * stride]
+    line = []
+    for c in range(width):
+      bit = c * bpp
+      idx = (row[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1)
+      line.append(None if (flags & FLAG_TRANSPARENT) and idx == tindex else palette[idx])
+    colors.append(line)
+  return colors
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Converts images to indexed-color bitmaps for ucg_DrawIBmp()")
+  parser.add_argument('images', nargs='+')
+  parser.add_argument('-b', dest='bpp', type=int, choices=(1, 2, 4, 8))
+  parser.add_argument('-o', dest='output')
+  parser.add_argument('-c', dest='check', action='store_true')
+  args = parser.parse_args()
+
+  out = open(args.output, 'w') if args.output else sys.stdout
+  out.write("/*\n  Indexed-color bitmaps generated by ucg_ibmp.py\n*/\n\n#include \"ucg.h\"\n")
+  for arg in args.images:
+    name, _, path = arg.rpartition('=')
+    if not name:
+      name = 'ucg_ibmp_' + re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0]).lower()
+    width, height, pixels = read_image(path)
+    if width > 0xffff or height > 0xffff:
+      sys.exit("ucg_ibmp: %s is too large" % path)
+    colors = quantize(pixels)
+    data = encode(width, height, colors, args.bpp)
+    if args.check and decode(data) != colors:
+      sys.exit("ucg_ibmp: %s is not decoded correctly" % path)
+    raw = width * height * 3
+    write_c_array(out, name, data, "%s: %d x %d, %d bpp, %d colors, %d bytes (raw %d bytes)"
+                  % (os.path.basename(path), width, height, data[4], data[7] + 1, len(data), raw))
+    sys.stderr.write("%s: %d bpp, %d bytes, raw %d bytes\n" % (name, data[4], len(data), raw))
+
+
+if __name__ == '__main__':
+  main()
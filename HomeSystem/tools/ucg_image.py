@@ -0,0 +1,128 @@
+"""Reads PNG and PPM images for the bitmap tools (e.g. ucg_cbmp.py)
+
+Only the standard library is used. PNG images must not be interlaced; all
+color types and bit depths of 8 bits or less are supported.
+"""
+
+import struct
+import sys
+import zlib
+
+
+def read_image(path):
+  """Returns (width, height, pixels), pixels is a list of rows of (r, g, b, a)"""
+  with open(path, 'rb') as f:
+    data = f.read()
+  if data[:8] == b'\x89PNG\r\n\x1a\n':
+    return read_png(data)
+  if data[:2] in (b'P6', b'P3'):
+    return read_ppm(data)
+  sys.exit("ucg_image: %s is not a PNG or PPM image" % path)
+
+
+def read_ppm(data):
+  fields, pos = [], 2
+  while len(fields) < 3:
+    while data[pos:pos + 1].isspace():
+      pos += 1
+    if data[pos:pos + 1] == b'#':
+      pos = data.index(b'\n', pos)
+      continue
+    end = pos
+    while not data[end:end + 1].isspace():
+      end += 1
+    fields.append(int(data[pos:end]))
+    pos = end
+  width, height, maxval = fields
+  if data[:2] == b'P6':
+    values = data[pos + 1:pos + 1 + width * height * 3]
+  else:
+    values = [int(v) for v in data[pos:].split()]
+  values = [v * 255 // maxval for v in values]
+  pixels = []
+  for y in range(height):
+    row = values[y * width * 3:(y + 1) * width * 3]
+    pixels.append([(row[i], row[i + 1], row[i + 2], 255) for i in range(0, width * 3, 3)])
+  return width, height, pixels
+
+
+def read_png(data):
+  pos, idat, palette, trns = 8, b'', [], b''
+  while pos < len(data):
+    length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+    chunk = data[pos + 8:pos + 8 + length]
+    pos += 12 + length
+    if kind == b'IHDR':
+      width, height, depth, ctype, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+    elif kind == b'PLTE':
+      palette = [tuple(chunk[i:i + 3]) for i in range(0, len(chunk), 3)]
+    elif kind == b'tRNS':
+      trns = chunk
+    elif kind == b'IDAT':
+      idat += chunk
+    elif kind == b'IEND':
+      break
+  if interlace or depth > 8:
+    sys.exit("ucg_image: interlaced or 16 bit PNG images are not supported")
+
+  channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[ctype]
+  bpp = max(1, channels * depth // 8)
+  stride = (width * channels * depth + 7) // 8
+  raw = zlib.decompress(idat)
+  rows, prev = [], bytearray(stride)
+  for y in range(height):
+    ftype = raw[y * (stride + 1)]
+    line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+    for i in range(stride):
+      a = line[i - bpp] if i >= bpp else 0
+      b = prev[i]
+      c = prev[i - bpp] if i >= bpp else 0
+      if ftype == 1:
+        line[i] = (line[i] + a) & 0xff
+      elif ftype == 2:
+        line[i] = (line[i] + b) & 0xff
+      elif ftype == 3:
+        line[i] = (line[i] + (a + b) // 2) & 0xff
+      elif ftype == 4:
+        p = a + b - c
+        pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+        line[i] = (line[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xff
+    rows.append(line)
+    prev = line
+
+  pixels = []
+  for line in rows:
+    if depth < 8:
+      mask = (1 << depth) - 1
+      samples = [(line[i * depth // 8] >> (8 - depth - (i * depth) % 8)) & mask for i in range(width * channels)]
+    else:
+      samples = list(line)
+    row = []
+    for x in range(width):
+      s = samples[x * channels:(x + 1) * channels]
+      if ctype == 3:
+        r, g, b = palette[s[0]]
+        a = trns[s[0]] if s[0] < len(trns) else 255
+      elif ctype in (0, 4):
+        v = s[0] * 255 // ((1 << depth) - 1)
+        r = g = b = v
+        a = s[1] if ctype == 4 else 255
+        if ctype == 0 and len(trns) == 2 and s[0] == struct.unpack('>H', trns)[0]:
+          a = 0
+      else:
+        r, g, b = s[:3]
+        a = s[3] if ctype == 6 else 255
+        if ctype == 2 and len(trns) == 6 and (r, g, b) == struct.unpack('>HHH', trns):
+          a = 0
+      row.append((r, g, b, a))
+    pixels.append(row)
+  return width, height, pixels
+
+
+def write_c_array(out, name, data, comment):
+  """Writes a const __memx uint8_t array"""
+  out.write("\n/* %s */\n" % comment)
+  out.write("const __memx uint8_t %s[%d] = {\n" % (name, len(data)))
+  for i in range(0, len(data), 16):
+    out.write("  " + ",".join(str(v) for v in data[i:i + 16]) + ",\n")
+  out.write("};\n")
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Pre-renders static texts with a ucglib font to labels for ucg_DrawLabel()
+
+Usage:
+  ucg_label.py [-f color] [-b color] [-p pad] [-o file.c] [-H file.h]
+               fontfile.c fontname name=text [name=text ...]
+
+  fontfile.c  C file with the ucglib font, e.g. ucglib/ucg_pixel_font_data.c
+  fontname    name of the font array, e.g. ucg_font_ncenR12_tr
+  name=text   name of the label array and its text (UTF-8)
+  -f          foreground color, e.g. ffffff (default)
+  -b          background color, e.g. 000000 (default)
+  -p          empty pixels on the left and right side (default 0)
+  -o          output file (default stdout)
+  -H          header file with the declarations of the labels
+
+The label is as high as the font (max_char_height), the baseline is at
+ascent rows from the top. The format is described in ucglib/ucg_label.c.
+"""
+
+import argparse
+import sys
+
+from ucg_unifont import read_c_font, decode_font
+
+
+def signed(v):
+  return v - 256 if v > 127 else v
+
+
+def render(font, glyphs, text, pad):
+  height = font[10]
+  ascent = font[10] + signed(font[12])
+  width = 2 * pad
+  for ch in text:
+    g = glyphs.get(ord(ch))
+    if g is None:
+      sys.stderr.write("ucg_label: glyph 0x%x is not in the font\n" % ord(ch))
+      continue
+    width += g.dx
+  if width > 255:
+    sys.exit("ucg_label: '%s' is too wide" % text)
+
+  pixels = [[0] * width for _ in range(height)]
+  x = pad
+  for ch in text:
+    g = glyphs.get(ord(ch))
+    if g is None:
+      continue
+    for r in range(g.h):
+      row = ascent - (g.y + g.h - r)
+      for c in range(g.w):
+        col = x + g.x + c
+        if g.rows[r][c] and 0 <= row < height and 0 <= col < width:
+          pixels[row][col] = 1
+    x += g.dx
+  return width, height, pixels
+
+
+def encode(width, height, pixels, fg, bg):
+  data = [width, height] + fg + bg
+  flat = [p for row in pixels for p in row]
+  i = 0
+  while i < len(flat):
+    run = 1
+    while i + run < len(flat) and flat[i + run] == flat[i] and run < 128:
+      run += 1
+    data.append((flat[i] << 7) | (run - 1))
+    i += run
+  return data
+
+
+def color(text):
+  v = int(text.lstrip('#'), 16)
+  return [(v >> 16) & 0xff, (v >> 8) & 0xff, v & 0xff]
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Pre-renders texts to labels for ucg_DrawLabel()")
+  parser.add_argument('cfile')
+  parser.add_argument('fontname')
+  parser.add_argument('labels', nargs='+')
+  parser.add_argument('-f', dest='fg', type=color, default=[255, 255, 255])
+  parser.add_argument('-b', dest='bg', type=color, default=[0, 0, 0])
+  parser.add_argument('-p', dest='pad', type=int, default=0)
+  parser.add_argument('-o', dest='output')
+  parser.add_argument('-H', dest='header')
+  args = parser.parse_args()
+
+  font = read_c_font(args.cfile, args.fontname)
+  glyphs = decode_font(font)
+
+  out = open(args.output, 'w') if args.output else sys.stdout
+  out.write("/*\n  Labels generated by ucg_label.py with %s\n*/\n\n" % args.fontname)
+  out.write('#include "ucg.h"\n')
+  decls = []
+  for label in args.labels:
+    name, _, text = label.partition('=')
+    width, height, pixels = render(font, glyphs, text, args.pad)
+    data = encode(width, height, pixels, args.fg, args.bg)
+    out.write("\n/* \"%s\": %d x %d, %d bytes */\n" % (text, width, height, len(data)))
+    out.write("const __memx uint8_t %s[%d] = {\n" % (name, len(data)))
+    for i in range(0, len(data), 16):
+      out.write("  " + ",".join(str(v) for v in data[i:i + 16]) + ",\n")
+    out.write("};\n")
+    decls.append("extern const __memx uint8_t %s[%d];" % (name, len(data)))
+
+  if args.header:
+    with open(args.header, 'w') as h:
+      guard = ''.join(c if c.isalnum() else '_' for c in args.header.split('/')[-1]).upper()
+      h.write("/*\n  Labels generated by ucg_label.py with %s\n*/\n\n" % args.fontname)
+      h.write("#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n" % (guard, guard))
+      h.write('\n'.join(decls) + "\n\n#endif\n")
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+"""Extends a ucglib font with glyphs from a BDF font, including 16 bit encodings
+
+Usage:
+  ucg_unifont.py [-r ranges] [-n name] [-o file.c] fontfile.c fontname font.bdf
+
+  fontfile.c  C file with the ucglib font, e.g. ucglib/ucg_pixel_font_data.c
+  fontname    name of the font array, e.g. ucg_font_ncenR12_tr
+  font.bdf    BDF font with unicode encodings (ISO10646), same size as the font
+  -r          range(s) of encodings that are added, e.g. 0x2190-0x2193,0x20ac
+              (default: all glyphs of the BDF font that are not in the font)
+  -n          name of the new font array (default <fontname>_u)
+  -o          output file (default stdout)
+
+Glyphs with encodings up to 255 are added to the 8 bit glyphs, the others to the
+unicode extension (see ucglib/ucg_font.c). All glyphs are encoded again, so the
+run-length parameters fit the new glyphs. The result is checked by decoding it.
+"""
+
+import argparse
+import re
+import sys
+
+HEADER_SIZE = 21
+BBX_UNICODE = 0x80
+
+
+class BitReader:
+  def __init__(self, data, pos):
+    self.data, self.pos, self.bit = data, pos, 0
+
+  def unsigned(self, cnt):
+    val = self.data[self.pos] >> self.bit
+    self.bit += cnt
+    if self.bit >= 8:
+      self.pos += 1
+      if self.pos < len(self.data):
+        val |= self.data[self.pos] << (8 - self.bit + cnt)
+      self.bit -= 8
+    return val & ((1 << cnt) - 1)
+
+  def signed(self, cnt):
+    return self.unsigned(cnt) - (1 << (cnt - 1))
+
+
+class BitWriter:
+  def __init__(self):
+    self.data, self.bit = [], 8
+
+  def put(self, val, cnt):
+    for i in range(cnt):
+      if self.bit == 8:
+        self.data.append(0)
+        self.bit = 0
+      self.data[-1] |= ((val >> i) & 1) << self.bit
+      self.bit += 1
+
+
+class Glyph:
+  """Glyph box: width, height, x/y offset of the lower left corner, advance, pixel rows"""
+  def __init__(self, encoding, w, h, x, y, dx, rows):
+    self.encoding, self.w, self.h, self.x, self.y, self.dx, self.rows = encoding, w, h, x, y, dx, rows
+
+
+def read_c_font(path, name):
+  text = open(path, encoding='latin-1').read()
+  m = re.search(r'\b%s\s*\[\s*\d*\s*\][^=]*=\s*\{([^}]*)\}' % re.escape(name), text)
+  if not m:
+    sys.exit("ucg_unifont: font %s not found in %s" % (name, path))
+  return [int(v, 0) for v in m.group(1).replace('\n', ' ').split(',') if v.strip()]
+
+
+def decode_glyph(font, pos):
+  """Decodes a glyph like ucg_font_decode_glyph()"""
+  r = BitReader(font, pos + 2)
+  w, h = r.unsigned(font[4]), r.unsigned(font[5])
+  x, y, dx = r.signed(font[6]), r.signed(font[7]), r.signed(font[8])
+  pixels = []
+  if w > 0:
+    while len(pixels) < w * h:
+      a, b = r.unsigned(font[2]), r.unsigned(font[3])
+      while True:
+        pixels += [0] * a + [1] * b
+        if r.unsigned(1) == 0:
+          break
+  pixels = (pixels + [0] * (w * h))[:w * h]
+  rows = [pixels[i * w:(i + 1) * w] for i in range(h)]
+  return Glyph(font[pos], w, h, x, y, dx, rows)
+
+
+def decode_font(font):
+  glyphs = {}
+  pos = HEADER_SIZE
+  while font[pos + 1] != 0:
+    glyphs[font[pos]] = decode_glyph(font, pos)
+    pos += font[pos + 1]
+  if font[1] & BBX_UNICODE:
+    section = pos + 2
+    n = (font[section] << 8) | font[section + 1]
+    for i in range(n):
+      t = section + 2 + 4 * i
+      code = (font[t] << 8) | font[t + 1]
+      glyph = decode_glyph(font, section + ((font[t + 2] << 8) | font[t + 3]))
+      glyph.encoding = code
+      glyphs[code] = glyph
+  return glyphs
+
+
+def read_bdf(path):
+  glyphs = {}
+  lines = iter(open(path, encoding='latin-1').read().splitlines())
+  for line in lines:
+    if not line.startswith('STARTCHAR'):
+      continue
+    code, dx, bbx, rows = -1, 0, (0, 0, 0, 0), []
+    for line in lines:
+      if line.startswith('ENCODING'):
+        code = int(line.split()[1])
+      elif line.startswith('DWIDTH'):
+        dx = int(line.split()[1])
+      elif line.startswith('BBX'):
+        bbx = tuple(int(v) for v in line.split()[1:5])
+      elif line.startswith('BITMAP'):
+        for line in lines:
+          if line.startswith('ENDCHAR'):
+            break
+          rows.append(line.strip())
+        break
+    w, h, x, y = bbx
+    if 0 < code <= 0xffff:
+      bits = [[(int(r, 16) >> (len(r) * 4 - 1 - i)) & 1 for i in range(w)] for r in rows[:h]]
+      glyphs[code] = Glyph(code, w, h, x, y, dx, bits)
+  return glyphs
+
+
+def unsigned_bits(v):
+  return max(v.bit_length(), 1)
+
+
+def signed_bits(v):
+  n = 1
+  while not -(1 << (n - 1)) <= v < (1 << (n - 1)):
+    n += 1
+  return n
+
+
+def runs(glyph, bp0, bp1):
+  """Splits the pixels in pairs of (zeros, ones)"""
+  pixels = [p for row in glyph.rows for p in row]
+  pairs, i = [], 0
+  while i < len(pixels):
+    a = b = 0
+    while i < len(pixels) and pixels[i] == 0 and a < (1 << bp0) - 1:
+      a += 1
+      i += 1
+    while i < len(pixels) and pixels[i] == 1 and b < (1 << bp1) - 1:
+      b += 1
+      i += 1
+    pairs.append((a, b))
+  return pairs
+
+
+def encode_glyph(glyph, p, code):
+  bw = BitWriter()
+  bw.put(glyph.w, p['w'])
+  bw.put(glyph.h, p['h'])
+  for v, n in ((glyph.x, p['x']), (glyph.y, p['y']), (glyph.dx, p['dx'])):
+    bw.put(v + (1 << (n - 1)), n)
+  if glyph.w > 0:
+    pairs = runs(glyph, p['0'], p['1'])
+    for i, (a, b) in enumerate(pairs):
+      if i > 0 and pairs[i - 1] == (a, b):
+        bw.put(1, 1)
+        continue
+      if i > 0:
+        bw.put(0, 1)
+      bw.put(a, p['0'])
+      bw.put(b, p['1'])
+    bw.put(0, 1)
+  size = len(bw.data) + 2
+  if size > 255:
+    sys.exit("ucg_unifont: glyph %d is too large" % glyph.encoding)
+  return [code & 0xff, size] + bw.data
+
+
+def encode_font(header, glyphs):
+  boxes = [g for g in glyphs.values() if g.w > 0 and g.h > 0]
+  p = {'w': unsigned_bits(max(g.w for g in glyphs.values())),
+       'h': unsigned_bits(max(g.h for g in glyphs.values())),
+       'x': max(signed_bits(g.x) for g in glyphs.values()),
+       'y': max(signed_bits(g.y) for g in glyphs.values()),
+       'dx': max(signed_bits(g.dx) for g in glyphs.values())}
+
+  # run-length parameters with the smallest font
+  best = None
+  for bp0 in range(2, 8):
+    for bp1 in range(2, 8):
+      p['0'], p['1'] = bp0, bp1
+      size = sum(len(encode_glyph(g, p, g.encoding)) for g in glyphs.values())
+      if best is None or size < best[0]:
+        best = (size, bp0, bp1)
+  p['0'], p['1'] = best[1], best[2]
+
+  low = sorted(c for c in glyphs if c <= 0xff)
+  high = sorted(c for c in glyphs if c > 0xff)
+
+  data = list(header[:HEADER_SIZE])
+  data[0] = len(low)
+  data[1] = (header[1] & ~BBX_UNICODE) | (BBX_UNICODE if high else 0)
+  data[2:9] = [p['0'], p['1'], p['w'], p['h'], p['x'], p['y'], p['dx']]
+  hx = header[11] - 256 if header[11] > 127 else header[11]
+  hy = header[12] - 256 if header[12] > 127 else header[12]
+  x0 = min([g.x for g in boxes] + [hx])
+  y0 = min([g.y for g in boxes] + [hy])
+  data[9] = max([g.x + g.w for g in boxes] + [hx + header[9]]) - x0
+  data[10] = max([g.y + g.h for g in boxes] + [hy + header[10]]) - y0
+  data[11], data[12] = x0 & 0xff, y0 & 0xff
+
+  body = []
+  pos_A = pos_a = None
+  for code in low:
+    if pos_A is None and code >= ord('A'):
+      pos_A = len(body)
+    if pos_a is None and code >= ord('a'):
+      pos_a = len(body)
+    body += encode_glyph(glyphs[code], p, code)
+  pos_A = len(body) if pos_A is None else pos_A
+  pos_a = len(body) if pos_a is None else pos_a
+  data[17:21] = [pos_A >> 8, pos_A & 0xff, pos_a >> 8, pos_a & 0xff]
+  data += body + [0, 0]
+
+  if high:
+    table, glyph_data = [], []
+    start = 2 + 4 * len(high)
+    for code in high:
+      offset = start + len(glyph_data)
+      if offset > 0xffff:
+        sys.exit("ucg_unifont: unicode extension is too large")
+      table += [code >> 8, code & 0xff, offset >> 8, offset & 0xff]
+      glyph_data += encode_glyph(glyphs[code], p, code)
+    data += [len(high) >> 8, len(high) & 0xff] + table + glyph_data
+  return data
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Extends a ucglib font with (unicode) glyphs of a BDF font")
+  parser.add_argument('cfile')
+  parser.add_argument('fontname')
+  parser.add_argument('bdf')
+  parser.add_argument('-r', dest='ranges')
+  parser.add_argument('-n', dest='name')
+  parser.add_argument('-o', dest='output')
+  args = parser.parse_args()
+
+  font = read_c_font(args.cfile, args.fontname)
+  glyphs = decode_font(font)
+  extra = read_bdf(args.bdf)
+  if args.ranges:
+    codes = set()
+    for part in args.ranges.split(','):
+      lo, _, hi = part.partition('-')
+      codes.update(range(int(lo, 0), int(hi or lo, 0) + 1))
+    missing = sorted(c for c in codes if c not in extra and c not in glyphs)
+    if missing:
+      sys.stderr.write("ucg_unifont: not in %s: %s\n" % (args.bdf, ' '.join('0x%x' % c for c in missing)))
+  else:
+    codes = set(c for c in extra if c not in glyphs)
+  for code in sorted(codes):
+    if code in extra:
+      glyphs[code] = extra[code]
+
+  data = encode_font(font, glyphs)
+
+  # check: every glyph is decoded to the same bitmap
+  check = decode_font(data)
+  for code, g in glyphs.items():
+    c = check.get(code)
+    if c is None or (c.w, c.h, c.x, c.y, c.dx, c.rows) != (g.w, g.h, g.x, g.y, g.dx, g.rows):
+      sys.exit("ucg_unifont: glyph %d is not encoded correctly" % code)
+
+  name = args.name or args.fontname + '_u'
+  out = open(args.output, 'w') if args.output else sys.stdout
+  out.write("/*\n  Generated by ucg_unifont.py from %s and %s\n  Glyphs: %d (8 bit), %d (16 bit), size: %d bytes\n*/\n\n"
+            % (args.fontname, args.bdf.split('/')[-1], len([c for c in glyphs if c <= 0xff]),
+               len([c for c in glyphs if c > 0xff]), len(data)))
+  out.write('#include "ucg.h"\n\n')
+  out.write("const ucg_fntpgm_uint8_t %s[%d] UCG_FONT_SECTION(\"%s\") = {\n" % (name, len(data), name))
+  for i in range(0, len(data), 16):
+    out.write("  " + ",".join(str(v) for v in data[i:i + 16]) + ",\n")
+  out.write("};\n")
+
+
+if __name__ == '__main__':
+  main()
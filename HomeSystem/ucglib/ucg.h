@@ -50,6 +50,7 @@
   offset	bytes	description
   0		1		glyph_cnt		number of glyphs
   1		1		bbx_mode	0: proportional, 1: common height, 2: monospace, 3: multiple of 8
+				bit 7: unicode extension (UCG_FONT_BBX_UNICODE), see ucg_font.c
   2		1		bits_per_0	glyph rle parameter
   3		1		bits_per_1	glyph rle parameter
 
@@ -159,6 +160,8 @@ typedef struct _ucg_t ucg_t;
 typedef struct _ucg_xy_t ucg_xy_t;
 typedef struct _ucg_wh_t ucg_wh_t;
 typedef struct _ucg_box_t ucg_box_t;
+typedef struct _ucg_window_t ucg_window_t;
+typedef struct _ucg_pixels_t ucg_pixels_t;
 typedef struct _ucg_color_t ucg_color_t;
 typedef struct _ucg_ccs_t ucg_ccs_t;
 typedef struct _ucg_pixel_t ucg_pixel_t;
@@ -257,6 +260,21 @@ struct _ucg_box_t
   ucg_wh_t size;
 };
 
+/* window for a stream of pixels, UCG_MSG_SET_WINDOW */
+struct _ucg_window_t
+{
+  ucg_box_t box;		/* in display coordinates, inside the display */
+  uint8_t scan;		/* UCG_WINDOW_MIRROR_X, UCG_WINDOW_MIRROR_Y */
+};
+
+/* pixels for a window, UCG_MSG_WRITE_PIXELS */
+struct _ucg_pixels_t
+{
+  uint8_t *rgb;			/* 3 bytes (red, green, blue) per pixel */
+  uint16_t cnt;			/* number of pixels */
+  uint8_t repeat;		/* 0: cnt pixels in rgb, 1: the pixel in rgb cnt times */
+};
+
 struct _ucg_color_t
 {
   uint8_t color[3];		/* 0: Red, 1: Green, 2: Blue */
@@ -298,6 +316,9 @@ struct _ucg_arg_t
 #define UCG_FONT_HEIGHT_MODE_XTEXT 1
 #define UCG_FONT_HEIGHT_MODE_ALL 2
 
+/* bit in bbx_mode (offset 1) of the font data: a section with 16 bit encodings follows the 8 bit glyphs */
+#define UCG_FONT_BBX_UNICODE 0x80
+
 struct _ucg_com_info_t
 {
   uint16_t serial_clk_speed;	/* nano seconds cycle time */
@@ -335,6 +356,9 @@ struct _ucg_font_info_t
   /* offset 17 */
   uint16_t start_pos_upper_A;
   uint16_t start_pos_lower_a;  
+  
+  /* unicode extension */
+  uint16_t start_pos_unicode;	/* 0: no unicode glyphs */
 };
 typedef struct _ucg_font_info_t ucg_font_info_t;
 
@@ -397,6 +421,12 @@ struct _ucg_t
 
   /* if rotation is applied, than this cb is called by the scale device */
   ucg_dev_fnptr scale_chain_device_cb;
+
+  /* strip buffer (page mode), see ucg_strip.c */
+  struct _ucg_strip_t *strip;
+
+  /* dirty rectangles (partial refresh), see ucg_dirty.c */
+  struct _ucg_dirty_t *dirty;
   
   /* communication interface */
   ucg_com_fnptr com_cb;
@@ -432,6 +462,13 @@ struct _ucg_t
   int8_t font_ref_ascent;
   int8_t font_ref_descent;
 
+  /* print position and direction, see ucg_print.c */
+  ucg_xy_t print_pos;
+  uint8_t print_dir;
+
+  /* current anti-aliased font, see ucg_aafont.c */
+  struct _ucg_aafont_t *aafont;
+
 #ifdef WITH_USER_PTR
   void *user_ptr;
 #endif
@@ -484,6 +521,23 @@ struct _ucg_t
 /* draw  bit pattern with foreground (idx 1) and background (idx 0) color */
 //#define UCG_MSG_DRAW_L90BF 25	 /* can be commented, used by ucg_DrawBitmapLine */
 
+/* 
+  stream of pixels in a window, used by ucg_bmp.c 
+  UCG_MSG_SET_WINDOW: enable chip, set the window and start the RAM write
+    data: ucg_window_t *
+    return: 0 if the window or the scan order is not supported by the controller
+  UCG_MSG_WRITE_PIXELS: write pixels, from left to right and top to bottom
+    (mirrored with the scan order of the window)
+    data: ucg_pixels_t *
+  UCG_MSG_END_WINDOW: end of the stream, disable chip
+*/
+#define UCG_MSG_SET_WINDOW 26
+#define UCG_MSG_WRITE_PIXELS 27
+#define UCG_MSG_END_WINDOW 28
+
+#define UCG_WINDOW_MIRROR_X 1		/* the pixels of a row from right to left */
+#define UCG_WINDOW_MIRROR_Y 2		/* the rows from bottom to top */
+
 
 #define UCG_COM_STATUS_MASK_POWER 8
 #define UCG_COM_STATUS_MASK_RESET 4
@@ -656,6 +710,7 @@ void ucg_UndoRotate(ucg_t *ucg);
 void ucg_SetRotate90(ucg_t *ucg);
 void ucg_SetRotate180(ucg_t *ucg);
 void ucg_SetRotate270(ucg_t *ucg);
+void ucg_GetRotatedClipBox(ucg_t *ucg, ucg_box_t *box);
 
 /*================================================*/
 /* ucg_scale.c */
@@ -761,16 +816,17 @@ size_t ucg_font_GetSize(const _MEMX void *font);
 uint8_t ucg_GetFontBBXWidth(ucg_t *ucg);
 uint8_t ucg_GetFontBBXHeight(ucg_t *ucg);
 uint8_t ucg_GetFontCapitalAHeight(ucg_t *ucg) UCG_NOINLINE; 
-uint8_t ucg_IsGlyph(ucg_t *ucg, uint8_t requested_encoding);
-int8_t ucg_GetGlyphWidth(ucg_t *ucg, uint8_t requested_encoding);
+uint8_t ucg_IsGlyph(ucg_t *ucg, uint16_t requested_encoding);
+int8_t ucg_GetGlyphWidth(ucg_t *ucg, uint16_t requested_encoding);
 
 #define ucg_GetFontAscent(ucg)	((ucg)->font_ref_ascent)
 #define ucg_GetFontDescent(ucg)	((ucg)->font_ref_descent)
 
 /* Drawing procedures */
 
-ucg_int_t ucg_DrawGlyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint8_t encoding);
+ucg_int_t ucg_DrawGlyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint16_t encoding);
 ucg_int_t ucg_DrawString(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, const char *str);
+uint16_t ucg_GetUTF8Char(const char **str);
 
 /* Mode selection/Font assignment */
 
@@ -816,6 +872,8 @@ ucg_int_t ucg_handle_l90tc(ucg_t *ucg, ucg_dev_fnptr dev_cb);
 ucg_int_t ucg_handle_l90se(ucg_t *ucg, ucg_dev_fnptr dev_cb);
 ucg_int_t ucg_handle_l90bf(ucg_t *ucg, ucg_dev_fnptr dev_cb);
 void ucg_handle_l90rl(ucg_t *ucg, ucg_dev_fnptr dev_cb);
+ucg_int_t ucg_handle_dcs_window(ucg_t *ucg, ucg_window_t *window, uint8_t madctl);
+ucg_int_t ucg_handle_write_pixels_16(ucg_t *ucg, ucg_pixels_t *pixels);
 
 
 /*================================================*/
@@ -925,6 +983,7 @@ void ucg_com_SendRepeat3Bytes(ucg_t *ucg, uint16_t cnt, uint8_t *byte_ptr);
 void ucg_com_SendString(ucg_t *ucg, uint16_t cnt, const uint8_t *byte_ptr);
 void ucg_com_SendCmdDataSequence(ucg_t *ucg, uint16_t cnt, const uint8_t *byte_ptr, uint8_t cd_line_status_at_end);
 void ucg_com_SendCmdSeq(ucg_t *ucg, const ucg_pgm_uint8_t *data);
+void ucg_com_SendCmdSeqXY(ucg_t *ucg, const ucg_pgm_uint8_t *data, ucg_int_t x, ucg_int_t y);
 
 
 /*================================================*/
@@ -936,13 +995,65 @@ ucg_int_t ucg_dev_tga(ucg_t *ucg, ucg_int_t msg, void *data);
 
 
 // printing facilities
+#ifndef UCG_PRINT_BUF_LEN
+#define UCG_PRINT_BUF_LEN  40                    //!< maximum number of characters printed by ucg_Print
+#endif
+
 void  ucg_GetPrintPos(ucg_t *ucg, ucg_int_t *x, ucg_int_t *y);
 void  ucg_SetPrintPos(ucg_t *ucg, ucg_int_t x, ucg_int_t y);
 void  ucg_SetPrintDir(ucg_t *ucg, uint8_t dir);
 int   ucg_Print(ucg_t *ucg, char *fmt, ...);
 void  ucg_PrintInit(ucg_t *ucg);
 
+// text field facilities
+#ifndef UCG_TEXTFIELD_LEN
+#define UCG_TEXTFIELD_LEN  16                    //!< maximum number of glyphs in a text field
+#endif
+
+//!< Struct for a text field that only redraws the glyphs that are changed
+typedef struct {
+  const _MEMX unsigned char *font;               //!< font of the drawn text (NULL if nothing is drawn)
+  ucg_int_t  x;                                  //!< x coordinate of the reference point
+  ucg_int_t  y;                                  //!< y coordinate of the reference point
+  uint8_t    dir;                                //!< direction of the text
+  uint8_t    len;                                //!< number of drawn glyphs
+  int8_t     top;                                //!< upper edge of the glyph cells above the baseline
+  int8_t     height;                             //!< height of the glyph cells
+  uint16_t   text[UCG_TEXTFIELD_LEN];            //!< encoding of each drawn glyph
+  ucg_int_t  pos[UCG_TEXTFIELD_LEN+1];           //!< offset of each glyph cell, pos[len] is the end of the text
+} ucg_textfield_t;
+
+void      ucg_InitTextField(ucg_textfield_t *tf, ucg_int_t x, ucg_int_t y, uint8_t dir);
+ucg_int_t ucg_UpdateTextField(ucg_t *ucg, ucg_textfield_t *tf, const char *str);
+int       ucg_PrintTextField(ucg_t *ucg, ucg_textfield_t *tf, char *fmt, ...);
+void      ucg_ClearTextField(ucg_t *ucg, ucg_textfield_t *tf);
+
 // bitmap facilities
+#ifndef UCG_BMP_STREAM_PIXELS
+#define UCG_BMP_STREAM_PIXELS  16                //!< number of pixels buffered by a bitmap stream
+#endif
+#define UCG_BMP_STREAM_REPEAT  4                 //!< minimal run of one color that is sent as repeat
+
+//!< Struct for a stream of pixels to a clipped (rotated) bitmap, see ucg_OpenBmpStream()
+typedef struct {
+  ucg_int_t  x;                                  //!< x-position of the bitmap
+  ucg_int_t  y;                                  //!< y-position of the bitmap
+  uint8_t    dir;                                //!< direction of the bitmap
+  ucg_int_t  w;                                  //!< width of the bitmap
+  ucg_int_t  c0;                                 //!< first visible column of the bitmap
+  ucg_int_t  r0;                                 //!< first visible row of the bitmap
+  ucg_int_t  c1;                                 //!< last visible column of the bitmap (exclusive)
+  ucg_int_t  r1;                                 //!< last visible row of the bitmap (exclusive)
+  ucg_int_t  c;                                  //!< column of the next pixel
+  ucg_int_t  r;                                  //!< row of the next pixel
+  uint8_t    n;                                  //!< number of buffered pixels
+  uint8_t    buf[UCG_BMP_STREAM_PIXELS*3];       //!< buffered pixels
+  ucg_window_t win;                              //!< window of the visible part (or of a row with dir 1 and 3)
+  uint8_t    sw;                                 //!< 1 if the window is not supported, the pixels are drawn one by one
+  ucg_int_t  wc;                                 //!< column of the next pixel in the window (sw is 1)
+  ucg_int_t  wr;                                 //!< row of the next pixel in the window (sw is 1)
+} ucg_bmp_stream_t;
+
 void  ucg_DrawBmp(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset,
                   ucg_int_t delay,
                   ucg_int_t width, ucg_int_t height,
@@ -953,11 +1064,160 @@ void  ucg_DrawBmpRotate(ucg_t *ucg, ucg_int_t xoffset, ucg_int_t yoffset, ucg_in
                         uint8_t nbytes, const __memx uint8_t *bitmap);
 void ucg_DrawBmpLine(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset, ucg_int_t dir,
                      ucg_int_t nbytes, uint8_t *bitLine);
+uint8_t ucg_OpenBmpWindow(ucg_t *ucg, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h);
+void ucg_CloseBmpWindow(ucg_t *ucg);
+uint8_t ucg_OpenBmpStream(ucg_t *ucg, ucg_bmp_stream_t *s, ucg_int_t x, ucg_int_t y,
+                          uint8_t dir, ucg_int_t w, ucg_int_t h);
+void ucg_WriteBmpPixels(ucg_t *ucg, ucg_bmp_stream_t *s, uint16_t cnt, uint8_t *rgb);
+void ucg_CloseBmpStream(ucg_t *ucg, ucg_bmp_stream_t *s);
+// compressed bitmap facilities
+void ucg_DrawCBmp(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, const __memx uint8_t *cbmp);
+// indexed-color bitmap facilities
+void ucg_DrawIBmp(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, const __memx uint8_t *ibmp);
+// strip buffer facilities
+#define UCG_STRIP_BUF_SIZE(width, lines)  ((width)*(lines)*2)   //!< bytes of a strip buffer (RGB 565)
+
+//!< Struct for a strip buffer, see ucg_SetStrip()
+typedef struct _ucg_strip_t {
+  uint8_t   *buf;                                //!< the strip, RGB 565 (2 bytes per pixel)
+  uint8_t    lines;                              //!< number of lines of a strip
+  ucg_int_t  width;                              //!< width of the strip (width of the display)
+  ucg_int_t  height;                             //!< height of the display
+  ucg_int_t  y;                                  //!< first line of the current strip, -1 if not drawing
+  uint8_t    alpha;                              //!< alpha of the drawing functions, 255: opaque
+  ucg_box_t  clip;                               //!< clip box
+  ucg_box_t  page;                               //!< visible part of the current strip
+  ucg_window_t window;                           //!< window of UCG_MSG_SET_WINDOW
+  ucg_int_t  wc;                                 //!< column of the next pixel in the window
+  ucg_int_t  wr;                                 //!< row of the next pixel in the window
+  ucg_dev_fnptr chain_device_cb;                 //!< device callback of the display
+} ucg_strip_t;
+
+void    ucg_SetStrip(ucg_t *ucg, ucg_strip_t *st, uint8_t *buf, uint8_t lines);
+void    ucg_UndoStrip(ucg_t *ucg);
+void    ucg_SetAlpha(ucg_t *ucg, uint8_t alpha);
+void    ucg_FirstPage(ucg_t *ucg);
+uint8_t ucg_NextPage(ucg_t *ucg);
+// dirty rectangle facilities
+#define UCG_DIRTY_RECTS     8                    //!< number of dirty rectangles
+#define UCG_DIRTY_COST      64                   //!< cost of a rectangle (window and draw call) in pixels
+
+typedef void (*ucg_dirty_fnptr)(ucg_t *ucg);     //!< function that draws the screen
+
+//!< Struct for the dirty rectangles, see ucg_SetDirty()
+typedef struct _ucg_dirty_t {
+  ucg_box_t  rect[UCG_DIRTY_RECTS];              //!< the dirty rectangles
+  uint8_t    cnt;                                //!< number of dirty rectangles
+  uint32_t   marked_sum;                         //!< pixels marked since the last flush
+  uint8_t    regions;                            //!< statistics of the last flush: rectangles drawn
+  uint32_t   marked;                             //!< statistics of the last flush: pixels marked
+  uint32_t   pixels;                             //!< statistics of the last flush: pixels drawn
+} ucg_dirty_t;
+
+void     ucg_SetDirty(ucg_t *ucg, ucg_dirty_t *d);
+void     ucg_MarkDirty(ucg_t *ucg, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h);
+void     ucg_MarkAllDirty(ucg_t *ucg);
+uint32_t ucg_FlushDirty(ucg_t *ucg, ucg_dirty_fnptr draw);
+
+// display list facilities
+//!< Struct for a display list, see ucg_InitDList()
+typedef struct _ucg_dlist_t {
+  uint8_t   *buf;                                //!< the items
+  uint16_t   size;                               //!< size of the buffer
+  uint16_t   len;                                //!< bytes of the items
+  uint8_t    overflow;                           //!< 1 if an item didn't fit in the buffer
+  uint8_t    rgb[3];                             //!< color of the next item
+} ucg_dlist_t;
+
+void    ucg_InitDList(ucg_dlist_t *dl, uint8_t *buf, uint16_t size);
+void    ucg_DListColor(ucg_dlist_t *dl, uint8_t r, uint8_t g, uint8_t b);
+uint8_t ucg_DListBox(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h);
+uint8_t ucg_DListFrame(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h);
+uint8_t ucg_DListRBox(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h, ucg_int_t r);
+uint8_t ucg_DListLine(ucg_dlist_t *dl, ucg_int_t x1, ucg_int_t y1, ucg_int_t x2, ucg_int_t y2);
+uint8_t ucg_DListText(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, const ucg_fntpgm_uint8_t *font, const char *str);
+uint8_t ucg_DListIBmp(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, const __memx uint8_t *ibmp);
+void    ucg_DrawDList(ucg_t *ucg, const ucg_dlist_t *dl);
+void    ucg_DiffDList(ucg_t *ucg, const ucg_dlist_t *prev, const ucg_dlist_t *next);
+
+// tile map facilities
+#ifndef UCG_TILE_SPRITES
+#define UCG_TILE_SPRITES    4                    //!< number of sprites of a tile map
+#endif
+#ifndef UCG_TILE_COLORS
+#define UCG_TILE_COLORS     8                    //!< number of attribute colors of a tile map
+#endif
+#define UCG_TILE_MAX_WIDTH  32                   //!< maximum width of a tile in pixels
+#define UCG_TILE_NONE       0xff                 //!< index of an empty tile or a hidden sprite
+
+//!< Struct for a tile of a tile map
+typedef struct {
+  uint8_t    index;                              //!< index of the tile in the sheet
+  uint8_t    attr;                               //!< attribute, the color of the transparent pixels
+  uint8_t    dirty;                              //!< 1 if the tile must be drawn again
+} ucg_tile_t;
+
+//!< Struct for a sprite of a tile map
+typedef struct {
+  ucg_int_t  x;                                  //!< x-position relative to the map
+  ucg_int_t  y;                                  //!< y-position relative to the map
+  uint8_t    index;                              //!< index of the tile in the sheet, UCG_TILE_NONE is hidden
+} ucg_sprite_t;
+
+//!< Struct for a tile map, see ucg_InitTileMap()
+typedef struct {
+  ucg_int_t  x;                                  //!< x-position of the map
+  ucg_int_t  y;                                  //!< y-position of the map
+  uint8_t    cols;                               //!< number of tiles in a row
+  uint8_t    rows;                               //!< number of rows
+  ucg_tile_t *map;                               //!< the tiles (cols*rows)
+  ucg_int_t  tw;                                 //!< width of a tile
+  ucg_int_t  th;                                 //!< height of a tile
+  uint8_t    count;                              //!< number of tiles in the sheet
+  uint8_t    bpp;                                //!< bits per pixel of the sheet
+  uint8_t    transparent;                        //!< 1 if the sheet has a transparent index
+  uint8_t    tindex;                             //!< the transparent index
+  uint16_t   stride;                             //!< bytes per row of the sheet
+  const __memx uint8_t *pixels;                  //!< first row of the sheet
+  uint8_t    lut[16][3];                         //!< palette of the sheet
+  uint8_t    colors[UCG_TILE_COLORS][3];         //!< colors of the attributes
+  ucg_sprite_t sprite[UCG_TILE_SPRITES];         //!< the sprites
+} ucg_tilemap_t;
+
+uint8_t  ucg_InitTileMap(ucg_tilemap_t *tm, ucg_int_t x, ucg_int_t y, uint8_t cols, uint8_t rows,
+                         ucg_tile_t *map, const __memx uint8_t *sheet, ucg_int_t th);
+void     ucg_SetTile(ucg_tilemap_t *tm, uint8_t col, uint8_t row, uint8_t index, uint8_t attr);
+void     ucg_SetTileColor(ucg_tilemap_t *tm, uint8_t attr, uint8_t r, uint8_t g, uint8_t b);
+void     ucg_SetSprite(ucg_tilemap_t *tm, uint8_t n, ucg_int_t x, ucg_int_t y, uint8_t index);
+void     ucg_InvalidateTileMap(ucg_tilemap_t *tm);
+uint16_t ucg_DrawTileMap(ucg_t *ucg, ucg_tilemap_t *tm);
 // bitmap facilities (obsolete)
 void  ucg_BitmapPrint(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset,
                       ucg_int_t width, ucg_int_t height,
                       uint8_t ncolors, const __memx uint8_t *bitmap);
 
+// label facilities
+ucg_int_t ucg_DrawLabel(ucg_t *ucg, ucg_int_t x, ucg_int_t y, const __memx uint8_t *label);
+#define ucg_GetLabelWidth(label)   ((ucg_int_t)(label)[0])
+#define ucg_GetLabelHeight(label)  ((ucg_int_t)(label)[1])
+
+// anti-aliased font facilities
+//!< Struct for the current anti-aliased font and its color ramp, see ucg_SetAAFont()
+typedef struct _ucg_aafont_t {
+  const _MEMX uint8_t *font;                     //!< current anti-aliased font
+  uint8_t      bpp;                              //!< bits per pixel of the current font
+  uint8_t      is_ramp;                          //!< 1 if the color ramp is valid
+  ucg_color_t  fg;                               //!< foreground color of the color ramp
+  ucg_color_t  bg;                               //!< background color of the color ramp
+  uint8_t      ramp[16][3];                      //!< color of each gray level
+} ucg_aafont_t;
+
+void      ucg_SetAAFont(ucg_t *ucg, ucg_aafont_t *aa, const ucg_fntpgm_uint8_t *font);
+ucg_int_t ucg_GetAAGlyphWidth(ucg_t *ucg, uint16_t encoding);
+ucg_int_t ucg_GetAAStrWidth(ucg_t *ucg, const char *str);
+ucg_int_t ucg_DrawAAGlyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint16_t encoding);
+ucg_int_t ucg_DrawAAString(ucg_t *ucg, ucg_int_t x, ucg_int_t y, const char *str);
+
 
 /*================================================*/
 
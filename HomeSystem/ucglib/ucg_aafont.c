@@ -0,0 +1,240 @@
+/*!
+ *  \file    ucg_aafont.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Anti-aliased fonts for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           The fonts of ucglib use one bit per pixel. Large glyphs look harsh on an
+ *           18-bit display. An anti-aliased font uses 2 or 4 bits per pixel (a gray level).
+ *           Every gray level is mapped on a color between the background color
+ *           (index 1) and the foreground color (index 0). This color ramp (4 or 16 colors)
+ *           is calculated once for a combination of colors.
+ *
+ *           A glyph is drawn in one window with ucg_OpenBmpStream(). The glyph box is
+ *           always drawn solid with the background color. Only the direction
+ *           left->right is supported. The y-position is the baseline.
+ *
+ *           The fonts are generated by tools/ucg_aafont.py from a TTF/OTF or a BDF font.
+ *           The font data format is:
+ *  \verbatim
+    offset  bytes  description
+    0       1      bits per pixel (2 or 4)
+    1       1      number of glyphs
+    2       1      ascent, rows above the baseline
+    3       1      descent, rows below the baseline
+    4              glyphs, ordered by encoding
+
+    glyph:
+    0       1      encoding
+    1       2      size of the glyph data (high byte first), 0 is the end of the font
+    3       1      width of the glyph box
+    4       1      height of the glyph box
+    5       1      x-offset of the glyph box (signed)
+    6       1      top of the glyph box above the baseline (signed)
+    7       1      advance (delta x)
+    8              run-length coded gray levels, from left to right and top to bottom:
+                   one byte is (run length - 1) in the upper bits and the gray level
+                   in the lower 2 or 4 bits \endverbatim
+ *
+ *           The font is placed in the program memory (ucg_fntpgm_uint8_t), so with __memx
+ *           the complete program space can be used.
+ *           The current font and its color ramp are kept in a struct ucg_aafont_t of
+ *           the caller, every display has its own:
+ *  \code
+    static ucg_aafont_t aa;
+
+    ucg_SetAAFont(&ucg, &aa, my_aafont);
+    ucg_DrawAAString(&ucg, 10, 40, "21.4"); \endcode
+ */
+
+#include <string.h>
+#include "ucg.h"
+
+#define UCG_AAFONT_HEADER_SIZE  4      //!< size of the header of an anti-aliased font
+#define UCG_AAFONT_GLYPH_SIZE   8      //!< size of the header of a glyph
+
+static const _MEMX uint8_t *_ucg_aa_get_glyph(ucg_t *ucg, uint16_t encoding);
+static void   _ucg_aa_update_ramp(ucg_t *ucg);
+
+/*! \brief  Sets the anti-aliased font
+ *
+ *          The other functions of the anti-aliased fonts need this function first.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  aa       pointer to struct for the font and the color ramp of this display
+ *  \param  font     pointer to the anti-aliased font
+ *
+ *  \return void
+ */
+void ucg_SetAAFont(ucg_t *ucg, ucg_aafont_t *aa, const ucg_fntpgm_uint8_t *font)
+{
+  aa->font    = font;
+  aa->bpp     = ucg_pgm_read( _PGM_pointer font );
+  aa->is_ramp = 0;
+  ucg->aafont = aa;
+}
+
+/*! \brief  Gets the advance (delta x) of a glyph of the anti-aliased font
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  encoding the encoding of the glyph
+ *
+ *  \return the advance or 0 if the glyph is not in the font
+ */
+ucg_int_t ucg_GetAAGlyphWidth(ucg_t *ucg, uint16_t encoding)
+{
+  const _MEMX uint8_t *glyph = _ucg_aa_get_glyph(ucg, encoding);
+
+  if ( glyph == NULL ) return 0;
+
+  return ucg_pgm_read( (_PGM_pointer glyph) + 7 );
+}
+
+/*! \brief  Gets the width of a string with the anti-aliased font
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  str      the string (UTF-8)
+ *
+ *  \return the sum of the advances of the glyphs
+ */
+ucg_int_t ucg_GetAAStrWidth(ucg_t *ucg, const char *str)
+{
+  ucg_int_t w = 0;
+
+  while ( *str != '\0' ) {
+    w += ucg_GetAAGlyphWidth(ucg, ucg_GetUTF8Char(&str));
+  }
+
+  return w;
+}
+
+/*! \brief  Draws a glyph of the anti-aliased font
+ *
+ *          The glyph box is drawn in one window. The pixels are a blend of the
+ *          foreground color (index 0) and the background color (index 1).
+ *          The glyph box is clipped to the clip box of the display.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  x        the x-position of the glyph
+ *  \param  y        the y-position of the baseline
+ *  \param  encoding the encoding of the glyph
+ *
+ *  \return the advance (delta x) of the glyph
+ */
+ucg_int_t ucg_DrawAAGlyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint16_t encoding)
+{
+  const _MEMX uint8_t *glyph = _ucg_aa_get_glyph(ucg, encoding);
+  ucg_aafont_t     *aa = ucg->aafont;
+  ucg_bmp_stream_t  s;
+  uint8_t    w, h, adv, b, mask;
+
+  if ( glyph == NULL ) return 0;
+
+  w   = ucg_pgm_read( (_PGM_pointer glyph) + 3 );
+  h   = ucg_pgm_read( (_PGM_pointer glyph) + 4 );
+  x  += (int8_t) ucg_pgm_read( (_PGM_pointer glyph) + 5 );
+  y  -= (int8_t) ucg_pgm_read( (_PGM_pointer glyph) + 6 );
+  adv = ucg_pgm_read( (_PGM_pointer glyph) + 7 );
+
+  if ( ! ucg_OpenBmpStream(ucg, &s, x, y, 0, w, h) ) return adv;
+
+  _ucg_aa_update_ramp(ucg);
+  mask   = (1 << aa->bpp) - 1;
+  glyph += UCG_AAFONT_GLYPH_SIZE;
+
+  while ( s.r < s.r1 ) {
+    b = ucg_pgm_read( _PGM_pointer glyph );
+    glyph++;
+    ucg_WriteBmpPixels(ucg, &s, (b >> aa->bpp) + 1, aa->ramp[b & mask]);
+  }
+
+  ucg_CloseBmpStream(ucg, &s);
+
+  return adv;
+}
+
+/*! \brief  Draws a string with the anti-aliased font
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  x        the x-position of the string
+ *  \param  y        the y-position of the baseline
+ *  \param  str      the string (UTF-8)
+ *
+ *  \return the width of the string
+ */
+ucg_int_t ucg_DrawAAString(ucg_t *ucg, ucg_int_t x, ucg_int_t y, const char *str)
+{
+  ucg_int_t delta, sum = 0;
+
+  while ( *str != '\0' ) {
+    delta = ucg_DrawAAGlyph(ucg, x, y, ucg_GetUTF8Char(&str));
+    x   += delta;
+    sum += delta;
+  }
+
+  return sum;
+}
+
+
+// local functions
+
+/*  brief  Finds the data of a glyph in the current anti-aliased font
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  encoding the encoding of the glyph
+ *
+ *  return pointer to the glyph or NULL if the glyph is not in the font
+ */
+static const _MEMX uint8_t *_ucg_aa_get_glyph(ucg_t *ucg, uint16_t encoding)
+{
+  const _MEMX uint8_t *glyph;
+  uint16_t size;
+
+  if ( ucg->aafont == NULL ) return NULL;
+  glyph = ucg->aafont->font;
+  if ( (glyph == NULL) || (encoding > 0xff) ) return NULL;
+
+  glyph += UCG_AAFONT_HEADER_SIZE;
+  for (;;) {
+    size  = ucg_pgm_read( (_PGM_pointer glyph) + 1 ) << 8;
+    size |= ucg_pgm_read( (_PGM_pointer glyph) + 2 );
+    if ( size == 0 ) break;
+    if ( ucg_pgm_read( _PGM_pointer glyph ) == encoding ) return glyph;
+    glyph += size;
+  }
+
+  return NULL;
+}
+
+/*  brief  Calculates the color ramp from the background color (index 1)
+ *         to the foreground color (index 0) if the colors are changed
+ *
+ *  param  ucg      pointer to struct for the display
+ *
+ *  return void
+ */
+static void _ucg_aa_update_ramp(ucg_t *ucg)
+{
+  ucg_aafont_t *aa = ucg->aafont;
+  uint8_t  levels, i, j;
+  int16_t  d;
+
+  if ( aa->is_ramp &&
+       (memcmp(aa->fg.color, ucg->arg.rgb[0].color, 3) == 0) &&
+       (memcmp(aa->bg.color, ucg->arg.rgb[1].color, 3) == 0) ) return;
+
+  aa->fg = ucg->arg.rgb[0];
+  aa->bg = ucg->arg.rgb[1];
+  levels = (1 << aa->bpp) - 1;
+  for (j = 0; j < 3; j++) {
+    d = (int16_t) aa->fg.color[j] - aa->bg.color[j];
+    for (i = 0; i <= levels; i++) {
+      aa->ramp[i][j] = aa->bg.color[j] + (d * i) / levels;
+    }
+  }
+  aa->is_ramp = 1;
+}
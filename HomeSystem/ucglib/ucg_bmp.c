@@ -1,8 +1,8 @@
 /*!
  *  \file    ucg_bmp.c
  *  \author  Wim Dolman (<a href="mailto:w.e.dolman@hva.nl">w.e.dolman@hva.nl</a>)
- *  \date    30-09-2020
- *  \version 4.0
+ *  \date    19-10-2026
+ *  \version 4.2
  *
  *  \brief   Bitmap facilities for ucglib from Oli Kraus
  *
@@ -31,11 +31,12 @@
  *           functions, the commandsrings are relative small and the fonts can be large.
  *           A __memx based use_fonts.c  must be used. 
  *
- *           The function ucg_DrawBmpLine() and ucg_DrawBmp() use commandstrings that are
- *           dependent of the display type. In this case the four commandstrings for ST7735 
- *           are used, which are declared in ucg_dev_ic_st7735.c.
- *           It is better to use and problaby change display callback functions.
- *           So you can use this solution with every display.
+ *           The bitmaps are drawn in a window of the display with the messages
+ *           UCG_MSG_SET_WINDOW, UCG_MSG_WRITE_PIXELS and UCG_MSG_END_WINDOW of the
+ *           device callback, so every ucg_dev_ic_*.c driver can draw them. The pixels
+ *           are sent as 3 bytes RGB, the 16-bit controllers convert them to RGB 565.
+ *           If the controller (or the rotation) doesn't support a window, the pixels
+ *           are drawn one by one with UCG_MSG_DRAW_PIXEL.
  * 
  *           Originally these functionality was added in the Xmega Hardware Abstraction 
  *           Layer (version 2.0, 2.1 and 3.0). From vesion 4.0 this functionality is 
@@ -116,7 +117,7 @@ void  ucg_BitmapPrint(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset,
 }
 
 /*!
- *    \defgroup group-1 extern consts
+ *    \defgroup group-1 window messages
  *    \remark about the improved bitmap rendering
  *
  *    The function ucg_BitmapPrint prints the bitmap pixel by pixel
@@ -124,21 +125,12 @@ void  ucg_BitmapPrint(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset,
  *    ucg_BitmapPrint prints the bitmap line by line.
  *    The idea of the improved bitmap rendering is borrowed from:
  *       https://p3dt.net/post/2018/12/27/esp8266-ili9846-improved.html
- *    The new functions should actually be added to devices files
- *    ucg_dev_ic_XXXX.c.
- *    In this case the functions for ST7735 are added to ucg_bmp.c. These
- *    functions need four constants, which are declared in ucg_dev_ic_st7735.c.
- *   
+ *    Until version 4.1 the functions for ST7735 were added to ucg_bmp.c,
+ *    with the command sequences of ucg_dev_ic_st7735.c. Since version 4.2
+ *    the devices files ucg_dev_ic_XXXX.c handle the window messages
+ *    (UCG_MSG_SET_WINDOW, UCG_MSG_WRITE_PIXELS and UCG_MSG_END_WINDOW),
+ *    ucg_bmp.c doesn't depend on the display type anymore.
  */
- /*!
- *   \addtogroup group-1
- * @{
- */
-extern const ucg_pgm_uint8_t ucg_st7735_set_pos_dir0_seq[]; //!< extern const from ucg_dev_ic_st7735.c for printing left->right 
-extern const ucg_pgm_uint8_t ucg_st7735_set_pos_dir1_seq[]; //!< extern const from ucg_dev_ic_st7735.c for printing top->bottom
-extern const ucg_pgm_uint8_t ucg_st7735_set_pos_dir2_seq[]; //!< extern const from ucg_dev_ic_st7735.c for printing right->left
-extern const ucg_pgm_uint8_t ucg_st7735_set_pos_dir3_seq[]; //!< extern const from ucg_dev_ic_st7735.c for printing bottom->top
-/*! @} */
 
 //  Development remark about new bitmap functions 
 //  
@@ -147,15 +139,232 @@ extern const ucg_pgm_uint8_t ucg_st7735_set_pos_dir3_seq[]; //!< extern const fr
 //  assignment bitmap++; is ok, but the aasignment bitmap += bmpLineLength; 
 //  is not OK. So the bitmap are always scanned byte by byte even if 
 //  a part of the bitmap is outside the display.
+//
+//  Since version 4.1 the invisible parts of a bitmap are skipped with an
+//  offset (bitmap += offset), like the font functions of ucglib do. avr-gcc
+//  adds an integer to a __memx pointer in its 16-bit sizetype: a wider
+//  offset is truncated. So the offsets are calculated with 16-bit integers
+//  (uint16_t) and a bitmap must be smaller than 64K. A bitmap is one array,
+//  so it is smaller than 32K (the largest AVR variable) anyway. The bitmap
+//  itself may be placed beyond 64K, the pointer keeps its 24 bits.
+//  ucg_DrawBmp() and ucg_DrawBmpRotate() use the clipping of the bitmap
+//  stream: only the rows and columns inside the clip box are read.
 
-/*! \brief  Draws a bitmap line to the display 
+static void _ucg_bmp_window(ucg_t *ucg, ucg_bmp_stream_t *s, ucg_int_t x, ucg_int_t y,
+                            ucg_int_t w, ucg_int_t h, uint8_t scan);
+static void _ucg_bmp_end_window(ucg_t *ucg, ucg_bmp_stream_t *s);
+static void _ucg_bmp_write(ucg_t *ucg, ucg_bmp_stream_t *s, uint16_t cnt, uint8_t *rgb, uint8_t repeat);
+static void _ucg_bmp_stream_row(ucg_t *ucg, ucg_bmp_stream_t *s);
+static void _ucg_bmp_stream_flush(ucg_t *ucg, ucg_bmp_stream_t *s);
+static void _ucg_bmp_send(ucg_t *ucg, ucg_bmp_stream_t *s, const __memx uint8_t *bitmap, uint16_t nbytes);
+
+/*! \brief  Opens a window on the display for a stream of pixels
+ *
+ *          The pixels (3 bytes RGB) are sent with the message UCG_MSG_WRITE_PIXELS
+ *          (see ucg_pixels_t) from left to right and from top to bottom.
+ *          The window must be inside the display, there is no clipping.
+ *          The stream is finished with ucg_CloseBmpWindow().
  *
  *  \param  ucg      pointer to struct for the display
- *  \param  xoffset  the x-position of the upper left corner of the bitmap line
- *  \param  yoffset  the y-position of the upper left corner of the bitmap line
+ *  \param  x        the x-position of the upper left corner of the window
+ *  \param  y        the y-position of the upper left corner of the window
+ *  \param  w        the width of the window in pixels
+ *  \param  h        the height of the window in pixels
+ *
+ *  \return 0 if the display doesn't support a window, no window is opened
+ */
+uint8_t ucg_OpenBmpWindow(ucg_t *ucg, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h)
+{
+  ucg_window_t  win;
+
+  win.box.ul.x   = x;
+  win.box.ul.y   = y;
+  win.box.size.w = w;
+  win.box.size.h = h;
+  win.scan       = 0;
+
+  return ucg->device_cb(ucg, UCG_MSG_SET_WINDOW, &win) != 0;
+}
+
+/*! \brief  Closes a window that is opened with ucg_OpenBmpWindow()
+ *
+ *  \param  ucg      pointer to struct for the display
+ *
+ *  \return void
+ */
+void ucg_CloseBmpWindow(ucg_t *ucg)
+{
+  ucg->device_cb(ucg, UCG_MSG_END_WINDOW, NULL);
+}
+
+/*! \brief  Opens a stream for a (rotated) bitmap
+ *
+ *          The pixels of the complete bitmap are written with ucg_WriteBmpPixels() 
+ *          from left to right and from top to bottom of the bitmap. The bitmap is 
+ *          clipped to the clip box of the display, the stream drops the invisible 
+ *          pixels. The writer can stop when <code>s->r >= s->r1</code>, the remaining 
+ *          pixels are not visible. The stream is finished with ucg_CloseBmpStream().
+ *
+ *          The position and direction are the same as in ucg_DrawBmpRotate(): pixel 
+ *          (column c, row r) of the bitmap is drawn at
+ *          -# dir 0: (x+c, y+r) 
+ *          -# dir 1: (x+r, y-1-c) 
+ *          -# dir 2: (x-1-c, y-1-r) 
+ *          -# dir 3: (x-r, y+c) 
+ *
+ *          With dir 0 and 2 the visible part is drawn in one window (dir 2 with
+ *          mirrored scan order), with dir 1 and 3 every row of the bitmap is a
+ *          column on the display with its own window. If the display doesn't
+ *          support the window, the pixels are drawn one by one.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  s        pointer to struct for the stream
+ *  \param  x        the x-position of the bitmap
+ *  \param  y        the y-position of the bitmap
  *  \param  dir      the direction of the bitmap
  *                   0 (normal), 1 (+90*), 2 (180*) or 3 (270*)
- *  \param  nbytes   the number of bytes to be sent
+ *  \param  w        the width of the bitmap in pixels
+ *  \param  h        the height of the bitmap in pixels
+ *
+ *  \return 0 if the bitmap is not visible, no window is opened 
+ */
+uint8_t ucg_OpenBmpStream(ucg_t *ucg, ucg_bmp_stream_t *s, ucg_int_t x, ucg_int_t y, 
+                          uint8_t dir, ucg_int_t w, ucg_int_t h)
+{
+  ucg_box_t  clip;
+  ucg_int_t  cx0, cy0, cx1, cy1;
+
+  ucg_GetRotatedClipBox(ucg, &clip);             // the clip box of the (rotated) display
+  cx0 = clip.ul.x;
+  cy0 = clip.ul.y;
+  cx1 = cx0 + clip.size.w;
+  cy1 = cy0 + clip.size.h;
+
+  s->x   = x;
+  s->y   = y;
+  s->dir = dir & 3;
+  s->w   = w;
+  s->c   = 0;
+  s->r   = 0;
+  s->n   = 0;
+
+  // visible part in the coordinates of the bitmap
+  switch(s->dir) {
+    case 0:  s->c0 = cx0 - x;     s->c1 = cx1 - x;     s->r0 = cy0 - y;     s->r1 = cy1 - y;     break;
+    case 1:  s->c0 = y - cy1;     s->c1 = y - cy0;     s->r0 = cx0 - x;     s->r1 = cx1 - x;     break;
+    case 2:  s->c0 = x - cx1;     s->c1 = x - cx0;     s->r0 = y - cy1;     s->r1 = y - cy0;     break;
+    default: s->c0 = cy0 - y;     s->c1 = cy1 - y;     s->r0 = x - cx1 + 1; s->r1 = x - cx0 + 1; break;
+  }
+  if ( s->c0 < 0 ) s->c0 = 0;
+  if ( s->r0 < 0 ) s->r0 = 0;
+  if ( s->c1 > w ) s->c1 = w;
+  if ( s->r1 > h ) s->r1 = h;
+
+  if ( (s->c0 >= s->c1) || (s->r0 >= s->r1) ) {
+    s->c1 = s->c0;                               // nothing to write
+    s->r1 = 0;
+    return 0;
+  }
+
+  switch(s->dir) {
+    case 0:
+      _ucg_bmp_window(ucg, s, x + s->c0, y + s->r0, s->c1 - s->c0, s->r1 - s->r0, 0);
+      break;
+    case 2:
+      _ucg_bmp_window(ucg, s, x - s->c1, y - s->r1, s->c1 - s->c0, s->r1 - s->r0,
+                      UCG_WINDOW_MIRROR_X | UCG_WINDOW_MIRROR_Y);
+      break;
+    default:
+      _ucg_bmp_stream_row(ucg, s);
+      break;
+  }
+
+  return 1;
+}
+
+/*! \brief  Writes a number of pixels with the same color to a stream
+ *
+ *          Short runs are collected in the buffer of the stream, long runs are sent 
+ *          as one repeated pixel. The pixels that are outside the visible
+ *          part are dropped.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  s        pointer to struct for the stream
+ *  \param  cnt      the number of pixels
+ *  \param  rgb      the color (3 bytes)
+ *
+ *  \return void
+ */
+void ucg_WriteBmpPixels(ucg_t *ucg, ucg_bmp_stream_t *s, uint16_t cnt, uint8_t *rgb)
+{
+  ucg_int_t  k, b, e;
+
+  while ( cnt > 0 ) {
+    k = s->w - s->c;                            // pixels to the end of the row
+    if ( k > cnt ) k = cnt;
+    if ( (s->r >= s->r0) && (s->r < s->r1) ) {
+      b = ( s->c > s->c0 ) ? s->c : s->c0;      // visible part of the run in this row
+      e = ( s->c + k < s->c1 ) ? s->c + k : s->c1;
+      if ( e - b >= UCG_BMP_STREAM_REPEAT ) {
+        _ucg_bmp_stream_flush(ucg, s);
+        _ucg_bmp_write(ucg, s, e - b, rgb, 1);
+      } else {
+        for ( ; b < e; b++) {
+          s->buf[s->n*3]   = rgb[0];
+          s->buf[s->n*3+1] = rgb[1];
+          s->buf[s->n*3+2] = rgb[2];
+          if ( ++s->n == UCG_BMP_STREAM_PIXELS ) {
+            _ucg_bmp_stream_flush(ucg, s);
+          }
+        }
+      }
+    }
+    s->c += k;
+    cnt  -= k;
+    if ( s->c == s->w ) {
+      if ( (s->dir & 1) && (s->r >= s->r0) && (s->r < s->r1) ) {
+        _ucg_bmp_stream_flush(ucg, s);           // end of the window of this row
+        _ucg_bmp_end_window(ucg, s);
+      }
+      s->c = 0;
+      s->r++;
+      if ( s->dir & 1 ) {
+        _ucg_bmp_stream_row(ucg, s);
+      }
+    }
+  }
+}
+
+/*! \brief  Closes a stream that is opened with ucg_OpenBmpStream()
+ *
+ *          The buffered pixels are sent and the window is closed.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  s        pointer to struct for the stream
+ *
+ *  \return void
+ */
+void ucg_CloseBmpStream(ucg_t *ucg, ucg_bmp_stream_t *s)
+{
+  if ( s->c0 >= s->c1 ) return;                // no window opened
+  if ( (s->dir & 1) && ((s->r < s->r0) || (s->r >= s->r1)) ) return;
+
+  _ucg_bmp_stream_flush(ucg, s);
+  _ucg_bmp_end_window(ucg, s);
+}
+
+/*! \brief  Draws a bitmap line to the display 
+ *
+ *          The line is drawn like ucg_DrawHLine() (dir 0 and 2) and ucg_DrawVLine()
+ *          (dir 1 and 3): the first pixel is at (xoffset, yoffset). Since version 4.2
+ *          the line is clipped to the clip box.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  xoffset  the x-position of the first pixel of the bitmap line
+ *  \param  yoffset  the y-position of the first pixel of the bitmap line
+ *  \param  dir      the direction of the line
+ *                   0 (to the right), 1 (down), 2 (to the left) or 3 (up)
+ *  \param  nbytes   the number of bytes to be sent (3 bytes RGB per pixel)
  *  \param  bitLine  the pointer to a const unit8_t array with the bitmap line.
  *
  *  \return void
@@ -163,26 +372,34 @@ extern const ucg_pgm_uint8_t ucg_st7735_set_pos_dir3_seq[]; //!< extern const fr
 void ucg_DrawBmpLine(ucg_t *ucg, ucg_int_t xoffset, ucg_int_t yoffset, ucg_int_t dir, 
                                  ucg_int_t nbytes, uint8_t *bitLine)
 {
-  ucg->arg.pixel.pos.x = xoffset;
-  ucg->arg.pixel.pos.y = yoffset;
-  ucg->arg.dir = dir;
-
-  switch(ucg->arg.dir) {
-    case 0: ucg_com_SendCmdSeq(ucg, ucg_st7735_set_pos_dir0_seq); break;
-    case 1: ucg_com_SendCmdSeq(ucg, ucg_st7735_set_pos_dir1_seq); break;
-    case 2: ucg_com_SendCmdSeq(ucg, ucg_st7735_set_pos_dir2_seq); break;
-    case 3: ucg_com_SendCmdSeq(ucg, ucg_st7735_set_pos_dir3_seq); break;
+  ucg_bmp_stream_t  s;
+  uint8_t    i;
+
+  // the line is a bitmap of one row, see ucg_OpenBmpStream() for the positions
+  switch(dir & 3) {
+    case 0:  i = ucg_OpenBmpStream(ucg, &s, xoffset,     yoffset,     0, nbytes / 3, 1); break;
+    case 1:  i = ucg_OpenBmpStream(ucg, &s, xoffset,     yoffset,     3, nbytes / 3, 1); break;
+    case 2:  i = ucg_OpenBmpStream(ucg, &s, xoffset + 1, yoffset + 1, 2, nbytes / 3, 1); break;
+    default: i = ucg_OpenBmpStream(ucg, &s, xoffset,     yoffset + 1, 1, nbytes / 3, 1); break;
   }
-  ucg_com_SendString(ucg, nbytes, bitLine);
-  ucg_com_SetCSLineStatus(ucg, 1);		/* disable chip */
+  if ( ! i ) return;
+
+  _ucg_bmp_write(ucg, &s, s.c1 - s.c0, bitLine + 3 * s.c0, 0);
+  ucg_CloseBmpStream(ucg, &s);
 }
 
 /*! \brief  Draws a bitmap to the display 
+ *
+ *          The visible part of the bitmap (clipped to the clip box) is drawn in one
+ *          window, all rows are sent in one RAM write. Only the visible rows and
+ *          columns are read, in chunks of UCG_BMP_STREAM_PIXELS pixels, so the
+ *          stack use does not depend on the width of the bitmap.
  *
  *  \param  ucg      pointer to struct for the display
  *  \param  xoffset  the x-position of the upper left corner of the bitmap
  *  \param  yoffset  the y-position of the upper left corner of the bitmap
- *  \param  delay    a delay after each line drawn to get a wipe style
+ *  \param  delay    a delay (in us) after each line drawn to get a wipe style,
+ *                   0 is no delay
  *  \param  width    the width of the bitmap in pixels
  *  \param  height   the height of the bitmap in pixels
  *  \param  nbytes   the number of bytes of one pixel; must always be 3 (RGB)
@@ -214,42 +431,7 @@ void  ucg_DrawBmp(ucg_t *ucg, ucg_int_t xoffset, ucg_int_t yoffset,
                   ucg_int_t width, ucg_int_t height,
                   uint8_t nbytes, const __memx uint8_t *bitmap)
 {
-  ucg_int_t  bmpLine = yoffset;
-  ucg_int_t  bLen = 0;
-  ucg_int_t  bmpLastLine = 0;
-  ucg_int_t  bmpLineLength = nbytes * width;
-  uint8_t    bmp[bmpLineLength];
- 
-  // clip the printed part of bitmap to the display (first point must be in window)
-  bLen         = ((ucg_GetWidth(ucg) - xoffset) > width ) ?  bmpLineLength : nbytes*(ucg_GetWidth(ucg) - xoffset);
-  bmpLastLine  = ((ucg_GetHeight(ucg) - yoffset) > height ) ? height : (ucg_GetHeight(ucg) - yoffset);
-  bmpLastLine += yoffset;
- 
-  ucg->arg.pixel.pos.x = xoffset;
-  ucg->arg.len = bLen;
-  ucg->arg.dir = 0;
-
-  const __memx uint8_t *endBitmap = bitmap + bmpLineLength*height;
-  int i = 0;
-  while ( bitmap < endBitmap ) {
-    if (i < bLen ) {
-      bmp[i] = *bitmap;
-    }
-    i++;
-    bitmap++;   
-    if (i == bLen) {
-      ucg->arg.pixel.pos.y = bmpLine;
-      ucg_com_SendCmdSeq(ucg, ucg_st7735_set_pos_dir0_seq);
-      ucg_com_SendString(ucg, bLen, bmp);
-      ucg_com_SetCSLineStatus(ucg, 1);
-      bmpLine++;
-      if ( bmpLine > bmpLastLine) break;
-      ucg_com_DelayMicroseconds(ucg, delay);
-    } 
-    if ( i == bmpLineLength ) { 
-      i = 0;    
-    }
-  }
+  ucg_DrawBmpRotate(ucg, xoffset, yoffset, 0, delay, width, height, nbytes, bitmap);
 }
 
 /*! \brief  Draws a (rotated) bitmap to the display 
@@ -283,7 +465,7 @@ void  ucg_DrawBmp(ucg_t *ucg, ucg_int_t xoffset, ucg_int_t yoffset,
  *                  __flash. This is because _memx uses a 24-bits pointer and __flash 
  *                  uses a 16-bit pointer.
  *
- *                  This function is a little slower (< 10%) than ucg_DrawBmp
+ *                  ucg_DrawBmp() is this function with dir 0
  *  \return void
  */
 void  ucg_DrawBmpRotate(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset, ucg_int_t  dir,
@@ -291,65 +473,181 @@ void  ucg_DrawBmpRotate(ucg_t *ucg, ucg_int_t xoffset,  ucg_int_t yoffset, ucg_i
                         ucg_int_t width, ucg_int_t height,
                         uint8_t nbytes, const __memx uint8_t *bitmap)
 {
-  ucg_int_t   bmpLine = 0;
-  ucg_int_t   bLen = 0;
-  ucg_int_t   bmpLastLine = 0;
-  ucg_int_t   bmpLineLength = nbytes * width;
-  uint8_t     bmp[bmpLineLength];
- 
-  // clip the printed part of bitmap to the display
-  switch(dir) {
-    case 0:
-    bLen = ((ucg_GetWidth(ucg) - xoffset) > width ) ?  bmpLineLength : nbytes*(ucg_GetWidth(ucg) - xoffset) ;
-    bmpLastLine = ((ucg_GetHeight(ucg) - yoffset) > height ) ? height : (ucg_GetHeight(ucg) - yoffset);
-    break;
-    case 1:
-    bLen = (yoffset > width ) ?  bmpLineLength : nbytes*yoffset ;
-    bmpLastLine = ((ucg_GetWidth(ucg) - xoffset) > height) ? height : (ucg_GetWidth(ucg) - xoffset) ;
-    break;
-    case 2:
-    bLen = (xoffset > width ) ? bmpLineLength : nbytes*xoffset ;
-    bmpLastLine = (yoffset > height ) ? height : yoffset ;
-    break;
-    case 3:
-    default:
-    bLen = ((ucg_GetHeight(ucg) - yoffset) > width ) ?  bmpLineLength : nbytes*(ucg_GetHeight(ucg) - yoffset) ;
-    bmpLastLine = (xoffset > height) ? height : xoffset;
-    break;
-  }
-  
-  // print the bitmap
-  const __memx uint8_t *endBitmap = bitmap + width*height*nbytes;
-  int i = 0;
-  while ( bitmap < endBitmap ) {
-    if (i < bLen ) {
-      bmp[i] = *bitmap;
+  ucg_bmp_stream_t  s;
+  uint16_t   bmpLineLength = (uint16_t) nbytes * width;
+
+  // the stream clips the bitmap and opens the window (dir 0 and 2)
+  if ( ! ucg_OpenBmpStream(ucg, &s, xoffset, yoffset, dir, width, height) ) return;
+
+  // first visible pixel
+  bitmap += (uint16_t) s.r0 * bmpLineLength + (uint16_t) s.c0 * nbytes;
+
+  for (s.r = s.r0; s.r < s.r1; s.r++) {
+    if ( (s.dir & 1) && (s.r > 0) ) {
+      _ucg_bmp_stream_row(ucg, &s);              // row 0 is opened by ucg_OpenBmpStream()
     }
-    i++;
-    bitmap++;   
-    if (i == bLen) {
-      switch(dir) {
-      case 0:
-        ucg_DrawBmpLine(ucg, xoffset, yoffset+bmpLine, 0, bLen, bmp);
-        break;
-      case 1:
-        ucg_DrawBmpLine(ucg, xoffset+bmpLine, ucg_GetHeight(ucg)-yoffset, 3, bLen, bmp);
-        break;
-      case 2:
-        ucg_DrawBmpLine(ucg, ucg_GetWidth(ucg)-xoffset, yoffset-bmpLine-1, 2, bLen, bmp);
-        break;
-      case 3:
-        ucg_DrawBmpLine(ucg, xoffset-bmpLine, yoffset, 1, bLen, bmp);
-        break;
-      }
-      bmpLine++;
-      if ( bmpLine >= bmpLastLine) break;     
-    }  
-    if (i == bmpLineLength) {
-      i = 0;    
+    _ucg_bmp_send(ucg, &s, bitmap, (uint16_t) nbytes * (s.c1 - s.c0));
+    if ( s.dir & 1 ) {
+      _ucg_bmp_end_window(ucg, &s);
     }
-    ucg_com_DelayMicroseconds(ucg, delay);
+    bitmap += bmpLineLength;
+    if ( delay != 0 ) {
+      ucg_com_DelayMicroseconds(ucg, delay);
+    }
+  }
+  if ( !(s.dir & 1) ) {
+    _ucg_bmp_end_window(ucg, &s);
   }
 }
 
 
+// local functions
+
+/*  brief  Opens a window for a stream of pixels
+ *         If the display doesn't support the window, the pixels of the stream
+ *         are drawn one by one.
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  s        pointer to struct for the stream
+ *  param  x        the x-position of the upper left corner of the window
+ *  param  y        the y-position of the upper left corner of the window
+ *  param  w        the width of the window in pixels
+ *  param  h        the height of the window in pixels
+ *  param  scan     the scan order: 0 (from left to right and from top to bottom),
+ *                  UCG_WINDOW_MIRROR_X and/or UCG_WINDOW_MIRROR_Y
+ *
+ *  return void
+ */
+static void _ucg_bmp_window(ucg_t *ucg, ucg_bmp_stream_t *s, ucg_int_t x, ucg_int_t y,
+                            ucg_int_t w, ucg_int_t h, uint8_t scan)
+{
+  s->win.box.ul.x   = x;
+  s->win.box.ul.y   = y;
+  s->win.box.size.w = w;
+  s->win.box.size.h = h;
+  s->win.scan       = scan;
+  s->wc = 0;
+  s->wr = 0;
+  s->sw = ( ucg->device_cb(ucg, UCG_MSG_SET_WINDOW, &s->win) == 0 );
+}
+
+/*  brief  Closes the window of a stream
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  s        pointer to struct for the stream
+ *
+ *  return void
+ */
+static void _ucg_bmp_end_window(ucg_t *ucg, ucg_bmp_stream_t *s)
+{
+  if ( ! s->sw ) {
+    ucg->device_cb(ucg, UCG_MSG_END_WINDOW, NULL);
+  }
+}
+
+/*  brief  Writes pixels to the window of a stream
+ *         Without the support of the display the pixels are drawn one by one
+ *         in the scan order of the window.
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  s        pointer to struct for the stream
+ *  param  cnt      the number of pixels
+ *  param  rgb      the pixels (3 bytes RGB)
+ *  param  repeat   0: cnt pixels in rgb, 1: the pixel in rgb cnt times
+ *
+ *  return void
+ */
+static void _ucg_bmp_write(ucg_t *ucg, ucg_bmp_stream_t *s, uint16_t cnt, uint8_t *rgb, uint8_t repeat)
+{
+  ucg_pixels_t  px;
+  ucg_color_t   oldColor;
+  ucg_int_t     x, y;
+
+  if ( ! s->sw ) {
+    px.rgb    = rgb;
+    px.cnt    = cnt;
+    px.repeat = repeat;
+    ucg->device_cb(ucg, UCG_MSG_WRITE_PIXELS, &px);
+    return;
+  }
+
+  memcpy(oldColor.color, ucg->arg.rgb[0].color, 3);
+  while ( cnt > 0 ) {
+    x = ( s->win.scan & UCG_WINDOW_MIRROR_X ) ? s->win.box.size.w - 1 - s->wc : s->wc;
+    y = ( s->win.scan & UCG_WINDOW_MIRROR_Y ) ? s->win.box.size.h - 1 - s->wr : s->wr;
+    ucg_SetColor(ucg, 0, rgb[0], rgb[1], rgb[2]);
+    ucg_DrawPixel(ucg, s->win.box.ul.x + x, s->win.box.ul.y + y);
+    if ( ++s->wc == s->win.box.size.w ) {
+      s->wc = 0;
+      s->wr++;
+    }
+    if ( ! repeat ) rgb += 3;
+    cnt--;
+  }
+  memcpy(ucg->arg.rgb[0].color, oldColor.color, 3);
+}
+
+/*  brief  Opens the window for the current row of a stream with dir 1 or 3
+ *         A row of the bitmap is a column on the display. Nothing is done if 
+ *         the row is not visible.
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  s        pointer to struct for the stream
+ *
+ *  return void
+ */
+static void _ucg_bmp_stream_row(ucg_t *ucg, ucg_bmp_stream_t *s)
+{
+  ucg_int_t x;
+
+  if ( (s->r < s->r0) || (s->r >= s->r1) ) return;
+
+  if ( s->dir == 1 ) {
+    // upwards: mirrored y
+    x = s->x + s->r;
+    _ucg_bmp_window(ucg, s, x, s->y - s->c1, 1, s->c1 - s->c0, UCG_WINDOW_MIRROR_Y);
+  } else {
+    x = s->x - s->r;
+    _ucg_bmp_window(ucg, s, x, s->y + s->c0, 1, s->c1 - s->c0, 0);
+  }
+}
+
+/*  brief  Sends the buffered pixels of a stream
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  s        pointer to struct for the stream
+ *
+ *  return void
+ */
+static void _ucg_bmp_stream_flush(ucg_t *ucg, ucg_bmp_stream_t *s)
+{
+  if ( s->n > 0 ) {
+    _ucg_bmp_write(ucg, s, s->n, s->buf, 0);
+    s->n = 0;
+  }
+}
+
+/*  brief  Sends bytes of a bitmap in chunks of UCG_BMP_STREAM_PIXELS pixels
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  s        pointer to struct for the stream
+ *  param  bitmap   the pointer to the first byte
+ *  param  nbytes   the number of bytes (3 bytes RGB per pixel)
+ *
+ *  return void
+ */
+static void _ucg_bmp_send(ucg_t *ucg, ucg_bmp_stream_t *s, const __memx uint8_t *bitmap, uint16_t nbytes)
+{
+  uint8_t  buf[UCG_BMP_STREAM_PIXELS*3];
+  uint8_t  i, k;
+
+  while ( nbytes > 0 ) {
+    k = ( nbytes > sizeof(buf) ) ? sizeof(buf) : nbytes;
+    for (i = 0; i < k; i++) {
+      buf[i] = *bitmap;
+      bitmap++;
+    }
+    _ucg_bmp_write(ucg, s, k / 3, buf, 0);
+    nbytes -= k;
+  }
+}
@@ -0,0 +1,144 @@
+/*!
+ *  \file    ucg_cbmp.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Compressed bitmaps for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           A bitmap for ucg_DrawBmp() uses 3 bytes per pixel, a background of
+ *           128x160 pixels is 61 kB. A compressed bitmap uses a format like
+ *           <a href="https://qoiformat.org/">QOI</a>: runs, a cache of 64 recently
+ *           used colors and small differences to the previous color. The ST7735 uses
+ *           6 bits per color component, so the colors are stored with 6 bits per
+ *           component. The gain depends on the image: the tile sheet of the host tests
+ *           (tools/ucg_host/images/tiles.png, flat colors) is 596 instead of 12288
+ *           bytes (20x smaller), an image of a few pixels with many colors
+ *           (many.ppm) gets larger (598 instead of 459 bytes).
+ *
+ *           The bitmaps are generated by tools/ucg_cbmp.py from a PNG or PPM image.
+ *           The format is:
+ *  \verbatim
+    offset  bytes  description
+    0       2      width (high byte first)
+    2       2      height (high byte first)
+    4              pixels, from left to right and top to bottom:
+
+    00iiiiii            color i from the cache
+    01rrggbb            r-2, g-2, b-2 added to the previous color
+    10gggggg rrrrbbbb   g-32 added to green, g-32+r-8 to red and g-32+b-8 to blue
+    11nnnnnn            previous color n+1 times (n < 62)
+    11111110 r g b      color (6 bits per component)
+    11111111 n          previous color n+63 times \endverbatim
+ *
+ *           The previous color starts as black and all colors of the cache are black.
+ *           Every color that is not a run is stored in the cache at position
+ *           (3*r + 5*g + 7*b) % 64. The arithmetic is modulo 64.
+ *
+ *           The bitmap is decoded into a bitmap stream (ucg_OpenBmpStream()), so the
+ *           memory use is bounded and the bitmap can be drawn rotated like
+ *           ucg_DrawBmpRotate().
+ */
+
+#include <string.h>
+#include "ucg.h"
+
+#define UCG_CBMP_HEADER_SIZE  4       //!< size of the header of a compressed bitmap
+#define UCG_CBMP_CACHE_SIZE   64      //!< number of colors in the cache
+
+#define UCG_CBMP_OP_INDEX     0x00    //!< color from the cache
+#define UCG_CBMP_OP_DIFF      0x40    //!< small difference
+#define UCG_CBMP_OP_LUMA      0x80    //!< difference based on green
+#define UCG_CBMP_OP_RUN       0xc0    //!< short run
+#define UCG_CBMP_OP_RGB       0xfe    //!< color
+#define UCG_CBMP_OP_LONG_RUN  0xff    //!< long run
+
+/*! \brief  Draws a compressed bitmap
+ *
+ *          The bitmap is clipped to the clip box. With dir 0 and 2 the visible part
+ *          is drawn in one window. Invisible pixels are decoded, but not sent.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  x        the x-position of the bitmap
+ *  \param  y        the y-position of the bitmap
+ *  \param  dir      the direction of the bitmap
+ *                   0 (normal), 1 (+90*), 2 (180*) or 3 (270*),
+ *                   see ucg_OpenBmpStream() for the position
+ *  \param  cbmp     the pointer to the compressed bitmap (generated by tools/ucg_cbmp.py)
+ *
+ *  \return void
+ */
+void ucg_DrawCBmp(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, const __memx uint8_t *cbmp)
+{
+  ucg_bmp_stream_t  s;
+  uint8_t    cache[UCG_CBMP_CACHE_SIZE][3];
+  uint8_t    px[3];                              // previous color, 6 bits per component
+  uint8_t    rgb[3];                             // previous color for the display
+  uint8_t    op, b, d, i;
+  uint16_t   run;
+  ucg_int_t  w, h;
+
+  w = ((ucg_int_t) cbmp[0] << 8) | cbmp[1];
+  h = ((ucg_int_t) cbmp[2] << 8) | cbmp[3];
+
+  if ( ! ucg_OpenBmpStream(ucg, &s, x, y, dir, w, h) ) return;
+
+  memset(cache, 0, sizeof(cache));
+  memset(px, 0, sizeof(px));
+  memset(rgb, 0, sizeof(rgb));
+  cbmp += UCG_CBMP_HEADER_SIZE;
+
+  while ( s.r < s.r1 ) {
+    op = *cbmp;
+    cbmp++;
+    run = 0;
+
+    if ( op == UCG_CBMP_OP_RGB ) {
+      for (i = 0; i < 3; i++) {
+        px[i] = *cbmp;
+        cbmp++;
+      }
+    } else if ( op == UCG_CBMP_OP_LONG_RUN ) {
+      run = *cbmp + 63;
+      cbmp++;
+    } else {
+      switch ( op & 0xc0 ) {
+        case UCG_CBMP_OP_INDEX:
+          memcpy(px, cache[op], 3);
+          break;
+        case UCG_CBMP_OP_DIFF:
+          px[0] += ((op >> 4) & 3) - 2;
+          px[1] += ((op >> 2) & 3) - 2;
+          px[2] += ( op       & 3) - 2;
+          break;
+        case UCG_CBMP_OP_LUMA:
+          d = (op & 0x3f) - 32;
+          b = *cbmp;
+          cbmp++;
+          px[0] += d + (b >> 4) - 8;
+          px[1] += d;
+          px[2] += d + (b & 0x0f) - 8;
+          break;
+        default:
+          run = (op & 0x3f) + 1;
+          break;
+      }
+    }
+
+    if ( run == 0 ) {
+      // a new color
+      run = 1;
+      for (i = 0; i < 3; i++) {
+        px[i]  &= 0x3f;
+        rgb[i]  = (px[i] << 2) | (px[i] >> 4);
+      }
+      memcpy(cache[(3*px[0] + 5*px[1] + 7*px[2]) & (UCG_CBMP_CACHE_SIZE-1)], px, 3);
+    }
+
+    ucg_WriteBmpPixels(ucg, &s, run, rgb);
+  }
+
+  ucg_CloseBmpStream(ucg, &s);
+}
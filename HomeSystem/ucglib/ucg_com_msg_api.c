@@ -411,3 +411,17 @@ void ucg_com_SendCmdSeq(ucg_t *ucg, const ucg_pgm_uint8_t *data)
   }
 }
 
+/*
+  send a command sequence with two variables: x is used by UCG_VARX and y by UCG_VARY,
+  e.g. the first and last column of a window 
+  the position in ucg->arg.pixel.pos is not changed
+*/
+void ucg_com_SendCmdSeqXY(ucg_t *ucg, const ucg_pgm_uint8_t *data, ucg_int_t x, ucg_int_t y)
+{
+  ucg_xy_t pos = ucg->arg.pixel.pos;
+  ucg->arg.pixel.pos.x = x;
+  ucg->arg.pixel.pos.y = y;
+  ucg_com_SendCmdSeq(ucg, data);
+  ucg->arg.pixel.pos = pos;
+}
+
@@ -50,6 +50,18 @@ ucg_int_t ucg_dev_default_cb(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_SET_CLIP_BOX:
       ucg->clip_box = *(ucg_box_t *)data;
       break;
+    case UCG_MSG_SET_WINDOW:
+      return 0;	/* not supported by the controller */
+    case UCG_MSG_WRITE_PIXELS:
+      /* 18 bit controllers: 3 bytes per pixel */
+      if ( ((ucg_pixels_t *)data)->repeat != 0 )
+	ucg_com_SendRepeat3Bytes(ucg, ((ucg_pixels_t *)data)->cnt, ((ucg_pixels_t *)data)->rgb);
+      else
+	ucg_com_SendString(ucg, ((ucg_pixels_t *)data)->cnt*3, ((ucg_pixels_t *)data)->rgb);
+      break;
+    case UCG_MSG_END_WINDOW:
+      ucg_com_SetCSLineStatus(ucg, 1);		/* disable chip */
+      break;
   }
   return 1;	/* all ok */
 }
@@ -305,4 +317,98 @@ void ucg_handle_l90rl(ucg_t *ucg, ucg_dev_fnptr dev_cb)
     ucg->arg.bitmap++;
   }
 }
-#endif
\ No newline at end of file
+#endif
+
+
+
+/*
+  window sequences for controllers with the MIPI DCS commands (ST7735, ILI9163, ILI9341, ILI9486)
+  column and row addresses are 16 bit, the first value is in x, the last value in y
+*/
+static const ucg_pgm_uint8_t ucg_dcs_window_mode_seq[] = 
+{
+  UCG_CS(0),					/* enable chip */
+  UCG_C10(0x036),	UCG_VARX(0,0x0ff, 0),
+  UCG_C10(0x036),	UCG_VARX(0,0x0ff, 0),		/* some controllers need this command twice */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_dcs_window_x_seq[] = 
+{
+  UCG_C10(0x02a),	UCG_VARX(8,0x0ff, 0), UCG_VARX(0,0x0ff, 0), UCG_VARY(8,0x0ff, 0), UCG_VARY(0,0x0ff, 0),		/* set x window */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_dcs_window_y_seq[] = 
+{
+  UCG_C10(0x02b),	UCG_VARX(8,0x0ff, 0), UCG_VARX(0,0x0ff, 0), UCG_VARY(8,0x0ff, 0), UCG_VARY(0,0x0ff, 0),		/* set y window */
+  UCG_C10(0x02c),							/* write to RAM */
+  UCG_DATA(),								/* change to data mode */
+  UCG_END()
+};
+
+/*
+  handle UCG_MSG_SET_WINDOW for controllers with the MIPI DCS commands
+  madctl is the memory access control of the controller for dir = 0, the mirrored
+  scan orders use the MX (0x040) and MY (0x080) bits
+  the dimension of the display (ucg->dimension) is the size of the controller RAM
+*/
+ucg_int_t ucg_handle_dcs_window(ucg_t *ucg, ucg_window_t *window, uint8_t madctl)
+{
+  ucg_int_t x0 = window->box.ul.x;
+  ucg_int_t y0 = window->box.ul.y;
+  ucg_int_t x1 = x0 + window->box.size.w - 1;
+  ucg_int_t y1 = y0 + window->box.size.h - 1;
+  ucg_int_t tmp;
+
+  if ( window->scan & UCG_WINDOW_MIRROR_X )
+  {
+    madctl |= 0x040;
+    tmp = ucg->dimension.w - 1 - x0;
+    x0 = ucg->dimension.w - 1 - x1;
+    x1 = tmp;
+  }
+  if ( window->scan & UCG_WINDOW_MIRROR_Y )
+  {
+    madctl |= 0x080;
+    tmp = ucg->dimension.h - 1 - y0;
+    y0 = ucg->dimension.h - 1 - y1;
+    y1 = tmp;
+  }
+  ucg_com_SendCmdSeqXY(ucg, ucg_dcs_window_mode_seq, madctl, 0);
+  ucg_com_SendCmdSeqXY(ucg, ucg_dcs_window_x_seq, x0, x1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_dcs_window_y_seq, y0, y1);
+  return 1;
+}
+
+/*
+  handle UCG_MSG_WRITE_PIXELS for 16 bit controllers (RGB 565)
+*/
+ucg_int_t ucg_handle_write_pixels_16(ucg_t *ucg, ucg_pixels_t *pixels)
+{
+  uint8_t buf[16*2];
+  uint8_t *rgb = pixels->rgb;
+  uint16_t cnt = pixels->cnt;
+  uint8_t i, k;
+  
+  if ( pixels->repeat != 0 )
+  {
+    buf[0] = (rgb[0]&0x0f8) | (rgb[1]>>5);
+    buf[1] = ((rgb[1]<<3)&0x0e0) | (rgb[2]>>3);
+    ucg_com_SendRepeat2Bytes(ucg, cnt, buf);
+    return 1;
+  }
+  while( cnt > 0 )
+  {
+    k = ( cnt > 16 ) ? 16 : cnt;
+    for( i = 0; i < k; i++ )
+    {
+      buf[i*2] = (rgb[0]&0x0f8) | (rgb[1]>>5);
+      buf[i*2+1] = ((rgb[1]<<3)&0x0e0) | (rgb[2]>>3);
+      rgb += 3;
+    }
+    ucg_com_SendString(ucg, k*2, buf);
+    cnt -= k;
+  }
+  return 1;
+}
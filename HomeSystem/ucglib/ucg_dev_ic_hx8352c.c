@@ -354,6 +354,40 @@ static ucg_int_t ucg_handle_hx8352c_l90se(ucg_t *ucg)
   return 0;
 }
 
+/*
+  window for a stream of pixels (UCG_MSG_SET_WINDOW)
+  the first value is in x, the last value in y
+*/
+static const ucg_pgm_uint8_t ucg_hx8352c_window_x_seq[] = 
+{
+  UCG_CS(0),					/* enable chip */
+  UCG_C10(0x002),	UCG_VARX(8,0x01, 0),
+  UCG_C10(0x003),	UCG_VARX(0,0x0ff, 0),
+  UCG_C10(0x004),	UCG_VARY(8,0x01, 0),
+  UCG_C10(0x005),	UCG_VARY(0,0x0ff, 0),		/* set x window */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_hx8352c_window_y_seq[] = 
+{
+  UCG_C10(0x006),	UCG_VARX(8,0x01, 0),
+  UCG_C10(0x007),	UCG_VARX(0,0x0ff, 0),
+  UCG_C10(0x008),	UCG_VARY(8,0x01, 0),
+  UCG_C10(0x009),	UCG_VARY(0,0x0ff, 0),		/* set y window */
+  UCG_C10(0x022),							/* write to RAM */
+  UCG_DATA(),								/* change to data mode */
+  UCG_END()
+};
+
+static ucg_int_t ucg_handle_hx8352c_window(ucg_t *ucg, ucg_window_t *window)
+{
+  if ( window->scan != 0 )
+    return 0;		/* mirrored scan orders are not supported */
+  ucg_com_SendCmdSeqXY(ucg, ucg_hx8352c_window_x_seq, window->box.ul.x, window->box.ul.x + window->box.size.w - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_hx8352c_window_y_seq, window->box.ul.y, window->box.ul.y + window->box.size.h - 1);
+  return 1;
+}
+
 static const ucg_pgm_uint8_t ucg_hx8352c_power_down_seq[] = {
     UCG_CS(0),      /* enable chip */
     UCG_C11(0x01F, 0x001), // Set standby (STB=1)
@@ -404,6 +438,8 @@ ucg_int_t ucg_dev_ic_hx8352c_18(ucg_t *ucg, ucg_int_t msg, void *data)
     ucg_handle_l90bf(ucg, ucg_dev_ic_hx8352c_18);
     return 1;
 #endif
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_hx8352c_window(ucg, (ucg_window_t *)data);
   }
   return ucg_dev_default_cb(ucg, msg, data);
 }
@@ -371,6 +371,8 @@ ucg_int_t ucg_dev_ic_ili9341_18(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_DRAW_L90SE:
       return ucg->ext_cb(ucg, msg, data);
     */
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_dcs_window(ucg, (ucg_window_t *)data, 0x008);
   }
   return ucg_dev_default_cb(ucg, msg, data);  
 }
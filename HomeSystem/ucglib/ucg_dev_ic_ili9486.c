@@ -360,6 +360,8 @@ ucg_int_t ucg_dev_ic_ili9486_18(ucg_t *ucg, ucg_int_t msg, void *data)
     ucg_handle_l90bf(ucg, ucg_dev_ic_ili9486_18);
     return 1;
 #endif
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_dcs_window(ucg, (ucg_window_t *)data, 0x008);
   }
   return ucg_dev_default_cb(ucg, msg, data);
 }
@@ -282,6 +282,36 @@ static ucg_int_t ucg_handle_ld50t6160_l90se(ucg_t *ucg)
   return 0;
 }
 
+/*
+  window for a stream of pixels (UCG_MSG_SET_WINDOW)
+  the first value is in x, the last value in y
+*/
+static const ucg_pgm_uint8_t ucg_ld50t6160_window_x_seq[] = 
+{
+  UCG_CS(0),					/* enable chip */
+  UCG_C11(0x05, 0x00),
+  UCG_C10(0x0a), 
+    UCG_VARX(4,0x0f, 0), UCG_VARX(0,0x0f, 0), UCG_VARY(4,0x0f, 0), UCG_VARY(0,0x0f, 0),		/* set x window */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_ld50t6160_window_y_seq[] = 
+{
+    UCG_VARX(4,0x0f, 0), UCG_VARX(0,0x0f, 0), UCG_VARY(4,0x0f, 0), UCG_VARY(0,0x0f, 0),		/* set y window */
+  UCG_C10(0x0c),							/* write to RAM */
+  UCG_DATA(),								/* change to data mode */
+  UCG_END()
+};
+
+static ucg_int_t ucg_handle_ld50t6160_window(ucg_t *ucg, ucg_window_t *window)
+{
+  if ( window->scan != 0 )
+    return 0;		/* mirrored scan orders are not supported */
+  ucg_com_SendCmdSeqXY(ucg, ucg_ld50t6160_window_x_seq, window->box.ul.x, window->box.ul.x + window->box.size.w - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_ld50t6160_window_y_seq, window->box.ul.y, window->box.ul.y + window->box.size.h - 1);
+  return 1;
+}
+
 static const ucg_pgm_uint8_t ucg_ld50t6160_power_down_seq[] = {
 	UCG_CS(0),					/* enable chip */
 	UCG_C11(0x02, 0x00),			/* display off */
@@ -343,6 +373,8 @@ ucg_int_t ucg_dev_ic_ld50t6160_18(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_DRAW_L90SE:
       return ucg->ext_cb(ucg, msg, data);
     */
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_ld50t6160_window(ucg, (ucg_window_t *)data);
   }
   return ucg_dev_default_cb(ucg, msg, data);  
 }
@@ -339,6 +339,60 @@ static ucg_int_t ucg_handle_pcf8833_l90se(ucg_t *ucg)
   return 0;
 }
 
+/*
+  window for a stream of pixels (UCG_MSG_SET_WINDOW), 8 bit addresses
+  the first value is in x, the last value in y
+*/
+static const ucg_pgm_uint8_t ucg_pcf8833_window_x_seq[] = 
+{
+  UCG_CS(0),					/* enable chip */
+  UCG_C10(0x036),	UCG_VARX(0,0x0ff, 0),		/* mx and my for the mirrored scan orders */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_pcf8833_window_seq[] = 
+{
+  UCG_C10(0x02a),	UCG_VARX(0,0x0ff, 0), UCG_VARY(0,0x0ff, 0),		/* set x window */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_pcf8833_window_y_seq[] = 
+{
+  UCG_C10(0x02b),	UCG_VARX(0,0x0ff, 0), UCG_VARY(0,0x0ff, 0),		/* set y window */
+  UCG_C10(0x02c),							/* write to RAM */
+  UCG_DATA(),								/* change to data mode */
+  UCG_END()
+};
+
+static ucg_int_t ucg_handle_pcf8833_window(ucg_t *ucg, ucg_window_t *window)
+{
+  ucg_int_t x0 = window->box.ul.x;
+  ucg_int_t y0 = window->box.ul.y;
+  ucg_int_t x1 = x0 + window->box.size.w - 1;
+  ucg_int_t y1 = y0 + window->box.size.h - 1;
+  ucg_int_t tmp;
+  uint8_t madctl = 0;
+
+  if ( window->scan & UCG_WINDOW_MIRROR_X )
+  {
+    madctl |= 0x040;
+    tmp = WIDTH-1-x0;
+    x0 = WIDTH-1-x1;
+    x1 = tmp;
+  }
+  if ( window->scan & UCG_WINDOW_MIRROR_Y )
+  {
+    madctl |= 0x080;
+    tmp = HEIGHT-1-y0;
+    y0 = HEIGHT-1-y1;
+    y1 = tmp;
+  }
+  ucg_com_SendCmdSeqXY(ucg, ucg_pcf8833_window_x_seq, madctl, 0);
+  ucg_com_SendCmdSeqXY(ucg, ucg_pcf8833_window_seq, x0, x1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_pcf8833_window_y_seq, y0, y1);
+  return 1;
+}
+
 static const ucg_pgm_uint8_t ucg_pcf8833_power_down_seq[] = {
 	UCG_CS(0),					/* enable chip */
 	UCG_C10(0x28), 				/* display off */	
@@ -399,6 +453,10 @@ ucg_int_t ucg_dev_ic_pcf8833_16(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_DRAW_L90SE:
       return ucg->ext_cb(ucg, msg, data);
     */
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_pcf8833_window(ucg, (ucg_window_t *)data);
+    case UCG_MSG_WRITE_PIXELS:
+      return ucg_handle_write_pixels_16(ucg, (ucg_pixels_t *)data);
   }
   return ucg_dev_default_cb(ucg, msg, data);  
 }
@@ -252,6 +252,56 @@ static ucg_int_t ucg_handle_seps225_l90se(ucg_t *ucg)
 }
 
 
+/*
+  window for a stream of pixels (UCG_MSG_SET_WINDOW)
+  the first value is in x, the last value in y,
+  the window registers are restored by UCG_MSG_END_WINDOW
+*/
+static const ucg_pgm_uint8_t ucg_seps225_window_x_seq[] = 
+{
+  UCG_CS(0),							/* enable chip */
+  UCG_C11(0x016, 0x064),				/* Memory Mode */
+  UCG_C10(0x017),	UCG_VARX(0,0x07f, 0), 	/* x0 */
+  UCG_C10(0x018),	UCG_VARY(0,0x07f, 0), 	/* x1 */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_seps225_window_y_seq[] = 
+{
+  UCG_C10(0x019),	UCG_VARX(0,0x07f, 0), 	/* y0 */
+  UCG_C10(0x01a),	UCG_VARY(0,0x07f, 0), 	/* y1 */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_seps225_window_pos_seq[] = 
+{
+  UCG_C10(0x020),	UCG_VARX(0,0x07f, 0), 	/* set x position */
+  UCG_C10(0x021),	UCG_VARY(0,0x07f, 0), 	/* set y position */    
+  UCG_C10(0x022),						/* prepare for data */
+  UCG_DATA(),							/* change to data mode */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_seps225_window_end_seq[] = 
+{
+  UCG_C11(0x017, 0x000),		/* x0 */
+  UCG_C11(0x018, 0x07f),		/* x1 */
+  UCG_C11(0x019, 0x000),		/* y0 */
+  UCG_C11(0x01a, 0x07f),		/* y1 */
+  UCG_CS(1),					/* disable chip */
+  UCG_END()
+};
+
+static ucg_int_t ucg_handle_seps225_window(ucg_t *ucg, ucg_window_t *window)
+{
+  if ( window->scan != 0 )
+    return 0;		/* mirrored scan orders are not supported */
+  ucg_com_SendCmdSeqXY(ucg, ucg_seps225_window_x_seq, window->box.ul.x, window->box.ul.x + window->box.size.w - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_seps225_window_y_seq, window->box.ul.y, window->box.ul.y + window->box.size.h - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_seps225_window_pos_seq, window->box.ul.x, window->box.ul.y);
+  return 1;
+}
+
 static const ucg_pgm_uint8_t ucg_seps225_power_down_seq[] = {
 	UCG_CS(0),					/* enable chip */
 	UCG_C11(0x006, 0x000),		/* SEPS225: display off */
@@ -307,6 +357,13 @@ ucg_int_t ucg_dev_ic_seps225_16(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_DRAW_L90SE:
       return ucg->ext_cb(ucg, msg, data);
     */
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_seps225_window(ucg, (ucg_window_t *)data);
+    case UCG_MSG_END_WINDOW:
+      ucg_com_SendCmdSeq(ucg, ucg_seps225_window_end_seq);	/* full window for the other drawing functions */
+      return 1;
+    case UCG_MSG_WRITE_PIXELS:
+      return ucg_handle_write_pixels_16(ucg, (ucg_pixels_t *)data);
   }
   return ucg_dev_default_cb(ucg, msg, data);  
 }
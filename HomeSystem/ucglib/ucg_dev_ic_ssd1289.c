@@ -414,6 +414,54 @@ ucg_int_t ucg_handle_ssd1289_l90se(ucg_t *ucg)
 }
 
 
+/*
+  window for a stream of pixels (UCG_MSG_SET_WINDOW)
+  the first value is in x, the last value in y,
+  the window registers are restored by UCG_MSG_END_WINDOW
+*/
+static const ucg_pgm_uint8_t ucg_ssd1289_window_x_seq[] = 
+{
+  UCG_CS(0),					/* enable chip */
+  UCG_C22(0x000, 0x011, 0x048, 0x030),		/* Entry Mode: horizontal increment (dir = 0) */
+  UCG_C10(0x044),	UCG_VARY(0,0x0ff, 0), UCG_VARX(0,0x0ff, 0),		/* Horizontal RAM Address Position: end, start */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_ssd1289_window_y_seq[] = 
+{
+  UCG_C10(0x045),	UCG_VARX(8,0x01, 0), UCG_VARX(0,0x0ff, 0),		/* Vertical RAM Address Start Position */
+  UCG_C10(0x046),	UCG_VARY(8,0x01, 0), UCG_VARY(0,0x0ff, 0),		/* Vertical RAM Address End Position */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_ssd1289_window_pos_seq[] = 
+{
+  UCG_C10(0x04e),	UCG_VARX(0,0x00, 0), UCG_VARX(0,0x0ff, 0),					/* set x position */
+  UCG_C10(0x04f),	UCG_VARY(8,0x01, 0), UCG_VARY(0,0x0ff, 0),		/* set y position */
+  UCG_C10(0x022),							/* write to RAM */
+  UCG_DATA(),								/* change to data mode */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_ssd1289_window_end_seq[] = 
+{
+  UCG_C22(0x000, 0x044, 0x0ef, 0x000),		/* Horizontal RAM Address Position: 239, 0 */
+  UCG_C22(0x000, 0x045, 0x000, 0x000),		/* Vertical RAM Address Start Position */
+  UCG_C22(0x000, 0x046, 0x001, 0x03f),		/* Vertical RAM Address End Position: 319 */
+  UCG_CS(1),					/* disable chip */
+  UCG_END()
+};
+
+static ucg_int_t ucg_handle_ssd1289_window(ucg_t *ucg, ucg_window_t *window)
+{
+  if ( window->scan != 0 )
+    return 0;		/* mirrored scan orders are not supported */
+  ucg_com_SendCmdSeqXY(ucg, ucg_ssd1289_window_x_seq, window->box.ul.x, window->box.ul.x + window->box.size.w - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_ssd1289_window_y_seq, window->box.ul.y, window->box.ul.y + window->box.size.h - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_ssd1289_window_pos_seq, window->box.ul.x, window->box.ul.y);
+  return 1;
+}
+
 ucg_int_t ucg_dev_ic_ssd1289_18(ucg_t *ucg, ucg_int_t msg, void *data)
 {
   switch(msg)
@@ -461,6 +509,11 @@ ucg_int_t ucg_dev_ic_ssd1289_18(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_DRAW_L90SE:
       return ucg->ext_cb(ucg, msg, data);
     */
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_ssd1289_window(ucg, (ucg_window_t *)data);
+    case UCG_MSG_END_WINDOW:
+      ucg_com_SendCmdSeq(ucg, ucg_ssd1289_window_end_seq);	/* full window for the other drawing functions */
+      return 1;
   }
   return ucg_dev_default_cb(ucg, msg, data);  
 }
@@ -301,6 +301,34 @@ ucg_int_t ucg_handle_ssd1351_l90se(ucg_t *ucg)
 }
 
 
+/*
+  window for a stream of pixels (UCG_MSG_SET_WINDOW)
+  the first value is in x, the last value in y
+*/
+static const ucg_pgm_uint8_t ucg_ssd1351_window_x_seq[] = 
+{
+  UCG_CS(0),					/* enable chip */
+  UCG_C10(0x015),	UCG_VARX(0,0x0ff, 0), UCG_VARY(0,0x0ff, 0),		/* set x window */
+  UCG_END()
+};
+
+static const ucg_pgm_uint8_t ucg_ssd1351_window_y_seq[] = 
+{
+  UCG_C10(0x075),	UCG_VARX(0,0x0ff, 0), UCG_VARY(0,0x0ff, 0),		/* set y window */
+  UCG_C10(0x05c),							/* write to RAM */
+  UCG_DATA(),								/* change to data mode */
+  UCG_END()
+};
+
+static ucg_int_t ucg_handle_ssd1351_window(ucg_t *ucg, ucg_window_t *window)
+{
+  if ( window->scan != 0 )
+    return 0;		/* mirrored scan orders are not supported */
+  ucg_com_SendCmdSeqXY(ucg, ucg_ssd1351_window_x_seq, window->box.ul.x, window->box.ul.x + window->box.size.w - 1);
+  ucg_com_SendCmdSeqXY(ucg, ucg_ssd1351_window_y_seq, window->box.ul.y, window->box.ul.y + window->box.size.h - 1);
+  return 1;
+}
+
 static const ucg_pgm_uint8_t ucg_ssd1351_power_down_seq[] = {
 	UCG_CS(0),					/* enable chip */
   	UCG_C11(0x0c7, 0x000),			/* Set Master Contrast (0..15), reset default: 0x05 */
@@ -357,6 +385,8 @@ ucg_int_t ucg_dev_ic_ssd1351_18(ucg_t *ucg, ucg_int_t msg, void *data)
     case UCG_MSG_DRAW_L90SE:
       return ucg->ext_cb(ucg, msg, data);
     */
+    case UCG_MSG_SET_WINDOW:
+      return ucg_handle_ssd1351_window(ucg, (ucg_window_t *)data);
   }
   return ucg_dev_default_cb(ucg, msg, data);  
 }
@@ -0,0 +1,238 @@
+/*!
+ *  \file    ucg_dirty.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Dirty rectangles (partial refresh) for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           If a value on the screen changes, only the rectangle of the value has to
+ *           be drawn again. The widgets mark their rectangles with ucg_MarkDirty(),
+ *           ucg_FlushDirty() calls the draw function of the screen once for every
+ *           dirty rectangle with the clip range set to the rectangle, so only the
+ *           pixels in the rectangle are sent. With a strip buffer (ucg_SetStrip())
+ *           the draw function is called for every strip of the rectangle.
+ *  \code
+    static ucg_dirty_t dirty;
+
+    ucg_SetDirty(&ucg, &dirty);
+    ...
+    ucg_MarkDirty(&ucg, 10, 30, 60, 16);     // the temperature has changed
+    ucg_FlushDirty(&ucg, draw_screen); \endcode
+ *
+ *           Overlapping or near rectangles are merged, if the bounding box of both
+ *           is not much larger than the two rectangles: every window costs about
+ *           UCG_DIRTY_COST pixels (the commands for the window and the calls of the
+ *           draw function). If all UCG_DIRTY_RECTS rectangles are used, a new
+ *           rectangle is merged with the rectangle that grows least.
+ */
+
+#include "ucg.h"
+
+static uint32_t _ucg_dirty_area(ucg_box_t *b);
+static void _ucg_dirty_union(ucg_box_t *u, ucg_box_t *a, ucg_box_t *b);
+static void _ucg_dirty_remove(ucg_dirty_t *d, uint8_t i);
+static void _ucg_dirty_add(ucg_dirty_t *d, ucg_box_t r);
+
+/*  brief   Calculates the area of a rectangle
+ *
+ *  param   b       pointer to the rectangle
+ *
+ *  return  the number of pixels
+ */
+static uint32_t _ucg_dirty_area(ucg_box_t *b)
+{
+  return (uint32_t) b->size.w * (uint32_t) b->size.h;
+}
+
+/*  brief   Calculates the bounding box of two rectangles
+ *
+ *  param   u       pointer to the bounding box
+ *  param   a       pointer to the first rectangle
+ *  param   b       pointer to the second rectangle
+ *
+ *  return  void
+ */
+static void _ucg_dirty_union(ucg_box_t *u, ucg_box_t *a, ucg_box_t *b)
+{
+  ucg_int_t  x0, y0, x1, y1;
+
+  x0 = ( a->ul.x < b->ul.x ) ? a->ul.x : b->ul.x;
+  y0 = ( a->ul.y < b->ul.y ) ? a->ul.y : b->ul.y;
+  x1 = ( a->ul.x + a->size.w > b->ul.x + b->size.w ) ? a->ul.x + a->size.w : b->ul.x + b->size.w;
+  y1 = ( a->ul.y + a->size.h > b->ul.y + b->size.h ) ? a->ul.y + a->size.h : b->ul.y + b->size.h;
+
+  u->ul.x   = x0;
+  u->ul.y   = y0;
+  u->size.w = x1 - x0;
+  u->size.h = y1 - y0;
+}
+
+/*  brief   Removes a rectangle from the list
+ *
+ *  param   d       pointer to struct for the dirty rectangles
+ *  param   i       the index of the rectangle
+ *
+ *  return  void
+ */
+static void _ucg_dirty_remove(ucg_dirty_t *d, uint8_t i)
+{
+  d->cnt--;
+  d->rect[i] = d->rect[d->cnt];
+}
+
+/*  brief   Adds a rectangle to the list, overlapping or near rectangles are merged
+ *
+ *  param   d       pointer to struct for the dirty rectangles
+ *  param   r       the rectangle
+ *
+ *  return  void
+ */
+static void _ucg_dirty_add(ucg_dirty_t *d, ucg_box_t r)
+{
+  ucg_box_t  u;
+  uint32_t   grow, best;
+  uint8_t    i, k;
+
+  // merge with every rectangle, where one window for both is cheaper,
+  // the merged rectangle is checked again against all rectangles
+  i = 0;
+  while ( i < d->cnt ) {
+    _ucg_dirty_union(&u, &r, d->rect + i);
+    if ( _ucg_dirty_area(&u) <= _ucg_dirty_area(&r) + _ucg_dirty_area(d->rect + i) + UCG_DIRTY_COST ) {
+      r = u;
+      _ucg_dirty_remove(d, i);
+      i = 0;
+      continue;
+    }
+    i++;
+  }
+
+  if ( d->cnt < UCG_DIRTY_RECTS ) {
+    d->rect[d->cnt++] = r;
+    return;
+  }
+
+  // all rectangles are used: merge with the rectangle that grows least
+  k = 0;
+  best = UINT32_MAX;
+  for (i = 0; i < d->cnt; i++) {
+    _ucg_dirty_union(&u, &r, d->rect + i);
+    grow = _ucg_dirty_area(&u) - _ucg_dirty_area(d->rect + i);
+    if ( grow < best ) {
+      best = grow;
+      k = i;
+    }
+  }
+  _ucg_dirty_union(&u, &r, d->rect + k);
+  _ucg_dirty_remove(d, k);
+  _ucg_dirty_add(d, u);
+}
+
+/*! \brief  Enables the dirty rectangles, no rectangle is dirty
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  d        pointer to struct for the dirty rectangles
+ *
+ *  \return void
+ */
+void ucg_SetDirty(ucg_t *ucg, ucg_dirty_t *d)
+{
+  d->cnt        = 0;
+  d->marked_sum = 0;
+  d->regions    = 0;
+  d->marked     = 0;
+  d->pixels     = 0;
+  ucg->dirty    = d;
+}
+
+/*! \brief  Marks a rectangle as dirty
+ *
+ *          The rectangle is clipped to the display and merged with the dirty
+ *          rectangles, see the description of the file.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  x        the x-position of the rectangle
+ *  \param  y        the y-position of the rectangle
+ *  \param  w        the width of the rectangle
+ *  \param  h        the height of the rectangle
+ *
+ *  \return void
+ */
+void ucg_MarkDirty(ucg_t *ucg, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h)
+{
+  ucg_dirty_t *d = ucg->dirty;
+  ucg_box_t  r;
+
+  if ( d == NULL ) return;
+
+  if ( x < 0 ) { w += x; x = 0; }
+  if ( y < 0 ) { h += y; y = 0; }
+  if ( x + w > ucg_GetWidth(ucg) ) w = ucg_GetWidth(ucg) - x;
+  if ( y + h > ucg_GetHeight(ucg) ) h = ucg_GetHeight(ucg) - y;
+  if ( (w <= 0) || (h <= 0) ) return;
+
+  r.ul.x   = x;
+  r.ul.y   = y;
+  r.size.w = w;
+  r.size.h = h;
+  d->marked_sum += _ucg_dirty_area(&r);
+  _ucg_dirty_add(d, r);
+}
+
+/*! \brief  Marks the whole display as dirty
+ *
+ *  \param  ucg      pointer to struct for the display
+ *
+ *  \return void
+ */
+void ucg_MarkAllDirty(ucg_t *ucg)
+{
+  ucg_MarkDirty(ucg, 0, 0, ucg_GetWidth(ucg), ucg_GetHeight(ucg));
+}
+
+/*! \brief  Draws the dirty rectangles
+ *
+ *          For every dirty rectangle the clip range is set to the rectangle and
+ *          the draw function is called (with a strip buffer in a loop with
+ *          ucg_FirstPage() and ucg_NextPage()). Then the clip range is reset and
+ *          no rectangle is dirty. The statistics of the frame are stored in the
+ *          struct for the dirty rectangles.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  draw     the function that draws the screen
+ *
+ *  \return the number of pixels in the dirty rectangles
+ */
+uint32_t ucg_FlushDirty(ucg_t *ucg, ucg_dirty_fnptr draw)
+{
+  ucg_dirty_t *d = ucg->dirty;
+  ucg_box_t  *r;
+  uint8_t    i;
+
+  if ( d == NULL ) return 0;
+
+  d->regions = d->cnt;
+  d->marked  = d->marked_sum;
+  d->pixels  = 0;
+  for (i = 0; i < d->cnt; i++) {
+    r = d->rect + i;
+    d->pixels += _ucg_dirty_area(r);
+    ucg_SetClipRange(ucg, r->ul.x, r->ul.y, r->size.w, r->size.h);
+    if ( ucg->strip != NULL ) {
+      ucg_FirstPage(ucg);
+      do {
+        draw(ucg);
+      } while ( ucg_NextPage(ucg) );
+    } else {
+      draw(ucg);
+    }
+  }
+  ucg_SetMaxClipRange(ucg);
+
+  d->cnt = 0;
+  d->marked_sum = 0;
+  return d->pixels;
+}
@@ -0,0 +1,454 @@
+/*!
+ *  \file    ucg_dlist.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Display lists (retained mode) for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           A page builds its picture into a display list in RAM instead of drawing
+ *           it. ucg_DrawDList() draws the list. If the page builds the list again
+ *           into a second buffer, ucg_DiffDList() compares the new list with the
+ *           old one and marks the bounding boxes of the changed items as dirty
+ *           (ucg_dirty.c), so only the changed parts are drawn:
+ *  \code
+    static uint8_t     buf[2][256];
+    static ucg_dlist_t dl[2];
+    static uint8_t     cur;
+
+    static void draw(ucg_t *ucg) { ucg_DrawDList(ucg, &dl[cur]); }
+
+    ucg_InitDList(&dl[cur^1], buf[cur^1], sizeof(buf[0]));
+    ucg_DListColor(&dl[cur^1], 0, 0, 80);
+    ucg_DListBox(&dl[cur^1], 0, 0, 128, 160);
+    ucg_DListColor(&dl[cur^1], 255, 255, 255);
+    ucg_DListText(&dl[cur^1], 10, 40, ucg_font_ncenR12_tr, value);
+    ucg_DiffDList(&ucg, &dl[cur], &dl[cur^1]);
+    cur ^= 1;
+    ucg_FlushDirty(&ucg, draw); \endcode
+ *
+ *           Every item stores its color, so an item is unchanged if its bytes are
+ *           unchanged. The items are compared by position; if one item is inserted
+ *           or removed, the following items are found again. The list is a byte
+ *           array and can be compared or saved for golden tests on the host. The
+ *           format of an item is:
+ *  \verbatim
+    offset  bytes  description
+    0       1      type (UCG_DLIST_BOX, ...)
+    1       1      length of the item (bytes)
+    2       3      color (red, green, blue)
+    5       2*n    coordinates, 16 bit (low byte first):
+                   box, frame: x, y, w, h
+                   rbox:       x, y, w, h, r
+                   line:       x1, y1, x2, y2
+                   text:       x, y (base line), followed by the pointer to
+                               the font and the string (with the 0)
+                   ibmp:       x, y, followed by the pointer to the bitmap
+                               (ucg_DrawIBmp(), direction 0) \endverbatim
+ *
+ *           Pointers to fonts and bitmaps are stored with their size in RAM, so
+ *           lists can only be compared within one program.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include "ucg.h"
+
+#define UCG_DLIST_BOX     1    //!< item: box
+#define UCG_DLIST_FRAME   2    //!< item: frame
+#define UCG_DLIST_RBOX    3    //!< item: box with rounded edges
+#define UCG_DLIST_LINE    4    //!< item: line
+#define UCG_DLIST_TEXT    5    //!< item: text
+#define UCG_DLIST_IBMP    6    //!< item: indexed-color bitmap
+
+#define UCG_DLIST_HEADER  5    //!< type, length and color of an item
+
+typedef const ucg_fntpgm_uint8_t *ucg_dlist_font_t;   //!< pointer to a font in an item
+typedef const __memx uint8_t *ucg_dlist_ibmp_t;       //!< pointer to a bitmap in an item
+
+static uint8_t *_ucg_dlist_item(ucg_dlist_t *dl, uint8_t type, uint8_t ncoords, uint8_t extra, ...);
+static ucg_int_t _ucg_dlist_coord(const uint8_t *item, uint8_t i);
+static void _ucg_dlist_bbox(ucg_t *ucg, const uint8_t *item, ucg_box_t *b);
+static void _ucg_dlist_mark(ucg_t *ucg, const uint8_t *item);
+static uint8_t _ucg_dlist_equal(const uint8_t *a, const uint8_t *b);
+
+/*  brief   Appends an item to the list
+ *
+ *  param   dl      pointer to struct for the display list
+ *  param   type    the type of the item
+ *  param   ncoords the number of coordinates
+ *  param   extra   the number of bytes after the coordinates
+ *  param   ...     the coordinates (ucg_int_t)
+ *
+ *  return  pointer to the bytes after the coordinates, NULL if the buffer is full
+ */
+static uint8_t *_ucg_dlist_item(ucg_dlist_t *dl, uint8_t type, uint8_t ncoords, uint8_t extra, ...)
+{
+  va_list   va;
+  uint8_t  *p;
+  uint16_t  len = UCG_DLIST_HEADER + 2 * ncoords + extra;
+  ucg_int_t v;
+
+  if ( (len > 255) || (dl->len + len > dl->size) ) {
+    dl->overflow = 1;
+    return NULL;
+  }
+
+  p = dl->buf + dl->len;
+  dl->len += len;
+  *p++ = type;
+  *p++ = len;
+  *p++ = dl->rgb[0];
+  *p++ = dl->rgb[1];
+  *p++ = dl->rgb[2];
+
+  va_start(va, extra);
+  while ( ncoords-- ) {
+    v = (ucg_int_t) va_arg(va, int);
+    *p++ = (uint16_t) v & 0xff;
+    *p++ = (uint16_t) v >> 8;
+  }
+  va_end(va);
+  return p;
+}
+
+/*  brief   Reads a coordinate of an item
+ *
+ *  param   item    pointer to the item
+ *  param   i       the index of the coordinate
+ *
+ *  return  the coordinate
+ */
+static ucg_int_t _ucg_dlist_coord(const uint8_t *item, uint8_t i)
+{
+  const uint8_t *p = item + UCG_DLIST_HEADER + 2 * i;
+
+  return (ucg_int_t) (int16_t) (p[0] | ((uint16_t) p[1] << 8));
+}
+
+/*  brief   Calculates the bounding box of an item
+ *
+ *  param   ucg     pointer to struct for the display (for the font of a text)
+ *  param   item    pointer to the item
+ *  param   b       pointer to the bounding box
+ *
+ *  return  void
+ */
+static void _ucg_dlist_bbox(ucg_t *ucg, const uint8_t *item, ucg_box_t *b)
+{
+  const _MEMX unsigned char *font;
+  ucg_dlist_font_t  f;
+  ucg_dlist_ibmp_t  ibmp;
+  ucg_int_t  x1, y1, x2, y2;
+
+  x1 = _ucg_dlist_coord(item, 0);
+  y1 = _ucg_dlist_coord(item, 1);
+  b->ul.x = x1;
+  b->ul.y = y1;
+
+  switch(item[0]) {
+    case UCG_DLIST_LINE:
+      x2 = _ucg_dlist_coord(item, 2);
+      y2 = _ucg_dlist_coord(item, 3);
+      b->ul.x   = ( x1 < x2 ) ? x1 : x2;
+      b->ul.y   = ( y1 < y2 ) ? y1 : y2;
+      b->size.w = ( x1 < x2 ) ? x2 - x1 + 1 : x1 - x2 + 1;
+      b->size.h = ( y1 < y2 ) ? y2 - y1 + 1 : y1 - y2 + 1;
+      break;
+
+    case UCG_DLIST_TEXT:
+      // all glyphs are in the bounding box of the font
+      memcpy(&f, item + UCG_DLIST_HEADER + 4, sizeof(f));
+      font = ucg->font;
+      ucg_SetFont(ucg, f);
+      x2 = ucg_GetStrWidth(ucg, (const char *) item + UCG_DLIST_HEADER + 4 + sizeof(f));
+      if ( ucg->font_info.x_offset < 0 ) {
+        b->ul.x += ucg->font_info.x_offset;
+        x2 -= ucg->font_info.x_offset;
+      }
+      b->ul.y   = y1 - (ucg->font_info.max_char_height + ucg->font_info.y_offset);
+      b->size.w = x2 + 1;
+      b->size.h = ucg->font_info.max_char_height + 1;
+      if ( font != NULL ) ucg_SetFont(ucg, font);
+      break;
+
+    case UCG_DLIST_IBMP:
+      memcpy(&ibmp, item + UCG_DLIST_HEADER + 4, sizeof(ibmp));
+      b->size.w = ((ucg_int_t) ibmp[0] << 8) | ibmp[1];
+      b->size.h = ((ucg_int_t) ibmp[2] << 8) | ibmp[3];
+      break;
+
+    default:                                     // box, frame and rbox
+      b->size.w = _ucg_dlist_coord(item, 2);
+      b->size.h = _ucg_dlist_coord(item, 3);
+      break;
+  }
+}
+
+/*  brief   Marks the bounding box of an item as dirty
+ *
+ *  param   ucg     pointer to struct for the display
+ *  param   item    pointer to the item
+ *
+ *  return  void
+ */
+static void _ucg_dlist_mark(ucg_t *ucg, const uint8_t *item)
+{
+  ucg_box_t  b;
+
+  _ucg_dlist_bbox(ucg, item, &b);
+  ucg_MarkDirty(ucg, b.ul.x, b.ul.y, b.size.w, b.size.h);
+}
+
+/*  brief   Compares two items
+ *
+ *  param   a       pointer to the first item
+ *  param   b       pointer to the second item
+ *
+ *  return  1 if the items are equal
+ */
+static uint8_t _ucg_dlist_equal(const uint8_t *a, const uint8_t *b)
+{
+  return (a[1] == b[1]) && (memcmp(a, b, a[1]) == 0);
+}
+
+/*! \brief  Initializes an empty display list
+ *
+ *          The color is white.
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  buf      the buffer for the items
+ *  \param  size     the size of the buffer
+ *
+ *  \return void
+ */
+void ucg_InitDList(ucg_dlist_t *dl, uint8_t *buf, uint16_t size)
+{
+  dl->buf      = buf;
+  dl->size     = size;
+  dl->len      = 0;
+  dl->overflow = 0;
+  dl->rgb[0]   = 255;
+  dl->rgb[1]   = 255;
+  dl->rgb[2]   = 255;
+}
+
+/*! \brief  Sets the color of the following items
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  r        red
+ *  \param  g        green
+ *  \param  b        blue
+ *
+ *  \return void
+ */
+void ucg_DListColor(ucg_dlist_t *dl, uint8_t r, uint8_t g, uint8_t b)
+{
+  dl->rgb[0] = r;
+  dl->rgb[1] = g;
+  dl->rgb[2] = b;
+}
+
+/*! \brief  Appends a box, see ucg_DrawBox()
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  x        the x-position
+ *  \param  y        the y-position
+ *  \param  w        the width
+ *  \param  h        the height
+ *
+ *  \return 0 if the buffer is full
+ */
+uint8_t ucg_DListBox(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h)
+{
+  return _ucg_dlist_item(dl, UCG_DLIST_BOX, 4, 0, x, y, w, h) != NULL;
+}
+
+/*! \brief  Appends a frame, see ucg_DrawFrame()
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  x        the x-position
+ *  \param  y        the y-position
+ *  \param  w        the width
+ *  \param  h        the height
+ *
+ *  \return 0 if the buffer is full
+ */
+uint8_t ucg_DListFrame(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h)
+{
+  return _ucg_dlist_item(dl, UCG_DLIST_FRAME, 4, 0, x, y, w, h) != NULL;
+}
+
+/*! \brief  Appends a box with rounded edges, see ucg_DrawRBox()
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  x        the x-position
+ *  \param  y        the y-position
+ *  \param  w        the width
+ *  \param  h        the height
+ *  \param  r        the radius of the edges
+ *
+ *  \return 0 if the buffer is full
+ */
+uint8_t ucg_DListRBox(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h, ucg_int_t r)
+{
+  return _ucg_dlist_item(dl, UCG_DLIST_RBOX, 5, 0, x, y, w, h, r) != NULL;
+}
+
+/*! \brief  Appends a line, see ucg_DrawLine()
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  x1       the x-position of the start point
+ *  \param  y1       the y-position of the start point
+ *  \param  x2       the x-position of the end point
+ *  \param  y2       the y-position of the end point
+ *
+ *  \return 0 if the buffer is full
+ */
+uint8_t ucg_DListLine(ucg_dlist_t *dl, ucg_int_t x1, ucg_int_t y1, ucg_int_t x2, ucg_int_t y2)
+{
+  return _ucg_dlist_item(dl, UCG_DLIST_LINE, 4, 0, x1, y1, x2, y2) != NULL;
+}
+
+/*! \brief  Appends a text, see ucg_DrawString() (direction 0)
+ *
+ *          The string is copied into the list. The position is the base line,
+ *          the font position must not be changed with ucg_SetFontPosTop() etc.
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  x        the x-position of the text
+ *  \param  y        the y-position of the base line
+ *  \param  font     the font
+ *  \param  str      the text
+ *
+ *  \return 0 if the buffer is full
+ */
+uint8_t ucg_DListText(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, const ucg_fntpgm_uint8_t *font, const char *str)
+{
+  ucg_dlist_font_t  f = font;
+  uint16_t  n = strlen(str) + 1;
+  uint8_t  *p;
+
+  p = _ucg_dlist_item(dl, UCG_DLIST_TEXT, 2, sizeof(f) + n, x, y);
+  if ( p == NULL ) return 0;
+
+  memcpy(p, &f, sizeof(f));
+  memcpy(p + sizeof(f), str, n);
+  return 1;
+}
+
+/*! \brief  Appends an indexed-color bitmap, see ucg_DrawIBmp() (direction 0)
+ *
+ *  \param  dl       pointer to struct for the display list
+ *  \param  x        the x-position of the bitmap
+ *  \param  y        the y-position of the bitmap
+ *  \param  ibmp     the pointer to the bitmap
+ *
+ *  \return 0 if the buffer is full
+ */
+uint8_t ucg_DListIBmp(ucg_dlist_t *dl, ucg_int_t x, ucg_int_t y, const __memx uint8_t *ibmp)
+{
+  ucg_dlist_ibmp_t  b = ibmp;
+  uint8_t  *p;
+
+  p = _ucg_dlist_item(dl, UCG_DLIST_IBMP, 2, sizeof(b), x, y);
+  if ( p == NULL ) return 0;
+
+  memcpy(p, &b, sizeof(b));
+  return 1;
+}
+
+/*! \brief  Draws a display list
+ *
+ *          The color 0 and the font are changed.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  dl       pointer to struct for the display list
+ *
+ *  \return void
+ */
+void ucg_DrawDList(ucg_t *ucg, const ucg_dlist_t *dl)
+{
+  const uint8_t *item;
+  ucg_dlist_font_t  f;
+  ucg_dlist_ibmp_t  ibmp;
+  ucg_int_t  x, y;
+
+  for (item = dl->buf; item < dl->buf + dl->len; item += item[1]) {
+    ucg_SetColor(ucg, 0, item[2], item[3], item[4]);
+    x = _ucg_dlist_coord(item, 0);
+    y = _ucg_dlist_coord(item, 1);
+
+    switch(item[0]) {
+      case UCG_DLIST_BOX:
+        ucg_DrawBox(ucg, x, y, _ucg_dlist_coord(item, 2), _ucg_dlist_coord(item, 3));
+        break;
+      case UCG_DLIST_FRAME:
+        ucg_DrawFrame(ucg, x, y, _ucg_dlist_coord(item, 2), _ucg_dlist_coord(item, 3));
+        break;
+      case UCG_DLIST_RBOX:
+        ucg_DrawRBox(ucg, x, y, _ucg_dlist_coord(item, 2), _ucg_dlist_coord(item, 3),
+                     _ucg_dlist_coord(item, 4));
+        break;
+      case UCG_DLIST_LINE:
+        ucg_DrawLine(ucg, x, y, _ucg_dlist_coord(item, 2), _ucg_dlist_coord(item, 3));
+        break;
+      case UCG_DLIST_TEXT:
+        memcpy(&f, item + UCG_DLIST_HEADER + 4, sizeof(f));
+        ucg_SetFont(ucg, f);
+        ucg_DrawString(ucg, x, y, 0, (const char *) item + UCG_DLIST_HEADER + 4 + sizeof(f));
+        break;
+      case UCG_DLIST_IBMP:
+        memcpy(&ibmp, item + UCG_DLIST_HEADER + 4, sizeof(ibmp));
+        ucg_DrawIBmp(ucg, x, y, 0, ibmp);
+        break;
+    }
+  }
+}
+
+/*! \brief  Marks the changes between two display lists as dirty
+ *
+ *          The bounding boxes of the removed, added and changed items are marked
+ *          with ucg_MarkDirty(). If one of the lists is incomplete (the buffer was
+ *          full), the whole display is marked.
+ *
+ *  \param  ucg      pointer to struct for the display (with ucg_SetDirty())
+ *  \param  prev     pointer to struct for the old display list
+ *  \param  next     pointer to struct for the new display list
+ *
+ *  \return void
+ */
+void ucg_DiffDList(ucg_t *ucg, const ucg_dlist_t *prev, const ucg_dlist_t *next)
+{
+  const uint8_t *a = prev->buf;
+  const uint8_t *b = next->buf;
+  const uint8_t *a_end = prev->buf + prev->len;
+  const uint8_t *b_end = next->buf + next->len;
+
+  if ( prev->overflow || next->overflow ) {
+    ucg_MarkAllDirty(ucg);
+    return;
+  }
+
+  while ( (a < a_end) && (b < b_end) ) {
+    if ( _ucg_dlist_equal(a, b) ) {
+      a += a[1];
+      b += b[1];
+    } else if ( (b + b[1] < b_end) && _ucg_dlist_equal(a, b + b[1]) ) {
+      _ucg_dlist_mark(ucg, b);                   // item inserted
+      b += b[1];
+    } else if ( (a + a[1] < a_end) && _ucg_dlist_equal(a + a[1], b) ) {
+      _ucg_dlist_mark(ucg, a);                   // item removed
+      a += a[1];
+    } else {
+      _ucg_dlist_mark(ucg, a);                   // item changed
+      _ucg_dlist_mark(ucg, b);
+      a += a[1];
+      b += b[1];
+    }
+  }
+  for ( ; a < a_end; a += a[1] ) _ucg_dlist_mark(ucg, a);
+  for ( ; b < b_end; b += b[1] ) _ucg_dlist_mark(ucg, b);
+}
@@ -75,9 +75,10 @@ static ucg_int_t ucg_font_calc_vref_center(ucg_t *ucg);
 static ucg_int_t ucg_font_calc_vref_top(ucg_t *ucg);
 static ucg_int_t ucg_font_calc_vref_bottom(ucg_t *ucg);
 static ucg_int_t ucg_font_calc_vref_font(ucg_t *ucg);
-static ucg_int_t ucg_font_draw_glyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint8_t encoding);
+static ucg_int_t ucg_font_draw_glyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint16_t encoding);
 static void ucg_UpdateRefHeight(ucg_t *ucg);
-static const _MEMX uint8_t *ucg_font_get_glyph_data(ucg_t *ucg, uint8_t encoding);
+static const _MEMX uint8_t *ucg_font_get_glyph_data(ucg_t *ucg, uint16_t encoding);
+static const _MEMX uint8_t *ucg_font_get_unicode_glyph_data(ucg_t *ucg, uint16_t encoding);
 static int8_t ucg_font_decode_glyph(ucg_t *ucg, const _MEMX uint8_t *glyph_data);
 static void ucg_font_decode_len(ucg_t *ucg, uint8_t len, uint8_t is_foreground);
 static int8_t ucg_font_decode_get_signed_bits(ucg_font_decode_t *f, uint8_t cnt);
@@ -120,6 +121,7 @@ typedef void * ucg_glyph_t;
   offset	bytes	description
   0		1		glyph_cnt		number of glyphs
   1		1		bbx_mode	0: proportional, 1: common height, 2: monospace, 3: multiple of 8
+				bit 7: unicode extension (UCG_FONT_BBX_UNICODE)
   2		1		bits_per_0	glyph rle parameter
   3		1		bits_per_1	glyph rle parameter
 
@@ -146,6 +148,20 @@ typedef void * ucg_glyph_t;
   20		1		start pos 'a' low byte
 
   Font build mode, 0: proportional, 1: common height, 2: monospace, 3: multiple of 8
+  
+  Unicode extension:
+    If bit 7 of bbx_mode (UCG_FONT_BBX_UNICODE) is set, a section with 16 bit
+    encodings follows the terminator (encoding 0, size 0) of the 8 bit glyphs.
+    
+  offset	bytes	description
+  0		2		number of glyphs n (high byte first)
+  2		4*n		table, sorted by encoding:
+		  2		  encoding (high byte first)
+		  2		  position of the glyph from the start of this section (high byte first)
+  2+4*n			glyphs, same as the 8 bit glyphs, the first byte is the low byte of the encoding
+  
+  The table is searched binary, so the lookup time is O(log n).
+  Fonts without this bit are not changed.
 
   Font build mode 0:		
     - "t"
@@ -230,6 +246,14 @@ static void ucg_read_font_info(ucg_font_info_t *font_info, const ucg_fntpgm_uint
   /* offset 17 */
   font_info->start_pos_upper_A = ucg_font_get_word(font, 17);
   font_info->start_pos_lower_a = ucg_font_get_word(font, 19);  
+  
+  /* unicode extension: the section after the terminator of the 8 bit glyphs */
+  font_info->start_pos_unicode = 0;
+  if ( font_info->bbx_mode & UCG_FONT_BBX_UNICODE )
+  {
+    font_info->bbx_mode &= ~UCG_FONT_BBX_UNICODE;
+    font_info->start_pos_unicode = ucg_font_GetSize(font) - UCG_FONT_DATA_STRUCT_SIZE;
+  }
 }
 
 /*========================================================================*/
@@ -763,11 +787,16 @@ static int8_t ucg_font_decode_glyph(ucg_t *ucg, const _MEMX uint8_t *glyph_data)
   Return:
     Address of the glyph data or NULL, if the encoding is not avialable in the font.
 */
-static const _MEMX uint8_t *ucg_font_get_glyph_data(ucg_t *ucg, uint8_t encoding)
+static const _MEMX uint8_t *ucg_font_get_glyph_data(ucg_t *ucg, uint16_t encoding)
 {
   const _MEMX uint8_t *font = ucg->font;
   font += UCG_FONT_DATA_STRUCT_SIZE;
   
+  if ( encoding > 0xff )
+  {
+    return ucg_font_get_unicode_glyph_data(ucg, encoding);
+  }
+  
   if ( encoding >= 'a' )
   {
     font += ucg->font_info.start_pos_lower_a;
@@ -790,7 +819,46 @@ static const _MEMX uint8_t *ucg_font_get_glyph_data(ucg_t *ucg, uint8_t encoding
   return NULL;
 }
 
-static ucg_int_t ucg_font_draw_glyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint8_t encoding)
+/*
+  Description:
+    Find the starting point of the glyph data in the unicode extension.
+    The table of the extension is sorted by encoding and searched binary.
+  Args:
+    encoding: Encoding (16 bit) of the glyph
+  Return:
+    Address of the glyph data or NULL, if the encoding is not avialable in the font.
+*/
+static const _MEMX uint8_t *ucg_font_get_unicode_glyph_data(ucg_t *ucg, uint16_t encoding)
+{
+  const _MEMX uint8_t *section;
+  uint16_t lo, hi, mid, e;
+  
+  if ( ucg->font_info.start_pos_unicode == 0 )
+    return NULL;
+  
+  section = ucg->font;
+  section += UCG_FONT_DATA_STRUCT_SIZE;
+  section += ucg->font_info.start_pos_unicode;
+  
+  lo = 0;
+  hi = ucg_font_get_word(section, 0);
+  while ( lo < hi )
+  {
+    mid = lo + ((hi - lo) >> 1);
+    e = ucg_font_get_word(section + 4*mid, 2);
+    if ( e == encoding )
+    {
+      return section + ucg_font_get_word(section + 4*mid, 4);
+    }
+    if ( e < encoding )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return NULL;
+}
+
+static ucg_int_t ucg_font_draw_glyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint16_t encoding)
 {
   ucg_int_t dx = 0;
   ucg->font_decode.target_x = x;
@@ -807,7 +875,7 @@ static ucg_int_t ucg_font_draw_glyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8
 
 
 
-uint8_t ucg_IsGlyph(ucg_t *ucg, uint8_t requested_encoding)
+uint8_t ucg_IsGlyph(ucg_t *ucg, uint16_t requested_encoding)
 {
   /* updated to new code */
   if ( ucg_font_get_glyph_data(ucg, requested_encoding) != NULL )
@@ -824,7 +892,7 @@ int8_t ucg_GetGlyphDeltaX(ucg_t *ucg, uint8_t requested_encoding)
 }
 */
 
-int8_t ucg_GetGlyphWidth(ucg_t *ucg, uint8_t requested_encoding)
+int8_t ucg_GetGlyphWidth(ucg_t *ucg, uint16_t requested_encoding)
 {
   const _MEMX uint8_t *glyph_data = ucg_font_get_glyph_data(ucg, requested_encoding);
   if ( glyph_data == NULL )
@@ -851,7 +919,7 @@ void ucg_SetFontMode(ucg_t *ucg, uint8_t is_transparent)
   ucg->font_decode.is_transparent = is_transparent;		// new font procedures
 }
 
-ucg_int_t ucg_DrawGlyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint8_t encoding)
+ucg_int_t ucg_DrawGlyph(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, uint16_t encoding)
 {
   switch(dir)
   {
@@ -877,7 +945,7 @@ ucg_int_t ucg_DrawString(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, cons
   sum = 0;
   while( *str != '\0' )
   {
-    delta = ucg_DrawGlyph(ucg, x, y, dir, (uint8_t)*str);
+    delta = ucg_DrawGlyph(ucg, x, y, dir, ucg_GetUTF8Char(&str));
     
     switch(dir)
     {
@@ -896,11 +964,57 @@ ucg_int_t ucg_DrawString(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, cons
     }
     
     sum += delta;    
-    str++;
   }
   return sum;
 }
 
+/*
+  Description:
+    Decode the next character of an UTF-8 string. Only the basic 
+    multilingual plane (16 bit) is supported, other characters return 0xfffd.
+    A byte that is not valid UTF-8 is returned as Latin-1 character, so 
+    existing 8 bit strings (e.g. "\xb0") still work.
+  Args:
+    str: Pointer to the string pointer, it is moved to the next character
+  Return:
+    Encoding of the character, 0 at the end of the string.
+*/
+uint16_t ucg_GetUTF8Char(const char **str)
+{
+  const uint8_t *s = (const uint8_t *)*str;
+  uint16_t e = s[0];
+  uint8_t n = 0;
+  
+  if ( e >= 0xc2 && e <= 0xdf )
+  {
+    if ( (s[1] & 0xc0) == 0x80 )
+    {
+      e = ((e & 0x1f) << 6) | (s[1] & 0x3f);
+      n = 1;
+    }
+  }
+  else if ( e >= 0xe0 && e <= 0xef )
+  {
+    if ( (s[1] & 0xc0) == 0x80 && (s[2] & 0xc0) == 0x80 && (e != 0xe0 || s[1] >= 0xa0) )
+    {
+      e = ((e & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+      n = 2;
+    }
+  }
+  else if ( e >= 0xf0 && e <= 0xf4 )
+  {
+    if ( (s[1] & 0xc0) == 0x80 && (s[2] & 0xc0) == 0x80 && (s[3] & 0xc0) == 0x80 )
+    {
+      e = 0xfffd;
+      n = 3;
+    }
+  }
+  
+  if ( e != 0 )
+    *str += n + 1;
+  return e;
+}
+
 
 /*===============================================*/
 
@@ -1022,14 +1136,14 @@ void ucg_SetFont(ucg_t *ucg, const ucg_fntpgm_uint8_t  *font)
 ucg_int_t ucg_GetStrWidth(ucg_t *ucg, const char *s)
 {
   ucg_int_t  w;
-  uint8_t encoding;
+  uint16_t encoding;
   
   /* reset the total width to zero, this will be expanded during calculation */
   w = 0;
   
   for(;;)
   {
-    encoding = *s;
+    encoding = ucg_GetUTF8Char(&s);
     if ( encoding == 0 )
       break;
 
@@ -1039,9 +1153,6 @@ ucg_int_t ucg_GetStrWidth(ucg_t *ucg, const char *s)
     
     // replaced by this:
     w += ucg_GetGlyphWidth(ucg, encoding);
-    
-    /* goto next char */
-    s++;
   }
   return w;  
 }
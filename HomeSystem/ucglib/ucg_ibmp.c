@@ -0,0 +1,207 @@
+/*!
+ *  \file    ucg_ibmp.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Indexed-color bitmaps for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           Most icons use less than 16 colors, but a bitmap for ucg_DrawBmp() uses
+ *           3 bytes per pixel. An indexed-color bitmap stores an index of 1, 2, 4 or
+ *           8 bits per pixel and a palette with the colors. The palette is stored in
+ *           the format of the display (3 bytes, 6 bits per component), so the colors
+ *           are sent without a conversion. With 1-4 bits per pixel the palette is
+ *           copied into a lookup table in RAM.
+ *
+ *           One index can be transparent, the pixels with this index are not drawn.
+ *           The other pixels are drawn in opaque spans, every span has its own window.
+ *
+ *           The bitmaps are generated by tools/ucg_ibmp.py from a PNG or PPM image.
+ *           The format is:
+ *  \verbatim
+    offset  bytes  description
+    0       2      width (high byte first)
+    2       2      height (high byte first)
+    4       1      bits per pixel (1, 2, 4 or 8)
+    5       1      flags, bit 0: the bitmap has a transparent index
+    6       1      transparent index
+    7       1      number of colors - 1
+    8       3*n    palette (red, green, blue)
+    8+3*n          pixels, from left to right and top to bottom:
+                   every row starts with a new byte,
+                   the first pixel is in the upper bits of a byte \endverbatim
+ */
+
+#include <string.h>
+#include "ucg.h"
+
+#define UCG_IBMP_HEADER_SIZE   8      //!< size of the header of an indexed-color bitmap
+#define UCG_IBMP_TRANSPARENT   0x01   //!< flag: the bitmap has a transparent index
+#define UCG_IBMP_LUT_COLORS    16     //!< number of colors of the lookup table in RAM
+
+//! the state of an indexed-color bitmap that is drawn
+typedef struct {
+  const __memx uint8_t *palette;               //!< palette in the bitmap
+  const __memx uint8_t *pixels;                //!< first row of the pixels
+  uint16_t  stride;                            //!< bytes per row
+  uint8_t   bpp;                               //!< bits per pixel
+  uint8_t   rgb[3];                            //!< color read from the palette (8 bpp)
+  uint8_t   lut[UCG_IBMP_LUT_COLORS][3];       //!< palette in RAM (1-4 bpp)
+} ucg_ibmp_t;
+
+static uint8_t _ucg_ibmp_index(ucg_ibmp_t *b, const __memx uint8_t *row, ucg_int_t c);
+static uint8_t *_ucg_ibmp_color(ucg_ibmp_t *b, uint8_t idx);
+static void _ucg_ibmp_write(ucg_t *ucg, ucg_bmp_stream_t *s, ucg_ibmp_t *b,
+                            const __memx uint8_t *row, ucg_int_t c, ucg_int_t e);
+
+/*  brief   Reads the index of a pixel
+ *
+ *  param   b       pointer to the state of the bitmap
+ *  param   row     pointer to the row of the pixel
+ *  param   c       the column of the pixel
+ *
+ *  return  the index
+ */
+static uint8_t _ucg_ibmp_index(ucg_ibmp_t *b, const __memx uint8_t *row, ucg_int_t c)
+{
+  uint16_t  bit = (uint16_t) c * b->bpp;
+
+  return (row[bit >> 3] >> (8 - b->bpp - (bit & 7))) & ((1 << b->bpp) - 1);
+}
+
+/*  brief   Gets the color of an index
+ *
+ *  param   b       pointer to the state of the bitmap
+ *  param   idx     the index
+ *
+ *  return  pointer to the color (3 bytes)
+ */
+static uint8_t *_ucg_ibmp_color(ucg_ibmp_t *b, uint8_t idx)
+{
+  const __memx uint8_t *p;
+
+  if ( b->bpp <= 4 ) return b->lut[idx];
+
+  p = b->palette + 3 * (uint16_t) idx;
+  b->rgb[0] = p[0];
+  b->rgb[1] = p[1];
+  b->rgb[2] = p[2];
+  return b->rgb;
+}
+
+/*  brief   Writes the pixels of a row to a stream, pixels with the same index
+ *          are written as one run
+ *
+ *  param   ucg     pointer to struct for the display
+ *  param   s       pointer to struct for the stream
+ *  param   b       pointer to the state of the bitmap
+ *  param   row     pointer to the row
+ *  param   c       the first column
+ *  param   e       the column after the last column
+ *
+ *  return  void
+ */
+static void _ucg_ibmp_write(ucg_t *ucg, ucg_bmp_stream_t *s, ucg_ibmp_t *b,
+                            const __memx uint8_t *row, ucg_int_t c, ucg_int_t e)
+{
+  uint8_t    idx;
+  ucg_int_t  n;
+
+  while ( c < e ) {
+    idx = _ucg_ibmp_index(b, row, c);
+    for (n = 1; (c + n < e) && (_ucg_ibmp_index(b, row, c + n) == idx); n++)
+      ;
+    ucg_WriteBmpPixels(ucg, s, n, _ucg_ibmp_color(b, idx));
+    c += n;
+  }
+}
+
+/*! \brief  Draws an indexed-color bitmap
+ *
+ *          The bitmap is clipped to the clip box. A bitmap without a transparent
+ *          index is drawn with one stream, only the visible rows and columns are
+ *          read. With a transparent index every opaque span of a row is drawn with
+ *          its own stream.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  x        the x-position of the bitmap
+ *  \param  y        the y-position of the bitmap
+ *  \param  dir      the direction of the bitmap
+ *                   0 (normal), 1 (+90*), 2 (180*) or 3 (270*),
+ *                   see ucg_OpenBmpStream() for the position
+ *  \param  ibmp     the pointer to the bitmap (generated by tools/ucg_ibmp.py)
+ *
+ *  \return void
+ */
+void ucg_DrawIBmp(ucg_t *ucg, ucg_int_t x, ucg_int_t y, uint8_t dir, const __memx uint8_t *ibmp)
+{
+  ucg_bmp_stream_t  s;
+  ucg_ibmp_t  b;
+  const __memx uint8_t *row;
+  ucg_int_t  w, h, r, c, e;
+  uint8_t    flags, transparent, ncolors, i;
+
+  w           = ((ucg_int_t) ibmp[0] << 8) | ibmp[1];
+  h           = ((ucg_int_t) ibmp[2] << 8) | ibmp[3];
+  b.bpp       = ibmp[4];
+  flags       = ibmp[5];
+  transparent = ibmp[6];
+  ncolors     = ibmp[7];                         // number of colors - 1
+  b.palette   = ibmp + UCG_IBMP_HEADER_SIZE;
+  b.pixels    = b.palette + 3 * ((uint16_t) ncolors + 1);
+  b.stride    = ((uint16_t) w * b.bpp + 7) >> 3;
+
+  if ( b.bpp <= 4 ) {
+    memset(b.lut, 0, sizeof(b.lut));
+    for (i = 0; (i <= ncolors) && (i < UCG_IBMP_LUT_COLORS); i++) {
+      b.lut[i][0] = b.palette[3*i];
+      b.lut[i][1] = b.palette[3*i+1];
+      b.lut[i][2] = b.palette[3*i+2];
+    }
+  }
+
+  if ( !(flags & UCG_IBMP_TRANSPARENT) ) {
+    if ( ! ucg_OpenBmpStream(ucg, &s, x, y, dir, w, h) ) return;
+
+    while ( s.r < s.r0 ) {
+      ucg_WriteBmpPixels(ucg, &s, w, b.lut[0]);  // invisible rows, dropped
+    }
+    while ( s.r < s.r1 ) {
+      row = b.pixels + (uint16_t) s.r * b.stride;
+      ucg_WriteBmpPixels(ucg, &s, s.c0, b.lut[0]);
+      _ucg_ibmp_write(ucg, &s, &b, row, s.c0, s.c1);
+      ucg_WriteBmpPixels(ucg, &s, w - s.c1, b.lut[0]);
+    }
+
+    ucg_CloseBmpStream(ucg, &s);
+    return;
+  }
+
+  for (r = 0; r < h; r++) {
+    row = b.pixels + (uint16_t) r * b.stride;
+    c = 0;
+    while ( c < w ) {
+      if ( _ucg_ibmp_index(&b, row, c) == transparent ) {
+        c++;
+        continue;
+      }
+      for (e = c + 1; (e < w) && (_ucg_ibmp_index(&b, row, e) != transparent); e++)
+        ;
+
+      // the span is a bitmap of one row, at the position of column c in row r
+      switch(dir & 3) {
+        case 0:  i = ucg_OpenBmpStream(ucg, &s, x + c, y + r, dir, e - c, 1); break;
+        case 1:  i = ucg_OpenBmpStream(ucg, &s, x + r, y - c, dir, e - c, 1); break;
+        case 2:  i = ucg_OpenBmpStream(ucg, &s, x - c, y - r, dir, e - c, 1); break;
+        default: i = ucg_OpenBmpStream(ucg, &s, x - r, y + c, dir, e - c, 1); break;
+      }
+      if ( i ) {
+        _ucg_ibmp_write(ucg, &s, &b, row, c, e);
+        ucg_CloseBmpStream(ucg, &s);
+      }
+      c = e;
+    }
+  }
+}
@@ -48,6 +48,9 @@ static void ucg_init_struct(ucg_t *ucg)
   //memset(ucg, 0, sizeof(ucg_t));
   ucg->is_power_up = 0;
   ucg->rotate_chain_device_cb = 0;
+  ucg->strip = 0;
+  ucg->dirty = 0;
+  ucg->aafont = 0;
   ucg->arg.scale = 1;
   //ucg->display_offset.x = 0;
   //ucg->display_offset.y = 0;
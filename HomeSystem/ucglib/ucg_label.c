@@ -0,0 +1,75 @@
+/*!
+ *  \file    ucg_label.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Pre-rendered labels for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           Most texts on the screens never change. Drawing such a text with
+ *           ucg_DrawString() decodes every glyph and draws it run by run, with a new
+ *           window for every run. A label is a text that is rendered at build time by
+ *           tools/ucg_label.py with a font, a foreground color and a background color.
+ *           The label is run-length coded with two colors and drawn in one window
+ *           with ucg_DrawLabel().
+ *
+ *           The label data format is:
+ *  \verbatim
+    offset  bytes  description
+    0       1      width
+    1       1      height
+    2       3      foreground color (red, green, blue)
+    5       3      background color (red, green, blue)
+    8              runs, from left to right and top to bottom:
+                   bit 7 is the color (1: foreground, 0: background),
+                   bit 6-0 is the run length - 1 \endverbatim
+ *
+ *           The label is a const __memx uint8_t array, so the complete program space
+ *           can be used.
+ */
+
+#include "ucg.h"
+
+#define UCG_LABEL_HEADER_SIZE  8      //!< size of the header of a label
+
+/*! \brief  Draws a label
+ *
+ *          The label is drawn in one window and is clipped to the clip box of the
+ *          display. The colors of the label are used, the colors of the display
+ *          are not changed.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  x        the x-position of the upper left corner of the label
+ *  \param  y        the y-position of the upper left corner of the label
+ *  \param  label    the pointer to the label (generated by tools/ucg_label.py)
+ *
+ *  \return the width of the label
+ */
+ucg_int_t ucg_DrawLabel(ucg_t *ucg, ucg_int_t x, ucg_int_t y, const __memx uint8_t *label)
+{
+  ucg_bmp_stream_t  s;
+  uint8_t  color[2][3];
+  uint8_t  w, h, b, i;
+
+  w = label[0];
+  h = label[1];
+  for (i = 0; i < 3; i++) {
+    color[1][i] = label[2+i];
+    color[0][i] = label[5+i];
+  }
+
+  if ( ! ucg_OpenBmpStream(ucg, &s, x, y, 0, w, h) ) return w;
+
+  label += UCG_LABEL_HEADER_SIZE;
+  while ( s.r < s.r1 ) {
+    b = *label;
+    label++;
+    ucg_WriteBmpPixels(ucg, &s, (b & 0x7f) + 1, color[b >> 7]);
+  }
+
+  ucg_CloseBmpStream(ucg, &s);
+
+  return w;
+}
@@ -15,37 +15,41 @@
  *           and in stead of <code>print</code> and <code>println</code> 
  *           you can use <code>ucg_Print()</code> which prints a formatstring.
  *
- *           This print facility uses the user pointer in the struct ucg_t. To use this
- *           pointer you need to remove the comment (at line 100 in ucg.h), before the 
- *           macrodefinition of  WITH_USER_PTR
- *  \verbatim
-             / * Define this for an additional user pointer inside the ucg data struct * /
-             #define WITH_USER_PTR\endverbatim
+ *           <code>ucg_Print()</code> doesn't use printf from avr-libc. A small formatter
+ *           writes the text in a buffer on the stack (UCG_PRINT_BUF_LEN characters) and 
+ *           the complete string is drawn at once. There is no heap use. Besides the 
+ *           integer conversions it knows fixed-point, temperature and percent formats, 
+ *           see ucg_Print().
+ *
+ *           The print position and direction are kept in the struct ucg_t of the 
+ *           display, so every display has its own print position.
  *             
  *           Originally these functionality was added in the Xmega Hardware Abstraction 
  *           Layer (version 2.0, 2.1 and 3.0). From vesion 4.0 this functionality is 
  *           separated from the HAL.
  *
+ *           A text field (<code>ucg_textfield_t</code>) remembers the text and the 
+ *           positions of the glyphs it has drawn. <code>ucg_UpdateTextField()</code> 
+ *           and <code>ucg_PrintTextField()</code> only redraw the glyph cells that are 
+ *           changed. With a proportional font a glyph with another width shifts the
+ *           rest of the text, in that case the whole tail is redrawn.
+ *           Readouts like a temperature or a clock change one or two characters per
+ *           update, so most of the glyphs are not sent to the display again.
+ *
  */
  
-#include <stdio.h>
-#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 #include <stdarg.h>
 #include "ucg.h"
 
-//!< Struct for compatibility printing facilities with Arduino/C++ version of library 
-typedef struct {      
-  FILE      *fp;      //!< file pointer for printing 
-  ucg_int_t  tx;      //!< current x coordinate of the position
-  ucg_int_t  ty;      //!< current y coordinate of the position
-  uint8_t    tdir;    //!< current printing direction
-} ucg_print_t;           
-
-static int   _ucg_putc(char c, FILE *stream);
-
-static ucg_t  *_curr_ucg;   //!< pointer necessary for the printing facilities
+static void  _ucg_print_str(ucg_t *ucg, const char *str);
+static int   _ucg_vformat(char *buf, uint8_t size, const char *fmt, va_list vl);
+static void  _ucg_textfield_clear(ucg_t *ucg, ucg_textfield_t *tf, ucg_int_t from, ucg_int_t to);
 
 /*! \brief  Initializes the printing facilities compatible with Arduino/C++ version of library
+ *
+ *          The print position is set to (0,0) and the direction to 0.
  *
  *  \param  ucg      pointer to struct for the display
  *
@@ -53,18 +57,9 @@ static ucg_t  *_curr_ucg;   //!< pointer necessary for the printing facilities
  */
 void ucg_PrintInit(ucg_t *ucg)
 {
-  if  (ucg_GetUserPtr(ucg) != NULL) return;
-  
-  ucg_print_t *p = (ucg_print_t *) malloc(sizeof(ucg_print_t));
-  
-  if (p == NULL) return;
-  
-  p->fp    = fdevopen(_ucg_putc, NULL); 
-  p->tx    = 0;
-  p->ty    = 0;
-  p->tdir  = 0;
-  
-  ucg_SetUserPtr(ucg, p);
+  ucg->print_pos.x = 0;
+  ucg->print_pos.y = 0;
+  ucg->print_dir   = 0;
 }
 /*! \brief  Gets the current position of the 'print cursor'
  *
@@ -76,8 +71,8 @@ void ucg_PrintInit(ucg_t *ucg)
  */
 void ucg_GetPrintPos(ucg_t *ucg, ucg_int_t *x, ucg_int_t *y)
 {
-  *x = ((ucg_print_t *)ucg_GetUserPtr(ucg))->tx;
-  *y = ((ucg_print_t *)ucg_GetUserPtr(ucg))->ty;
+  *x = ucg->print_pos.x;
+  *y = ucg->print_pos.y;
 }
 
 
@@ -91,8 +86,8 @@ void ucg_GetPrintPos(ucg_t *ucg, ucg_int_t *x, ucg_int_t *y)
  */
 void ucg_SetPrintPos(ucg_t *ucg, ucg_int_t x, ucg_int_t y)
 {
-  ((ucg_print_t *)ucg->user_ptr)->tx = x;
-  ((ucg_print_t *)ucg->user_ptr)->ty = y;
+  ucg->print_pos.x = x;
+  ucg->print_pos.y = y;
 }
 
 
@@ -105,7 +100,7 @@ void ucg_SetPrintPos(ucg_t *ucg, ucg_int_t x, ucg_int_t y)
  */
 void ucg_SetPrintDir(ucg_t *ucg, uint8_t dir)
 {
-  ((ucg_print_t *)ucg_GetUserPtr(ucg))->tdir = dir;
+  ucg->print_dir = dir;
 }
 
 
@@ -114,6 +109,21 @@ void ucg_SetPrintDir(ucg_t *ucg, uint8_t dir)
  *
  *          This replaces print and println from the Arduino implementation of ucg_lib
  *
+ *          The formatstring is a subset of printf with some extra conversions:
+ * \verbatim
+ *          %c  %s  %%                character, string and a percent sign
+ *          %d  %i  %u  %x  %X        int, unsigned and hexadecimal values
+ *          %ld %li %lu %lx %lX       the same for long values
+ *          %.nF                      fixed-point value with n decimals:   %.2F   1234 -> 12.34
+ *          %.nT                      temperature with n decimals (default 1):  %T  214 -> 21.4°C
+ *          %.nP                      percentage with n decimals (default 0):   %P   45 -> 45% \endverbatim
+ *
+ *          The flags '-' (left-justify) and '0' (zero padding) and a field width can be used.
+ *          At most 10 decimals are printed. The degree sign is character 176 (0xB0) of the font.
+ *          There are no floating point conversions. An unknown conversion (e.g. %f) is 
+ *          printed as is and ends the formatting, because the size of its argument is unknown.
+ *          The text is truncated after UCG_PRINT_BUF_LEN characters.
+ *
  *          The Arduino style:
  * \verbatim
  *          ucg.print("text ");
@@ -124,7 +134,7 @@ void ucg_SetPrintDir(ucg_t *ucg, uint8_t dir)
  *              
  *          The replacement in Xmega style:
  *\verbatim
- *          ucg_Print(&ucg, "text %d more text %f;\n", x, y); \endverbatim
+ *          ucg_Print(&ucg, "text %d more text %.2F;\n", x, y);   // y is a fixed-point value, y = 1234 is 12.34 \endverbatim
  *
  *  \param  ucg      pointer to struct for the display
  *  \param  fmt      formatstring with escape sequences
@@ -134,42 +144,413 @@ void ucg_SetPrintDir(ucg_t *ucg, uint8_t dir)
  */
 int ucg_Print(ucg_t *ucg, char *fmt, ...)
 {
+  char     buf[UCG_PRINT_BUF_LEN+1];
   va_list  vl;
+  int      n;
 
-  _curr_ucg = ucg;
   va_start(vl, fmt);
-  int n = vfprintf( ((ucg_print_t *) (ucg_GetUserPtr(ucg)))->fp, fmt, vl);
+  n = _ucg_vformat(buf, sizeof(buf), fmt, vl);
   va_end(vl);
 
+  _ucg_print_str(ucg, buf);
+
   return n;
 }
 
 
+/*! \brief  Initializes a text field
+ *
+ *          Nothing is drawn. The first update of the text field draws the complete text.
+ *
+ *  \param  tf       pointer to struct for the text field
+ *  \param  x        x-coordinate of the reference point
+ *  \param  y        y-coordinate of the reference point
+ *  \param  dir      the direction of the text
+ *
+ *  \return void
+ */
+void ucg_InitTextField(ucg_textfield_t *tf, ucg_int_t x, ucg_int_t y, uint8_t dir)
+{
+  tf->font    = NULL;
+  tf->x       = x;
+  tf->y       = y;
+  tf->dir     = dir;
+  tf->len     = 0;
+  tf->top     = 0;
+  tf->height  = 0;
+  tf->pos[0]  = 0;
+}
+
+
+/*! \brief  Updates the text of a text field
+ *
+ *          Only the glyphs that differ from the previous text, or that are moved 
+ *          because a preceding glyph has another width, are redrawn. The cell of a 
+ *          redrawn glyph is cleared with the background color (index 1) first. If the 
+ *          font is a monospace font and the font mode is solid the glyph itself 
+ *          covers its cell and the cell is not cleared. If the new text is shorter
+ *          the remaining part of the old text is cleared.
+ *
+ *          The text field uses the current font, font position and colors.
+ *          Another font clears the text field and redraws the whole text.
+ *          Glyphs that are drawn outside their cell (e.g. italic fonts) are not 
+ *          cleared correctly. 
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  tf       pointer to struct for the text field
+ *  \param  str      the new text (UTF-8), at most UCG_TEXTFIELD_LEN characters are drawn
+ *
+ *  \return the width of the new text
+ */
+ucg_int_t ucg_UpdateTextField(ucg_t *ucg, ucg_textfield_t *tf, const char *str)
+{
+  ucg_int_t  pos[UCG_TEXTFIELD_LEN+1];
+  uint16_t   text[UCG_TEXTFIELD_LEN];
+  ucg_int_t  x, y;
+  uint8_t    len = 0;
+  uint8_t    i;
+  uint8_t    is_transparent = ucg->font_decode.is_transparent;
+  uint8_t    is_cell_glyph;
+
+  // another font: clear the old text and redraw everything
+  if ( tf->font != ucg->font ) {
+    ucg_ClearTextField(ucg, tf);
+    tf->font   = ucg->font;
+    tf->top    = ucg->font_info.max_char_height + ucg->font_info.y_offset - ucg->font_calc_vref(ucg);
+    tf->height = ucg->font_info.max_char_height;
+  }
+
+  // the cells of the new text
+  pos[0] = 0;
+  while ( (len < UCG_TEXTFIELD_LEN) && (*str != '\0') ) {
+    text[len]  = ucg_GetUTF8Char(&str);
+    pos[len+1] = pos[len] + ucg_GetGlyphWidth(ucg, text[len]);
+    len++;
+  }
+
+  // a solid glyph of a monospace font covers its cell completely
+  is_cell_glyph = (ucg->font_info.bbx_mode >= 2) && (is_transparent == 0);
+  if ( ! is_cell_glyph ) {
+    ucg->font_decode.is_transparent = 1;
+  }
+
+  for (i = 0; i < len; i++) {
+    if ( (i < tf->len) && (text[i] == tf->text[i]) && (pos[i] == tf->pos[i]) ) continue;
+
+    if ( ! is_cell_glyph ) {
+      _ucg_textfield_clear(ucg, tf, pos[i], pos[i+1]);
+    }
+    x = tf->x;
+    y = tf->y;
+    switch(tf->dir) {
+      case          0: x += pos[i]; break;
+      case          1: y += pos[i]; break;
+      case          2: x -= pos[i]; break;
+      default: case 3: y -= pos[i]; break;
+    }
+    ucg_DrawGlyph(ucg, x, y, tf->dir, text[i]);
+    tf->text[i] = text[i];
+  }
+
+  // clear the tail of the old text
+  _ucg_textfield_clear(ucg, tf, pos[len], tf->pos[tf->len]);
+
+  ucg->font_decode.is_transparent = is_transparent;
+  memcpy(tf->pos, pos, (len+1) * sizeof(ucg_int_t));
+  tf->len = len;
+
+  return pos[len];
+}
+
+
+/*! \brief  Updates a text field with a formatted string
+ *
+ *          The formatted string is written in a buffer on the stack and
+ *          drawn with ucg_UpdateTextField(). The formatstring is the same
+ *          as the formatstring of ucg_Print().
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  tf       pointer to struct for the text field
+ *  \param  fmt      formatstring with escape sequences
+ *  \param  ...      variables that are printed
+ *
+ *  \return number of printed characters
+ */
+int ucg_PrintTextField(ucg_t *ucg, ucg_textfield_t *tf, char *fmt, ...)
+{
+  char     buf[UCG_PRINT_BUF_LEN+1];
+  va_list  vl;
+
+  va_start(vl, fmt);
+  _ucg_vformat(buf, sizeof(buf), fmt, vl);
+  va_end(vl);
+
+  ucg_UpdateTextField(ucg, tf, buf);
+
+  return tf->len;
+}
+
+
+/*! \brief  Clears the text of a text field
+ *
+ *          The cells of the drawn text are filled with the background color (index 1).
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  tf       pointer to struct for the text field
+ *
+ *  \return void
+ */
+void ucg_ClearTextField(ucg_t *ucg, ucg_textfield_t *tf)
+{
+  if ( tf->font != NULL ) {
+    _ucg_textfield_clear(ucg, tf, 0, tf->pos[tf->len]);
+  }
+  tf->font    = NULL;
+  tf->len     = 0;
+  tf->pos[0]  = 0;
+}
+
+
 
 // local print facilities
 
 
-/*  brief  Put a character to the display at the
+/*  brief  Put a string to the display at the
  *         current position and in the current direction.
+ *         The position is moved to the end of the string.
  *
  *  param  ucg      pointer to struct for the display
- *  param  dir      the direction
+ *  param  str      the string
  *
- *  return 0  (always OK, one character printed)
+ *  return void
  */
-static int _ucg_putc(char c, FILE *stream)
+static void _ucg_print_str(ucg_t *ucg, const char *str)
 {
   ucg_int_t delta;
-  ucg_print_t *p = ((ucg_print_t *) ucg_GetUserPtr(_curr_ucg));
 
-  delta = ucg_DrawGlyph(_curr_ucg, p->tx, p->ty, p->tdir, c);
+  delta = ucg_DrawString(ucg, ucg->print_pos.x, ucg->print_pos.y, ucg->print_dir, str);
+
+  switch(ucg->print_dir) {
+    case          0: ucg->print_pos.x += delta; break;
+    case          1: ucg->print_pos.y += delta; break;
+    case          2: ucg->print_pos.x -= delta; break;
+    default: case 3: ucg->print_pos.y -= delta; break;
+  }
+}
+
+
+/*  brief  Writes a formatted string to a buffer
+ *         See ucg_Print() for the formatstring.
+ *
+ *  param  buf      pointer to the buffer
+ *  param  size     size of the buffer including the terminating '\0'
+ *  param  fmt      formatstring with escape sequences
+ *  param  vl       variables that are printed
+ *
+ *  return number of characters in the buffer
+ */
+static int _ucg_vformat(char *buf, uint8_t size, const char *fmt, va_list vl)
+{
+  char        num[16];             // digits, sign, decimal point and suffix
+  char       *p   = buf;
+  char       *end = buf + size - 1;
+  const char *s;
+  char        c;
+  uint8_t     left, zero, is_long, has_prec, prec, width, len;
+  uint8_t     base, upper, is_neg, is_num;
+  uint32_t    val;
+  const char *suffix;
+
+  while ( (c = *fmt++) != '\0' ) {
+    if ( c != '%' ) {
+      if ( p < end ) *p++ = c;
+      continue;
+    }
+
+    // flags, width, precision and length
+    left = zero = is_long = has_prec = 0;
+    width = prec = 0;
+    for (;;) {
+      if      ( *fmt == '-' ) left = 1;
+      else if ( *fmt == '0' ) zero = 1;
+      else break;
+      fmt++;
+    }
+    while ( (*fmt >= '0') && (*fmt <= '9') ) {
+      width = width*10 + (*fmt++ - '0');
+    }
+    if ( *fmt == '.' ) {
+      fmt++;
+      has_prec = 1;
+      while ( (*fmt >= '0') && (*fmt <= '9') ) {
+        prec = prec*10 + (*fmt++ - '0');
+      }
+    }
+    if ( *fmt == 'l' ) {
+      is_long = 1;
+      fmt++;
+    }
+    c = *fmt++;
+    if ( c == '\0' ) break;
+
+    // conversion to a string s with length len
+    s        = num;
+    suffix   = "";
+    is_neg   = 0;
+    is_num   = 1;
+    base     = 10;
+    upper    = 0;
+    switch (c) {
+      case 'c':
+        num[0] = (char) va_arg(vl, int);
+        num[1] = '\0';
+        is_num = 0;
+        zero   = 0;
+        break;
+      case 's':
+        s      = va_arg(vl, const char *);
+        is_num = 0;
+        zero   = 0;
+        break;
+      case 'd': case 'i': case 'F': case 'T': case 'P':
+        if ( is_long ) {
+          int32_t v = va_arg(vl, long);
+          is_neg = (v < 0);
+          val = is_neg ? -(uint32_t)v : (uint32_t)v;
+        } else {
+          int v = va_arg(vl, int);
+          is_neg = (v < 0);
+          val = is_neg ? -(uint32_t)(int32_t)v : (uint32_t)v;
+        }
+        if ( c == 'd' || c == 'i' ) prec = 0;
+        if ( c == 'T' ) {
+          suffix = "\xb0" "C";
+          if ( ! has_prec ) prec = 1;
+        }
+        if ( c == 'P' ) suffix = "%";
+        break;
+      case 'X':
+        upper = 1;
+        /* fall through */
+      case 'x':
+        base = 16;
+        /* fall through */
+      case 'u':
+        val  = is_long ? va_arg(vl, unsigned long) : va_arg(vl, unsigned int);
+        prec = 0;
+        break;
+      case '%':
+        num[0] = '%';
+        num[1] = '\0';
+        is_num = 0;
+        zero   = 0;
+        break;
+      default:
+        // unknown: the size of the argument is unknown, so stop after it
+        num[0] = '%';
+        num[1] = c;
+        num[2] = '\0';
+        is_num = 0;
+        zero   = 0;
+        fmt    = "";
+        break;
+    }
+
+    if ( is_num ) {
+      // number: written backwards from the end of num
+      // room for '\0', suffix (2), '.', leading '0' and sign, the rest for 
+      // the digits: 10 digits is the largest uint32_t 
+      char *q = num + sizeof(num) - 1;
+      if ( prec > sizeof(num) - 6 ) prec = sizeof(num) - 6;
+      uint8_t i = strlen(suffix);
+      *q = '\0';
+      while ( i > 0 ) *--q = suffix[--i];
+      do {
+        uint8_t d = val % base;
+        val /= base;
+        *--q = (d < 10) ? ('0' + d) : ((upper ? 'A' : 'a') + d - 10);
+        if ( prec > 0 && --prec == 0 ) {
+          *--q = '.';
+          if ( val == 0 ) *--q = '0';
+        }
+      } while ( val != 0 || prec > 0 );
+      if ( is_neg ) *--q = '-';
+      s = q;
+    }
+
+    // padding
+    len = strlen(s);
+    if ( zero && ! left && (*s == '-') && (width > len) ) {
+      if ( p < end ) *p++ = *s;
+      s++;
+      len--;
+      width--;
+    }
+    while ( ! left && (width > len) ) {
+      if ( p < end ) *p++ = zero ? '0' : ' ';
+      width--;
+    }
+    while ( *s != '\0' ) {
+      if ( p < end ) *p++ = *s;
+      s++;
+    }
+    while ( left && (width > len) ) {
+      if ( p < end ) *p++ = ' ';
+      width--;
+    }
+  }
+  *p = '\0';
+
+  return p - buf;
+}
+
+
+/*  brief  Fills a part of the cells of a text field with the background color (index 1)
+ *
+ *  param  ucg      pointer to struct for the display
+ *  param  tf       pointer to struct for the text field
+ *  param  from     offset of the first cell along the direction of the text
+ *  param  to       offset after the last cell along the direction of the text
+ *
+ *  return void
+ */
+static void _ucg_textfield_clear(ucg_t *ucg, ucg_textfield_t *tf, ucg_int_t from, ucg_int_t to)
+{
+  ucg_int_t bx, by, w, h;
+
+  if ( to <= from ) return;
 
-  switch(p->tdir) {
-    case          0: p->tx += delta; break;
-    case          1: p->ty += delta; break;
-    case          2: p->tx -= delta; break;
-    default: case 3: p->ty -= delta; break;
+  switch(tf->dir) {
+    case 0:
+      bx = tf->x + from;
+      by = tf->y - tf->top;
+      w  = to - from;
+      h  = tf->height;
+      break;
+    case 1:
+      bx = tf->x + tf->top - tf->height + 1;
+      by = tf->y + from;
+      w  = tf->height;
+      h  = to - from;
+      break;
+    case 2:
+      bx = tf->x - to + 1;
+      by = tf->y + tf->top - tf->height + 1;
+      w  = to - from;
+      h  = tf->height;
+      break;
+    default:
+    case 3:
+      bx = tf->x - tf->top;
+      by = tf->y - to + 1;
+      w  = tf->height;
+      h  = to - from;
+      break;
   }
 
-  return 0;
-}
\ No newline at end of file
+  while ( h > 0 ) {
+    ucg_Draw90Line(ucg, bx, by, w, 0, 1);
+    by++;
+    h--;
+  }
+}
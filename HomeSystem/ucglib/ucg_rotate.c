@@ -118,6 +118,8 @@ static ucg_int_t ucg_dev_rotate90(ucg_t *ucg, ucg_int_t msg, void *data)
       ucg_rotate_90_xy(&(ucg->arg.pixel.pos), ucg->rotate_dimension.w); 
       //printf("post x=%d y=%d\n", ucg->arg.pixel.pos.x, ucg->arg.pixel.pos.y);
       break;
+    case UCG_MSG_SET_WINDOW:
+      return 0;		/* the rows of the window would be columns of the display */
   }
   return ucg->rotate_chain_device_cb(ucg, msg, data);  
 }
@@ -179,6 +181,15 @@ static ucg_int_t ucg_dev_rotate180(ucg_t *ucg, ucg_int_t msg, void *data)
       ucg->arg.dir&=3;
       ucg_rotate_180_xy(ucg, &(ucg->arg.pixel.pos)); 
       break;
+    case UCG_MSG_SET_WINDOW:
+      /* rotate the box and mirror the scan order, the window of the caller is not changed */
+      {
+        ucg_window_t window = *(ucg_window_t *)data;
+        window.box.ul.x = ucg->rotate_dimension.w - window.box.ul.x - window.box.size.w;
+        window.box.ul.y = ucg->rotate_dimension.h - window.box.ul.y - window.box.size.h;
+        window.scan ^= UCG_WINDOW_MIRROR_X | UCG_WINDOW_MIRROR_Y;
+        return ucg->rotate_chain_device_cb(ucg, msg, &window);
+      }
   }
   return ucg->rotate_chain_device_cb(ucg, msg, data);  
 }
@@ -244,6 +255,8 @@ static ucg_int_t ucg_dev_rotate270(ucg_t *ucg, ucg_int_t msg, void *data)
       ucg->arg.dir&=3;
       ucg_rotate_270_xy(ucg, &(ucg->arg.pixel.pos)); 
       break;
+    case UCG_MSG_SET_WINDOW:
+      return 0;		/* the rows of the window would be columns of the display */
   }
   return ucg->rotate_chain_device_cb(ucg, msg, data);  
 }
@@ -258,3 +271,59 @@ void ucg_SetRotate270(ucg_t *ucg)
   ucg_SetMaxClipRange(ucg);
 }
 
+
+/*================================================*/
+/* clip box */
+
+/*
+  ucg->clip_box is rotated by UCG_MSG_SET_CLIP_BOX, it is in the coordinates of the 
+  controller. This returns the clip box in the coordinates of the rotated display 
+  (used by ucg_bmp.c to clip a bitmap before the window is set).
+  While a strip is drawn (ucg_strip.c), this is the visible part of the strip.
+*/
+void ucg_GetRotatedClipBox(ucg_t *ucg, ucg_box_t *box)
+{
+  const ucg_box_t *cb = &(ucg->clip_box);
+  ucg_dev_fnptr dev_cb = ucg->device_cb;
+  
+  if ( ucg->strip != NULL )
+  {
+    if ( ucg->strip->y >= 0 )
+      cb = &(ucg->strip->page);
+    if ( dev_cb != ucg_dev_rotate90 && dev_cb != ucg_dev_rotate180 && dev_cb != ucg_dev_rotate270 )
+    {
+      /* the strip is above the rotation: the strip is not rotated */
+      if ( ucg->strip->y >= 0 )
+      {
+	*box = *cb;
+	return;
+      }
+      dev_cb = ucg->strip->chain_device_cb;
+    }
+  }
+  
+  if ( dev_cb == ucg_dev_rotate90 )
+  {
+    box->ul.x = cb->ul.y;
+    box->ul.y = ucg->rotate_dimension.w - cb->ul.x - cb->size.w;
+    box->size.w = cb->size.h;
+    box->size.h = cb->size.w;
+  }
+  else if ( dev_cb == ucg_dev_rotate180 )
+  {
+    box->ul.x = ucg->rotate_dimension.w - cb->ul.x - cb->size.w;
+    box->ul.y = ucg->rotate_dimension.h - cb->ul.y - cb->size.h;
+    box->size = cb->size;
+  }
+  else if ( dev_cb == ucg_dev_rotate270 )
+  {
+    box->ul.x = ucg->rotate_dimension.h - cb->ul.y - cb->size.h;
+    box->ul.y = cb->ul.x;
+    box->size.w = cb->size.h;
+    box->size.h = cb->size.w;
+  }
+  else
+  {
+    *box = *cb;
+  }
+}
@@ -120,6 +120,8 @@ static ucg_int_t ucg_dev_scale2x2(ucg_t *ucg, ucg_int_t msg, void *data)
       
       //printf("post clipbox x=%d y=%d\n", ((ucg_box_t * )data)->ul.x, ((ucg_box_t * )data)->ul.y);
       break;
+    case UCG_MSG_SET_WINDOW:
+      return 0;		/* every pixel must be sent four times */
     case UCG_MSG_DRAW_PIXEL:
       xy = ucg->arg.pixel.pos;
       ucg->arg.pixel.pos.x *= 2;
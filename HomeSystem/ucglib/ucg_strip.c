@@ -0,0 +1,438 @@
+/*!
+ *  \file    ucg_strip.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Strip buffer (page mode) for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           ucglib draws directly to the display: a background is drawn and then the
+ *           text is drawn over it, which is visible as flicker, and every pixel that
+ *           is drawn twice is sent twice. A framebuffer of 128x160 pixels doesn't fit
+ *           in the SRAM of the Xmega. Like the page mode of u8g2 the picture is drawn
+ *           in strips of a few lines: the picture is drawn for every strip into a
+ *           buffer in RAM (RGB 565, 2 bytes per pixel) and then the strip is sent in
+ *           one window. A strip of 128x16 pixels uses 4 kB.
+ *
+ *           The strip buffer is a device callback like ucg_SetRotate90() and
+ *           ucg_SetScale2x2(), so all drawing functions (boxes, lines, fonts, bitmaps,
+ *           tile maps) draw into the buffer without changes:
+ *  \code
+    static ucg_strip_t strip;
+    static uint8_t     buf[UCG_STRIP_BUF_SIZE(128, 16)];
+
+    ucg_SetStrip(&ucg, &strip, buf, 16);
+    ucg_FirstPage(&ucg);
+    do {
+      ucg_SetColor(&ucg, 0, 0, 0, 80);
+      ucg_DrawBox(&ucg, 0, 0, 128, 160);
+      ucg_DrawString(&ucg, 10, 40, 0, "21.5 C");
+    } while ( ucg_NextPage(&ucg) ); \endcode
+ *
+ *           Only the strips in the clip box are drawn and only the part in the clip
+ *           box is sent, so every pixel in the clip box is sent exactly once.
+ *           Outside ucg_FirstPage() ... ucg_NextPage() the drawing functions draw
+ *           directly to the display.
+ *
+ *           The strip buffer contains the pixels that are already drawn, so it is
+ *           used for semi-transparent drawing: after ucg_SetAlpha() all drawing
+ *           functions (boxes, fonts, bitmaps) blend their pixels with the buffer,
+ *           e.g. for a popup over the picture or a fade. The displays are connected
+ *           without a read line, so without a strip buffer the pixels are drawn
+ *           opaque. Horizontal lines (boxes) are blended in a loop per span with
+ *           two 8x8 bit multiplications per component.
+ */
+
+#include <string.h>
+#include "ucg.h"
+
+static ucg_int_t ucg_dev_strip(ucg_t *ucg, ucg_int_t msg, void *data);
+static void _ucg_strip_page(ucg_t *ucg);
+static void _ucg_strip_pixel(ucg_strip_t *st, ucg_int_t x, ucg_int_t y, uint8_t *rgb);
+static void _ucg_strip_span(ucg_strip_t *st, ucg_int_t x, ucg_int_t y, ucg_int_t n, uint8_t *rgb);
+static void _ucg_strip_color(const uint8_t *p, uint8_t *rgb);
+static void _ucg_strip_lines(ucg_t *ucg, const uint8_t *p, ucg_int_t x, ucg_int_t y, ucg_int_t w);
+static void _ucg_strip_send(ucg_t *ucg);
+
+/*  brief   Calculates the visible part of the current strip (clip box and strip)
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  void
+ */
+static void _ucg_strip_page(ucg_t *ucg)
+{
+  ucg_strip_t *st = ucg->strip;
+  ucg_int_t  y0 = st->y;
+  ucg_int_t  y1 = st->y + st->lines;
+
+  if ( y0 < st->clip.ul.y ) y0 = st->clip.ul.y;
+  if ( y1 > st->clip.ul.y + st->clip.size.h ) y1 = st->clip.ul.y + st->clip.size.h;
+  if ( y1 < y0 ) y1 = y0;
+
+  st->page.ul.x   = st->clip.ul.x;
+  st->page.size.w = st->clip.size.w;
+  st->page.ul.y   = y0;
+  st->page.size.h = y1 - y0;
+
+  memset(st->buf, 0, (uint16_t) st->width * st->lines * 2);
+}
+
+/*  brief   Writes a span of pixels with the same color into the strip buffer,
+ *          the pixels are blended with the buffer if an alpha is set
+ *
+ *          The components are blended with 8 bit alpha:
+ *          c = (f * alpha + b * (255 - alpha)) / 255, the multiplications of the
+ *          foreground color are done once for the span.
+ *
+ *  param   st      pointer to struct for the strip
+ *  param   x       the x-position of the first pixel
+ *  param   y       the y-position of the pixels
+ *  param   n       the number of pixels (inside the visible part)
+ *  param   rgb     the color (3 bytes)
+ *
+ *  return  void
+ */
+static void _ucg_strip_span(ucg_strip_t *st, ucg_int_t x, ucg_int_t y, ucg_int_t n, uint8_t *rgb)
+{
+  uint8_t  *p = st->buf + ((uint16_t) (y - st->y) * st->width + x) * 2;
+  uint8_t   hi = (rgb[0] & 0xf8) | (rgb[1] >> 5);
+  uint8_t   lo = ((rgb[1] << 3) & 0xe0) | (rgb[2] >> 3);
+  uint8_t   a = st->alpha;
+  uint8_t   ia = 255 - a;
+  uint16_t  fr, fg, fb, c;
+  uint8_t   r, g, b;
+
+  if ( a == 255 ) {
+    while ( n-- > 0 ) {
+      *p++ = hi;
+      *p++ = lo;
+    }
+    return;
+  }
+
+  fr = (uint16_t) (rgb[0] >> 3) * a;            // 5 bit
+  fg = (uint16_t) (rgb[1] >> 2) * a;            // 6 bit
+  fb = (uint16_t) (rgb[2] >> 3) * a;            // 5 bit
+  while ( n-- > 0 ) {
+    r = p[0] >> 3;
+    g = ((p[0] << 3) & 0x38) | (p[1] >> 5);
+    b = p[1] & 0x1f;
+    c = fr + (uint16_t) r * ia;  r = (c + (c >> 8) + 1) >> 8;
+    c = fg + (uint16_t) g * ia;  g = (c + (c >> 8) + 1) >> 8;
+    c = fb + (uint16_t) b * ia;  b = (c + (c >> 8) + 1) >> 8;
+    *p++ = (r << 3) | (g >> 3);
+    *p++ = (g << 5) | b;
+  }
+}
+
+/*  brief   Writes a pixel into the strip buffer, pixels outside the visible part
+ *          are dropped
+ *
+ *  param   st      pointer to struct for the strip
+ *  param   x       the x-position of the pixel
+ *  param   y       the y-position of the pixel
+ *  param   rgb     the color (3 bytes)
+ *
+ *  return  void
+ */
+static void _ucg_strip_pixel(ucg_strip_t *st, ucg_int_t x, ucg_int_t y, uint8_t *rgb)
+{
+  if ( (x < st->page.ul.x) || (x >= st->page.ul.x + st->page.size.w) ) return;
+  if ( (y < st->page.ul.y) || (y >= st->page.ul.y + st->page.size.h) ) return;
+
+  _ucg_strip_span(st, x, y, 1, rgb);
+}
+
+/*  brief   Converts a pixel of the strip buffer (RGB 565) to 3 bytes, the upper
+ *          bits are repeated in the lower bits
+ *
+ *  param   p       pointer to the pixel in the buffer
+ *  param   rgb     the color (3 bytes)
+ *
+ *  return  void
+ */
+static void _ucg_strip_color(const uint8_t *p, uint8_t *rgb)
+{
+  uint8_t g = (p[0] << 5) | ((p[1] >> 3) & 0x1c);
+
+  rgb[0] = (p[0] & 0xf8) | (p[0] >> 5);
+  rgb[1] = g | (g >> 6);
+  rgb[2] = (p[1] << 3) | ((p[1] >> 2) & 0x07);
+}
+
+/*  brief   Sends a row of the strip buffer as lines of the same color, used if
+ *          the display (or a rotation below the strip) has no window
+ *
+ *  param   ucg     pointer to struct for the display
+ *  param   p       pointer to the first pixel of the row in the buffer
+ *  param   x       the x-position of the first pixel
+ *  param   y       the y-position of the row
+ *  param   w       the number of pixels
+ *
+ *  return  void
+ */
+static void _ucg_strip_lines(ucg_t *ucg, const uint8_t *p, ucg_int_t x, ucg_int_t y, ucg_int_t w)
+{
+  ucg_int_t  n;
+
+  while ( w > 0 ) {
+    for (n = 1; (n < w) && (p[2*n] == p[0]) && (p[2*n+1] == p[1]); n++)
+      ;
+    _ucg_strip_color(p, ucg->arg.pixel.rgb.color);
+    ucg->arg.pixel.pos.x = x;
+    ucg->arg.pixel.pos.y = y;
+    ucg->arg.len = n;
+    ucg->arg.dir = 0;
+    ucg->strip->chain_device_cb(ucg, UCG_MSG_DRAW_L90FX, &(ucg->arg));
+    p += 2*n;
+    x += n;
+    w -= n;
+  }
+}
+
+/*  brief   Sends the visible part of the strip buffer to the display
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  void
+ */
+static void _ucg_strip_send(ucg_t *ucg)
+{
+  ucg_strip_t  *st = ucg->strip;
+  ucg_window_t  win;
+  ucg_pixels_t  px;
+  uint8_t   rgb[UCG_BMP_STREAM_PIXELS*3];
+  uint8_t  *p;
+  uint8_t   i, k;
+  ucg_int_t y, n;
+
+  if ( (st->page.size.w <= 0) || (st->page.size.h <= 0) ) return;
+
+  win.box  = st->page;
+  win.scan = 0;
+  if ( st->chain_device_cb(ucg, UCG_MSG_SET_WINDOW, &win) == 0 ) {
+    for (y = st->page.ul.y; y < st->page.ul.y + st->page.size.h; y++) {
+      p = st->buf + ((uint16_t) (y - st->y) * st->width + st->page.ul.x) * 2;
+      _ucg_strip_lines(ucg, p, st->page.ul.x, y, st->page.size.w);
+    }
+    return;
+  }
+
+  px.rgb    = rgb;
+  px.repeat = 0;
+  for (y = st->page.ul.y; y < st->page.ul.y + st->page.size.h; y++) {
+    p = st->buf + ((uint16_t) (y - st->y) * st->width + st->page.ul.x) * 2;
+    n = st->page.size.w;
+    while ( n > 0 ) {
+      k = ( n > UCG_BMP_STREAM_PIXELS ) ? UCG_BMP_STREAM_PIXELS : n;
+      for (i = 0; i < k; i++, p += 2) {
+        _ucg_strip_color(p, rgb + i*3);
+      }
+      px.cnt = k;
+      st->chain_device_cb(ucg, UCG_MSG_WRITE_PIXELS, &px);
+      n -= k;
+    }
+  }
+  st->chain_device_cb(ucg, UCG_MSG_END_WINDOW, NULL);
+}
+
+/*  brief   Device callback of the strip buffer
+ *
+ *          Between ucg_FirstPage() and ucg_NextPage() all drawing messages draw
+ *          into the strip buffer, the clipping to the strip is done with the
+ *          clip functions of ucglib (ucg_clip.c).
+ *
+ *  param   ucg     pointer to struct for the display
+ *  param   msg     the message
+ *  param   data    the data of the message
+ *
+ *  return  the result of the message
+ */
+static ucg_int_t ucg_dev_strip(ucg_t *ucg, ucg_int_t msg, void *data)
+{
+  ucg_strip_t  *st = ucg->strip;
+  ucg_pixels_t *px;
+  ucg_box_t     clip_box;
+  ucg_int_t     x, y;
+  uint16_t      k;
+
+  if ( msg == UCG_MSG_SET_CLIP_BOX ) {
+    st->clip = *(ucg_box_t *)data;               // in the coordinates of the strip
+    return st->chain_device_cb(ucg, msg, data);
+  }
+  if ( st->y < 0 ) {
+    return st->chain_device_cb(ucg, msg, data);  // not in a page: draw to the display
+  }
+
+  switch(msg) {
+    case UCG_MSG_DRAW_PIXEL:
+      _ucg_strip_pixel(st, ucg->arg.pixel.pos.x, ucg->arg.pixel.pos.y, ucg->arg.pixel.rgb.color);
+      return 1;
+
+    case UCG_MSG_DRAW_L90FX:
+      if ( (ucg->arg.dir & 1) == 0 ) {
+        // horizontal line: clipped to the visible part and written as one span
+        clip_box = ucg->clip_box;
+        ucg->clip_box = st->page;
+        if ( ucg_clip_l90fx(ucg) != 0 ) {
+          x = ucg->arg.pixel.pos.x;
+          if ( ucg->arg.dir == 2 ) x -= ucg->arg.len - 1;
+          _ucg_strip_span(st, x, ucg->arg.pixel.pos.y, ucg->arg.len, ucg->arg.pixel.rgb.color);
+        }
+        ucg->clip_box = clip_box;
+        return 1;
+      }
+      /* fall through */
+    case UCG_MSG_DRAW_L90SE:
+#ifdef UCG_MSG_DRAW_L90TC
+    case UCG_MSG_DRAW_L90TC:
+#endif /* UCG_MSG_DRAW_L90TC */
+#ifdef UCG_MSG_DRAW_L90BF
+    case UCG_MSG_DRAW_L90BF:
+#endif /* UCG_MSG_DRAW_L90BF */
+      // the line is clipped to the visible part of the strip and drawn pixel by pixel
+      clip_box = ucg->clip_box;
+      ucg->clip_box = st->page;
+      switch(msg) {
+        case UCG_MSG_DRAW_L90FX: ucg_handle_l90fx(ucg, ucg_dev_strip); break;
+#ifdef UCG_MSG_DRAW_L90TC
+        case UCG_MSG_DRAW_L90TC: ucg_handle_l90tc(ucg, ucg_dev_strip); break;
+#endif /* UCG_MSG_DRAW_L90TC */
+#ifdef UCG_MSG_DRAW_L90BF
+        case UCG_MSG_DRAW_L90BF: ucg_handle_l90bf(ucg, ucg_dev_strip); break;
+#endif /* UCG_MSG_DRAW_L90BF */
+        default:                 ucg_handle_l90se(ucg, ucg_dev_strip); break;
+      }
+      ucg->clip_box = clip_box;
+      return 1;
+
+    case UCG_MSG_SET_WINDOW:
+      st->window = *(ucg_window_t *)data;        // every window and scan order
+      st->wc = 0;
+      st->wr = 0;
+      return 1;
+
+    case UCG_MSG_WRITE_PIXELS:
+      px = (ucg_pixels_t *)data;
+      for (k = 0; k < px->cnt; k++) {
+        x = ( st->window.scan & UCG_WINDOW_MIRROR_X ) ? st->window.box.size.w - 1 - st->wc : st->wc;
+        y = ( st->window.scan & UCG_WINDOW_MIRROR_Y ) ? st->window.box.size.h - 1 - st->wr : st->wr;
+        _ucg_strip_pixel(st, st->window.box.ul.x + x, st->window.box.ul.y + y,
+                         px->repeat ? px->rgb : px->rgb + k*3);
+        if ( ++st->wc == st->window.box.size.w ) {
+          st->wc = 0;
+          st->wr++;
+        }
+      }
+      return 1;
+
+    case UCG_MSG_END_WINDOW:
+      return 1;
+  }
+  return st->chain_device_cb(ucg, msg, data);
+}
+
+/*! \brief  Draws with a strip buffer (page mode)
+ *
+ *          The picture is drawn in a loop with ucg_FirstPage() and ucg_NextPage().
+ *          The width of the buffer is the width of the display, see
+ *          UCG_STRIP_BUF_SIZE().
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  st       pointer to struct for the strip
+ *  \param  buf      the buffer, UCG_STRIP_BUF_SIZE(width of the display, lines) bytes
+ *  \param  lines    the number of lines of a strip
+ *
+ *  \return void
+ */
+void ucg_SetStrip(ucg_t *ucg, ucg_strip_t *st, uint8_t *buf, uint8_t lines)
+{
+  ucg_UndoStrip(ucg);
+  st->buf   = buf;
+  st->lines = lines;
+  st->width = ucg->dimension.w;
+  st->height = ucg->dimension.h;
+  st->y     = -1;
+  st->alpha = 255;
+  st->chain_device_cb = ucg->device_cb;
+  ucg->strip = st;
+  ucg->device_cb = ucg_dev_strip;
+  ucg_SetMaxClipRange(ucg);
+}
+
+/*! \brief  Draws directly to the display again
+ *
+ *  \param  ucg      pointer to struct for the display
+ *
+ *  \return void
+ */
+void ucg_UndoStrip(ucg_t *ucg)
+{
+  if ( ucg->strip != NULL )
+  {
+    ucg->device_cb = ucg->strip->chain_device_cb;
+    ucg->strip = NULL;
+  }
+}
+
+/*! \brief  Sets the alpha of the following drawing functions
+ *
+ *          Between ucg_FirstPage() and ucg_NextPage() the pixels are blended with
+ *          the pixels in the strip buffer. Without a strip buffer the alpha is
+ *          ignored.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  alpha    0 (transparent) ... 255 (opaque)
+ *
+ *  \return void
+ */
+void ucg_SetAlpha(ucg_t *ucg, uint8_t alpha)
+{
+  if ( ucg->strip != NULL ) ucg->strip->alpha = alpha;
+}
+
+/*! \brief  Starts drawing the first strip
+ *
+ *          The first strip is the first strip in the clip box. The buffer is
+ *          cleared (black).
+ *
+ *  \param  ucg      pointer to struct for the display
+ *
+ *  \return void
+ */
+void ucg_FirstPage(ucg_t *ucg)
+{
+  ucg_strip_t *st = ucg->strip;
+
+  if ( st == NULL ) return;
+
+  st->y = st->clip.ul.y - (st->clip.ul.y % st->lines);
+  if ( st->y < 0 ) st->y = 0;
+  _ucg_strip_page(ucg);
+}
+
+/*! \brief  Sends the strip and starts drawing the next strip
+ *
+ *  \param  ucg      pointer to struct for the display
+ *
+ *  \return 0 if all strips are drawn
+ */
+uint8_t ucg_NextPage(ucg_t *ucg)
+{
+  ucg_strip_t *st = ucg->strip;
+
+  if ( (st == NULL) || (st->y < 0) ) return 0;
+
+  _ucg_strip_send(ucg);
+
+  st->y += st->lines;
+  if ( (st->y >= st->height) || (st->y >= st->clip.ul.y + st->clip.size.h) ) {
+    st->y = -1;
+    return 0;
+  }
+  _ucg_strip_page(ucg);
+  return 1;
+}
@@ -0,0 +1,426 @@
+/*!
+ *  \file    ucg_tile.c
+ *  \date    19-10-2026
+ *  \version 1.0
+ *
+ *  \brief   Tile maps and sprites for ucglib from Oli Kraus
+ *
+ *  \details This is an addition to the
+ *           <a href="https://github.com/olikraus/ucglib/">c-implementation</a> of Oli Kraus.
+ *
+ *           A dashboard is a grid of tiles: every tile shows an icon on a status
+ *           color. Drawing every tile with ucg_DrawRBox() and a bitmap on every
+ *           refresh sends the complete screen. A tile map keeps the index of the icon
+ *           and the attribute (status color) of every tile in RAM and remembers which
+ *           tiles are changed. ucg_DrawTileMap() draws only the changed tiles.
+ *           The changed tiles are drawn from top to bottom, adjacent changed tiles
+ *           of a row of the map are drawn in one window.
+ *
+ *           The icons are stored in a tile sheet: an indexed-color bitmap (see
+ *           ucg_ibmp.c) with all tiles below each other, generated by
+ *           tools/ucg_ibmp.py. The sheet must have 1, 2 or 4 bits per pixel and at
+ *           most UCG_TILE_MAX_WIDTH pixels per row. The transparent pixels of a tile
+ *           show the color of the attribute of the tile.
+ *
+ *           A sprite is a tile of the sheet at any position on the map, e.g. a cursor
+ *           or a marker. The transparent pixels of a sprite show the tile below. If
+ *           a sprite is moved, the tiles below the old and the new position are drawn
+ *           again.
+ *
+ *           With tiles of 32x32 pixels on the ST7735 (18-bit) a changed status of
+ *           one room is 3 kB on the SPI bus instead of 61 kB for the screen.
+ *           The text of a tile (e.g. a temperature) is drawn after ucg_DrawTileMap()
+ *           with a text field (ucg_UpdateTextField()), which draws only the changed
+ *           glyphs.
+ */
+
+#include <string.h>
+#include "ucg.h"
+
+#define UCG_TILE_HEADER_SIZE   8      //!< size of the header of the tile sheet (indexed-color bitmap)
+#define UCG_TILE_TRANSPARENT   0x01   //!< flag: the tile sheet has a transparent index
+
+static void _ucg_tile_dirty(ucg_tilemap_t *tm, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h);
+static uint8_t _ucg_tile_index(ucg_tilemap_t *tm, uint8_t tile, ucg_int_t c, ucg_int_t r);
+static void _ucg_tile_row(ucg_t *ucg, ucg_tilemap_t *tm, ucg_bmp_stream_t *s,
+                          uint8_t col, uint8_t row, ucg_int_t y);
+static uint8_t _ucg_tile_last_page(ucg_t *ucg);
+static void _ucg_tile_frame_box(ucg_t *ucg, ucg_box_t *box);
+
+/*  brief   Checks if the drawn tiles are complete: directly on the display or
+ *          in the last strip of a strip buffer (see ucg_NextPage())
+ *
+ *  param   ucg     pointer to struct for the display
+ *
+ *  return  1 if it is not a page loop of a strip buffer or it is the last strip
+ */
+static uint8_t _ucg_tile_last_page(ucg_t *ucg)
+{
+  ucg_strip_t *st = ucg->strip;
+
+  if ( (st == NULL) || (st->y < 0) ) return 1;
+
+  return (st->y + st->lines >= st->height) || (st->y + st->lines >= st->clip.ul.y + st->clip.size.h);
+}
+
+/*  brief   Gets the clip box of the whole picture: in a page loop the bitmap
+ *          stream is clipped to the current strip, a tile is complete if it is
+ *          in the clip box of all strips
+ *
+ *  param   ucg     pointer to struct for the display
+ *  param   box     the clip box, in the coordinates of ucg_OpenBmpStream()
+ *
+ *  return  void
+ */
+static void _ucg_tile_frame_box(ucg_t *ucg, ucg_box_t *box)
+{
+  ucg_strip_t *st = ucg->strip;
+  ucg_int_t  y;
+
+  if ( st == NULL ) {
+    ucg_GetRotatedClipBox(ucg, box);
+    return;
+  }
+  y = st->y;
+  st->y = -1;                                    // as outside of the page loop: not limited to the strip
+  ucg_GetRotatedClipBox(ucg, box);
+  st->y = y;
+}
+
+/*  brief   Marks the tiles below a rectangle of the map as changed
+ *
+ *  param   tm      pointer to struct for the tile map
+ *  param   x       the x-position of the rectangle (relative to the map)
+ *  param   y       the y-position of the rectangle (relative to the map)
+ *  param   w       the width of the rectangle
+ *  param   h       the height of the rectangle
+ *
+ *  return  void
+ */
+static void _ucg_tile_dirty(ucg_tilemap_t *tm, ucg_int_t x, ucg_int_t y, ucg_int_t w, ucg_int_t h)
+{
+  ucg_int_t  c0, c1, r0, r1, c;
+
+  if ( (x + w <= 0) || (y + h <= 0) ) return;
+
+  c0 = ( x < 0 ) ? 0 : x / tm->tw;
+  r0 = ( y < 0 ) ? 0 : y / tm->th;
+  c1 = (x + w - 1) / tm->tw;
+  r1 = (y + h - 1) / tm->th;
+  if ( c1 >= tm->cols ) c1 = tm->cols - 1;
+  if ( r1 >= tm->rows ) r1 = tm->rows - 1;
+
+  for ( ; r0 <= r1; r0++) {
+    for (c = c0; c <= c1; c++) {
+      tm->map[r0 * tm->cols + c].dirty = 1;
+    }
+  }
+}
+
+/*  brief   Reads the index of a pixel of a tile of the sheet
+ *
+ *  param   tm      pointer to struct for the tile map
+ *  param   tile    the index of the tile in the sheet
+ *  param   c       the column of the pixel in the tile
+ *  param   r       the row of the pixel in the tile
+ *
+ *  return  the index of the color
+ */
+static uint8_t _ucg_tile_index(ucg_tilemap_t *tm, uint8_t tile, ucg_int_t c, ucg_int_t r)
+{
+  const __memx uint8_t *p;
+  uint16_t  bit = (uint16_t) c * tm->bpp;
+
+  p = tm->pixels + ((uint16_t) tile * tm->th + r) * tm->stride;
+  return (p[bit >> 3] >> (8 - tm->bpp - (bit & 7))) & ((1 << tm->bpp) - 1);
+}
+
+/*  brief   Writes one pixel row of a tile with the sprites above it to a stream,
+ *          pixels with the same color are written as one run
+ *
+ *  param   ucg     pointer to struct for the display
+ *  param   tm      pointer to struct for the tile map
+ *  param   s       pointer to struct for the stream
+ *  param   col     the column of the tile in the map
+ *  param   row     the row of the tile in the map
+ *  param   y       the pixel row in the tile
+ *
+ *  return  void
+ */
+static void _ucg_tile_row(ucg_t *ucg, ucg_tilemap_t *tm, ucg_bmp_stream_t *s,
+                          uint8_t col, uint8_t row, ucg_int_t y)
+{
+  ucg_tile_t   *t = &tm->map[row * tm->cols + col];
+  ucg_sprite_t *sp;
+  uint8_t  *rgb, *prev = NULL;
+  uint8_t   sprites = 0;                         // bit i: sprite i is in this pixel row
+  uint8_t   i, idx;
+  uint16_t  n = 0;
+  ucg_int_t mx = (ucg_int_t) col * tm->tw;       // position in the map
+  ucg_int_t my = (ucg_int_t) row * tm->th + y;
+  ucg_int_t x;
+
+  for (i = 0; i < UCG_TILE_SPRITES; i++) {
+    sp = &tm->sprite[i];
+    if ( (sp->index < tm->count) && (my >= sp->y) && (my < sp->y + tm->th) &&
+         (mx + tm->tw > sp->x) && (mx < sp->x + tm->tw) ) {
+      sprites |= 1 << i;
+    }
+  }
+
+  for (x = 0; x < tm->tw; x++) {
+    // the tile
+    rgb = tm->colors[t->attr];
+    if ( t->index < tm->count ) {
+      idx = _ucg_tile_index(tm, t->index, x, y);
+      if ( !tm->transparent || (idx != tm->tindex) ) rgb = tm->lut[idx];
+    }
+    // the sprites, the last one is on top
+    for (i = 0; i < UCG_TILE_SPRITES; i++) {
+      sp = &tm->sprite[i];
+      if ( (sprites & (1 << i)) && (mx + x >= sp->x) && (mx + x < sp->x + tm->tw) ) {
+        idx = _ucg_tile_index(tm, sp->index, mx + x - sp->x, my - sp->y);
+        if ( !tm->transparent || (idx != tm->tindex) ) rgb = tm->lut[idx];
+      }
+    }
+
+    if ( (rgb != prev) && (n > 0) ) {
+      ucg_WriteBmpPixels(ucg, s, n, prev);
+      n = 0;
+    }
+    prev = rgb;
+    n++;
+  }
+  ucg_WriteBmpPixels(ucg, s, n, prev);
+}
+
+/*! \brief  Initializes a tile map
+ *
+ *          All tiles get index UCG_TILE_NONE (only the color of the attribute) and
+ *          attribute 0, all colors are black and all sprites are hidden. All tiles
+ *          are changed, so the first ucg_DrawTileMap() draws the complete map.
+ *
+ *  \param  tm       pointer to struct for the tile map
+ *  \param  x        the x-position of the upper left corner of the map
+ *  \param  y        the y-position of the upper left corner of the map
+ *  \param  cols     the number of tiles in a row
+ *  \param  rows     the number of rows
+ *  \param  map      array with cols*rows tiles (in RAM)
+ *  \param  sheet    the tile sheet, an indexed-color bitmap with the tiles
+ *                   below each other (generated by tools/ucg_ibmp.py)
+ *  \param  th       the height of a tile in pixels, the width of a tile is
+ *                   the width of the sheet
+ *
+ *  \return 0 if the sheet has more than 4 bits per pixel or is wider than
+ *          UCG_TILE_MAX_WIDTH
+ */
+uint8_t ucg_InitTileMap(ucg_tilemap_t *tm, ucg_int_t x, ucg_int_t y, uint8_t cols, uint8_t rows,
+                        ucg_tile_t *map, const __memx uint8_t *sheet, ucg_int_t th)
+{
+  const __memx uint8_t *palette;
+  uint8_t  ncolors, i;
+  uint16_t k;
+
+  memset(tm, 0, sizeof(ucg_tilemap_t));
+  tm->x    = x;
+  tm->y    = y;
+  tm->cols = cols;
+  tm->rows = rows;
+  tm->map  = map;
+  tm->tw   = ((ucg_int_t) sheet[0] << 8) | sheet[1];
+  tm->th   = th;
+  tm->count       = (((ucg_int_t) sheet[2] << 8) | sheet[3]) / th;
+  tm->bpp         = sheet[4];
+  tm->transparent = sheet[5] & UCG_TILE_TRANSPARENT;
+  tm->tindex      = sheet[6];
+  ncolors         = sheet[7];                  // number of colors - 1
+  palette    = sheet + UCG_TILE_HEADER_SIZE;
+  tm->pixels = palette + 3 * ((uint16_t) ncolors + 1);
+  tm->stride = ((uint16_t) tm->tw * tm->bpp + 7) >> 3;
+
+  for (i = 0; (i <= ncolors) && (i < 16); i++) {
+    tm->lut[i][0] = palette[3*i];
+    tm->lut[i][1] = palette[3*i+1];
+    tm->lut[i][2] = palette[3*i+2];
+  }
+  for (i = 0; i < UCG_TILE_SPRITES; i++) {
+    tm->sprite[i].index = UCG_TILE_NONE;
+  }
+  for (k = 0; k < (uint16_t) cols * rows; k++) {
+    map[k].index = UCG_TILE_NONE;
+    map[k].attr  = 0;
+    map[k].dirty = 1;
+  }
+
+  return (tm->bpp <= 4) && (tm->tw <= UCG_TILE_MAX_WIDTH);
+}
+
+/*! \brief  Sets the icon and the attribute of a tile
+ *
+ *          The tile is only drawn again if the index or the attribute is changed.
+ *
+ *  \param  tm       pointer to struct for the tile map
+ *  \param  col      the column of the tile
+ *  \param  row      the row of the tile
+ *  \param  index    the index of the tile in the sheet, UCG_TILE_NONE for no icon
+ *  \param  attr     the attribute (0 ... UCG_TILE_COLORS-1), the color of the
+ *                   transparent pixels
+ *
+ *  \return void
+ */
+void ucg_SetTile(ucg_tilemap_t *tm, uint8_t col, uint8_t row, uint8_t index, uint8_t attr)
+{
+  ucg_tile_t *t;
+
+  if ( (col >= tm->cols) || (row >= tm->rows) || (attr >= UCG_TILE_COLORS) ) return;
+
+  t = &tm->map[row * tm->cols + col];
+  if ( (t->index != index) || (t->attr != attr) ) {
+    t->index = index;
+    t->attr  = attr;
+    t->dirty = 1;
+  }
+}
+
+/*! \brief  Sets the color of an attribute
+ *
+ *          All tiles with this attribute are drawn again if the color is changed.
+ *
+ *  \param  tm       pointer to struct for the tile map
+ *  \param  attr     the attribute (0 ... UCG_TILE_COLORS-1)
+ *  \param  r        the red component
+ *  \param  g        the green component
+ *  \param  b        the blue component
+ *
+ *  \return void
+ */
+void ucg_SetTileColor(ucg_tilemap_t *tm, uint8_t attr, uint8_t r, uint8_t g, uint8_t b)
+{
+  uint8_t  *color;
+  uint16_t k;
+
+  if ( attr >= UCG_TILE_COLORS ) return;
+
+  color = tm->colors[attr];
+  if ( (color[0] == r) && (color[1] == g) && (color[2] == b) ) return;
+  color[0] = r;
+  color[1] = g;
+  color[2] = b;
+
+  for (k = 0; k < (uint16_t) tm->cols * tm->rows; k++) {
+    if ( tm->map[k].attr == attr ) tm->map[k].dirty = 1;
+  }
+}
+
+/*! \brief  Shows, moves or hides a sprite
+ *
+ *          The tiles below the old and the new position are drawn again.
+ *
+ *  \param  tm       pointer to struct for the tile map
+ *  \param  n        the number of the sprite (0 ... UCG_TILE_SPRITES-1),
+ *                   a sprite with a higher number is above a lower one
+ *  \param  x        the x-position of the sprite (relative to the map)
+ *  \param  y        the y-position of the sprite (relative to the map)
+ *  \param  index    the index of the tile in the sheet, UCG_TILE_NONE hides
+ *                   the sprite
+ *
+ *  \return void
+ */
+void ucg_SetSprite(ucg_tilemap_t *tm, uint8_t n, ucg_int_t x, ucg_int_t y, uint8_t index)
+{
+  ucg_sprite_t *sp;
+
+  if ( n >= UCG_TILE_SPRITES ) return;
+
+  sp = &tm->sprite[n];
+  if ( (sp->x == x) && (sp->y == y) && (sp->index == index) ) return;
+
+  if ( sp->index < tm->count ) _ucg_tile_dirty(tm, sp->x, sp->y, tm->tw, tm->th);
+  sp->x     = x;
+  sp->y     = y;
+  sp->index = index;
+  if ( sp->index < tm->count ) _ucg_tile_dirty(tm, sp->x, sp->y, tm->tw, tm->th);
+}
+
+/*! \brief  Marks all tiles as changed, e.g. after the screen is cleared
+ *
+ *  \param  tm       pointer to struct for the tile map
+ *
+ *  \return void
+ */
+void ucg_InvalidateTileMap(ucg_tilemap_t *tm)
+{
+  uint16_t k;
+
+  for (k = 0; k < (uint16_t) tm->cols * tm->rows; k++) {
+    tm->map[k].dirty = 1;
+  }
+}
+
+/*! \brief  Draws the changed tiles of a tile map
+ *
+ *          The rows of the map are drawn from top to bottom. Adjacent changed tiles
+ *          of a row are drawn in one window, the pixels are sent from left to right
+ *          and from top to bottom. The map is clipped to the clip box.
+ *
+ *          A tile is unchanged after it is drawn completely: the whole tile is in the
+ *          clip box. A tile that is partly outside the clip box stays changed, e.g.
+ *          with ucg_FlushDirty() it is drawn again in the next dirty rectangle.
+ *          In a page loop of a strip buffer (ucg_FirstPage() ... ucg_NextPage())
+ *          every strip draws the same changed tiles and the tiles are unchanged
+ *          after the last strip.
+ *
+ *  \param  ucg      pointer to struct for the display
+ *  \param  tm       pointer to struct for the tile map
+ *
+ *  \return the number of tiles that are drawn completely, in a page loop the
+ *          tiles are counted in the last strip
+ */
+uint16_t ucg_DrawTileMap(ucg_t *ucg, ucg_tilemap_t *tm)
+{
+  ucg_bmp_stream_t  s;
+  ucg_box_t  frame;
+  ucg_tile_t *t;
+  uint16_t   drawn = 0;
+  uint8_t    row, col, end, c, is_last;
+  ucg_int_t  y, tx, ty;
+
+  is_last = _ucg_tile_last_page(ucg);
+  _ucg_tile_frame_box(ucg, &frame);
+
+  for (row = 0; row < tm->rows; row++) {
+    t = &tm->map[row * tm->cols];
+    col = 0;
+    while ( col < tm->cols ) {
+      if ( !t[col].dirty ) {
+        col++;
+        continue;
+      }
+      for (end = col + 1; (end < tm->cols) && t[end].dirty; end++)
+        ;
+
+      tx = tm->x + (ucg_int_t) col * tm->tw;
+      ty = tm->y + (ucg_int_t) row * tm->th;
+      if ( ucg_OpenBmpStream(ucg, &s, tx, ty, 0, (ucg_int_t) (end - col) * tm->tw, tm->th) ) {
+        for (y = 0; y < tm->th && s.r < s.r1; y++) {
+          for (c = col; c < end; c++) {
+            _ucg_tile_row(ucg, tm, &s, c, row, y);
+          }
+        }
+        ucg_CloseBmpStream(ucg, &s);
+      }
+
+      // a tile in the clip box of the picture is complete after the last strip
+      for (c = col; c < end; c++, tx += tm->tw) {
+        if ( is_last && (tx >= frame.ul.x) && (tx + tm->tw <= frame.ul.x + frame.size.w) &&
+             (ty >= frame.ul.y) && (ty + tm->th <= frame.ul.y + frame.size.h) ) {
+          drawn++;
+          t[c].dirty = 0;
+        }
+      }
+      col = end;
+    }
+  }
+
+  return drawn;
+}